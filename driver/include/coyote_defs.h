@@ -393,6 +393,10 @@ extern bool en_hmm;
 #define MMAP_CNFG_AVX 0x2
 #define MMAP_CTRL 0x3
 #define MMAP_RECONFIG 0x100
+#define MMAP_NOTIFY 0x200
+
+// Number of entries in a user notification ring; must be a power of two and fit, with the ring header, in a single page
+#define NOTIFY_RING_SIZE 512
 
 // vFPGA IOCTL calls; see vfpga_ops.c for more details
 #define IOCTL_REGISTER_CTID _IOW('F', 1, unsigned long) 
@@ -414,6 +418,10 @@ extern bool en_hmm;
 #define IOCTL_SHELL_NET_STATS _IOR('F', 17, unsigned long)
 #define IOCTL_SET_NOTIFICATION_PROCESSED _IOR('F', 18, unsigned long)
 #define IOCTL_GET_NOTIFICATION_VALUE _IOR('F', 19, unsigned long)
+#define IOCTL_REGISTER_NOTIFY_RING _IOW('F', 20, unsigned long)
+#define IOCTL_UNREGISTER_NOTIFY_RING _IOW('F', 21, unsigned long)
+#define IOCTL_MAP_USER_MEM_BATCH _IOW('F', 22, unsigned long)
+#define IOCTL_UNMAP_USER_MEM_BATCH _IOW('F', 23, unsigned long)
 
 // Reconfiguration IOCTL calls; see reconfig_ops.c for more details
 #define IOCTL_ALLOC_HOST_RECONFIG_MEM _IOW('P', 1, unsigned long)
@@ -444,6 +452,9 @@ extern bool en_hmm;
 // Maximum number of user arguments for IOCTL calls passed from the user space
 #define MAX_USER_ARGS 32
 
+// Maximum number of buffers in a single IOCTL_MAP_USER_MEM_BATCH/IOCTL_UNMAP_USER_MEM_BATCH call
+#define MAX_MAP_BATCH 256
+
 // Atomic flags (rather self-explanatory)
 #define FLAG_SET 1
 #define FLAG_CLR 0
@@ -850,6 +861,9 @@ extern struct mutex user_notifier_lock[MAX_N_REGIONS][N_CTID_MAX];
 /// Interrupt values used to pass values between vpfga_isr and vpfga_ops
 extern int32_t interrupt_value[MAX_N_REGIONS][N_CTID_MAX];
 
+/// Notification rings, memory mapped to the user-space; one per vFPGA and Coyote thread ID, if registered; see vfpga_uisr.c for more details
+extern struct vfpga_notify_ring *user_notify_ring[MAX_N_REGIONS][N_CTID_MAX];
+
 #ifdef HMM_KERNEL
 extern struct list_head migrated_pages[MAX_N_REGIONS][N_CTID_MAX];
 #endif
@@ -940,6 +954,33 @@ struct vfpga_irq_notify {
     struct work_struct work_notify;
 };
 
+/**
+ * @brief User notification ring
+ * A single-producer, single-consumer queue of notification values, shared with the user-space (see sw/src/cThread.cpp)
+ * The driver appends values at the tail, the user-space consumes them from the head; both indices are free-running 
+ * The indices are placed on separate cache lines, since each of them is written by one side only
+ */
+struct vfpga_notify_ring {
+    /// Index of the next value to be written; written by the driver
+    uint32_t tail;
+
+    /// Number of notifications dropped because the ring was full; written by the driver
+    uint32_t dropped;
+
+    uint32_t rsrvd_0[14];
+
+    /// Index of the next value to be read; written by the user-space
+    uint32_t head;
+
+    /// Set by the user-space before blocking on the eventfd; the driver only signals the eventfd if set
+    uint32_t waiting;
+
+    uint32_t rsrvd_1[14];
+
+    /// Notification values
+    int32_t values[NOTIFY_RING_SIZE];
+};
+
 /**
  * @brief Virtual FPGA (vFPGA) char device structure
  *
@@ -33,6 +33,10 @@
  * In Coyote, an eventfd is created from the user-space and registered by the driver using the method vfpga_register_eventfd
  * Then, when an interrupt from the FPGA is picked up by the driver (see vfpga_isr.c), the driver writes to the appropariate eventfd
  * The user-space software polls on the same eventfd, and, when a change is detected, executes the appropriate callback (see sw/bThread.cpp)
+ *
+ * Alternatively, a Coyote thread can register a notification ring, which is mapped to the user-space
+ * In that case, notification values are appended to the ring and consumed by the user-space without any syscalls
+ * The eventfd is then only signalled when the user-space is blocked waiting for a notification
  */
 
 #ifndef _VFPGA_UISR_H_
@@ -58,4 +62,47 @@ int vfpga_register_eventfd(struct vfpga_dev *device, int ctid, int eventfd);
  */
 void vfpga_unregister_eventfd(struct vfpga_dev *device, int ctid);
 
+/**
+ * @brief Registers a notification ring for a given Coyote thread and vFPGA device
+ *
+ * Once registered, user interrupts (notifications) for this Coyote thread are appended to the ring, 
+ * which the user-space maps (MMAP_NOTIFY + ctid) and consumes without any ioctl calls
+ * Therefore, notifications are queued, rather than processed one at a time under user_notifier_lock
+ *
+ * @param device vfpga_dev for which the ring should be registered
+ * @param ctid Coyote thread ID (obtained from user-space)
+ * @return whether the ring was successfully allocated
+ */
+int vfpga_register_notify_ring(struct vfpga_dev *device, int ctid);
+
+/**
+ * @brief Unregisters the notification ring for a given Coyote thread and vFPGA device, if any
+ *
+ * @param device vfpga_dev for which the ring should be released
+ * @param ctid Coyote thread ID of the ring which should be released
+ */
+void vfpga_unregister_notify_ring(struct vfpga_dev *device, int ctid);
+
+/**
+ * @brief Maps the notification ring of a Coyote thread to the user-space
+ *
+ * @param device vfpga_dev holding the ring
+ * @param ctid Coyote thread ID of the ring
+ * @param vma virtual memory area to map the ring to
+ * @return 0 on success; negative error otherwise 
+ */
+int vfpga_mmap_notify_ring(struct vfpga_dev *device, int ctid, struct vm_area_struct *vma);
+
+/**
+ * @brief Appends a notification value to the ring of a Coyote thread
+ *
+ * If the user-space is blocked waiting for notifications, the registered eventfd is signalled as well
+ *
+ * @param device vfpga_dev which issued the notification
+ * @param ctid Coyote thread ID the notification is for
+ * @param value notification value
+ * @return true, if the Coyote thread has a notification ring (even if the value was dropped because the ring was full)
+ */
+bool vfpga_notify_ring_push(struct vfpga_dev *device, int ctid, int32_t value);
+
 #endif // _VFPGA_UISR_H_
\ No newline at end of file
@@ -253,6 +253,7 @@ static struct kobj_attribute kobj_attr_prstats = __ATTR_RO(cyt_attr_prstats);
 static struct kobj_attribute kobj_attr_engines = __ATTR_RO(cyt_attr_engines);
 #endif
 static struct kobj_attribute kobj_attr_cnfg = __ATTR_RO(cyt_attr_cnfg);
+static struct kobj_attribute kobj_attr_numa = __ATTR_RO(cyt_attr_numa);
 static struct kobj_attribute kobj_attr_eost = __ATTR(cyt_attr_eost, 0664, cyt_attr_eost_show, cyt_attr_eost_store);
 #ifdef PLATFORM_VERSAL
 static struct kobj_attribute kobj_attr_qdma_debug_regs = __ATTR_RO(cyt_attr_qdma_debug_regs);
@@ -268,6 +269,7 @@ static struct attribute *attrs[] = {
     &kobj_attr_engines.attr,
     #endif
     &kobj_attr_cnfg.attr,
+    &kobj_attr_numa.attr,
     &kobj_attr_eost.attr,
     #ifdef PLATFORM_VERSAL
     &kobj_attr_qdma_debug_regs.attr,
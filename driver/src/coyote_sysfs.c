@@ -283,6 +283,16 @@ ssize_t cyt_attr_cnfg_show(struct kobject *kobj, struct kobj_attribute *attr, ch
     );
 }
 
+ssize_t cyt_attr_numa_show(struct kobject *kobj, struct kobj_attribute *attr, char *buff) {   
+    struct bus_driver_data *bus_data = container_of(kobj, struct bus_driver_data, cyt_kobj);
+    BUG_ON(!bus_data); 
+
+    // Plain number, so that it can be parsed by the user-space library; -1 if the node is unknown
+    int node = bus_data->pci_dev ? dev_to_node(&bus_data->pci_dev->dev) : NUMA_NO_NODE;
+    dbg_info("coyote-sysfs:  device NUMA node: %d\n", node);
+    return sprintf(buff, "%d\n", node);
+}
+
 #ifdef PLATFORM_VERSAL
 ssize_t cyt_attr_qdma_debug_regs_show(struct kobject *kobj, struct kobj_attribute *attr, char *buff) {   
     struct bus_driver_data *bus_data = container_of(kobj, struct bus_driver_data, cyt_kobj);
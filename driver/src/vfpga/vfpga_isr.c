@@ -106,6 +106,13 @@ void vfpga_notify_handler(struct work_struct *work) {
     BUG_ON(!irq_not);
     struct vfpga_dev *device = irq_not->device;
     BUG_ON(!device);
+
+    // If the Coyote thread registered a notification ring, queue the value; no need to wait for the user-space to process previous notifications
+    if (vfpga_notify_ring_push(device, irq_not->ctid, irq_not->notification_value)) {
+        dbg_info("notify vFPGA %d, notification value %d, ctid %d queued\n", device->id, irq_not->notification_value, irq_not->ctid);
+        kfree(irq_not);
+        return;
+    }
     
     // Mutex, preventing multiple simultaneous user interrupts (notifications)
     // Typically, the hardware can issue interrupts faster than the software can process them; therefore a mutex (to prevent some interrupts being dropped)
@@ -252,6 +252,9 @@ long vfpga_dev_ioctl(struct file *file, unsigned int command, unsigned long arg)
                     }
                 }
 
+                // Release the notification ring, in case the process didn't (e.g. it crashed)
+                vfpga_unregister_notify_ring(device, ctid);
+
                 dbg_info("unregistration succeeded, ctid %d, hpid %d, spid %d\n", ctid, hpid, spid);
                 mutex_unlock(&device->pid_lock);
                 
@@ -338,6 +341,122 @@ long vfpga_dev_ioctl(struct file *file, unsigned int command, unsigned long arg)
             }
             break;
 
+        // Explicit mapping of a batch of user buffers; same as IOCTL_MAP_USER_MEM for every buffer, but the MMU and TLB locks are only taken once
+        // Args: Pointer to an array of buffers, number of buffers (at most MAX_MAP_BATCH), Coyote thread ID (ctid)
+        // Each buffer is described by four values: virtual address, length, target memory block and the return code, written back by the driver
+        case IOCTL_MAP_USER_MEM_BATCH:
+            ret_val = copy_from_user(&tmp, (unsigned long *) arg, 3 * sizeof(unsigned long));
+            if (ret_val != 0) {
+                pr_warn("user data could not be coppied, return %d\n", ret_val);
+            } else {
+                int32_t ctid = (int32_t) tmp[2];
+                uint64_t n_buffs = tmp[1];
+                uint64_t *buffs;
+                int i;
+
+                if (ctid < 0 || ctid >= N_CTID_MAX || n_buffs == 0 || n_buffs > MAX_MAP_BATCH) {
+                    pr_warn("invalid batch of %llu buffers for ctid %d\n", n_buffs, ctid);
+                    ret_val = -EINVAL;
+                    break;
+                }
+
+                buffs = kmalloc_array(n_buffs, 4 * sizeof(uint64_t), GFP_KERNEL);
+                if (!buffs) {
+                    ret_val = -ENOMEM;
+                    break;
+                }
+
+                ret_val = copy_from_user(buffs, (uint64_t *) tmp[0], n_buffs * 4 * sizeof(uint64_t));
+                if (ret_val != 0) {
+                    pr_warn("user data could not be coppied, return %d\n", ret_val);
+                    kfree(buffs);
+                    break;
+                }
+
+                pid_t hpid = device->pid_array[ctid];
+
+                mutex_lock(&device->mmu_lock);
+                change_tlb_lock(device);
+
+                for (i = 0; i < n_buffs; i++) {
+                    int buff_ret;
+
+                    #ifdef HMM_KERNEL
+                        if(en_hmm) 
+                            buff_ret = mmu_handler_hmm(device, buffs[4 * i], buffs[4 * i + 1], ctid, true, hpid);
+                        else
+                    #endif
+                        buff_ret = mmu_handler_gup(device, buffs[4 * i], buffs[4 * i + 1], ctid, true, hpid, (int32_t) buffs[4 * i + 2]);
+
+                    if (buff_ret && buff_ret != BUFF_NEEDS_EXP_SYNC_RET_CODE) {
+                        dbg_info("buffer %d of the batch could not be mapped, ret_val: %d\n", i, buff_ret);
+                    }
+                    buffs[4 * i + 3] = (uint64_t) (int64_t) buff_ret;
+                }
+
+                change_tlb_lock(device);
+                mutex_unlock(&device->mmu_lock);
+
+                ret_val = copy_to_user((uint64_t *) tmp[0], buffs, n_buffs * 4 * sizeof(uint64_t));
+                if (ret_val != 0) {
+                    pr_warn("return codes could not be copied to user space, return %d\n", ret_val);
+                }
+                kfree(buffs);
+
+                dbg_info("user mapping of %llu buffers for vFPGA %d handled\n", n_buffs, device->id);
+            }
+            break;
+
+        // Explicitly unmap (release) a batch of user buffers, under a single acquisition of the MMU and TLB locks
+        // Args: Pointer to an array of virtual addresses, number of buffers (at most MAX_MAP_BATCH), Coyote thread ID (ctid)
+        // With HMM, explicitly mapped pages are not pinned and there is nothing to release, as for IOCTL_UNMAP_USER_MEM;
+        // the batch is rejected rather than silently ignored, so user space handles the buffers through the single-buffer path
+        case IOCTL_UNMAP_USER_MEM_BATCH:
+            ret_val = copy_from_user(&tmp, (unsigned long *) arg, 3 * sizeof(unsigned long));
+            if (ret_val != 0) {
+                pr_warn("user data could not be coppied, return %d\n", ret_val);
+            } else if (en_hmm) {
+                ret_val = -EOPNOTSUPP;
+            } else {
+                int32_t ctid = (int32_t) tmp[2];
+                uint64_t n_buffs = tmp[1];
+                uint64_t *buffs;
+                int i;
+
+                if (ctid < 0 || ctid >= N_CTID_MAX || n_buffs == 0 || n_buffs > MAX_MAP_BATCH) {
+                    pr_warn("invalid batch of %llu buffers for ctid %d\n", n_buffs, ctid);
+                    ret_val = -EINVAL;
+                    break;
+                }
+
+                buffs = kmalloc_array(n_buffs, sizeof(uint64_t), GFP_KERNEL);
+                if (!buffs) {
+                    ret_val = -ENOMEM;
+                    break;
+                }
+
+                ret_val = copy_from_user(buffs, (uint64_t *) tmp[0], n_buffs * sizeof(uint64_t));
+                if (ret_val != 0) {
+                    pr_warn("user data could not be coppied, return %d\n", ret_val);
+                    kfree(buffs);
+                    break;
+                }
+
+                pid_t hpid = device->pid_array[ctid];
+
+                mutex_lock(&device->mmu_lock);
+                change_tlb_lock(device);
+                for (i = 0; i < n_buffs; i++) {
+                    tlb_put_user_pages(device, buffs[i], ctid, hpid, 1);
+                }
+                change_tlb_lock(device);
+                mutex_unlock(&device->mmu_lock);
+                kfree(buffs);
+
+                dbg_info("user unmapping of %llu buffers for vFPGA %d handled\n", n_buffs, device->id);
+            }
+            break;
+
         // Map (attach) DMA Buffer
         // Args: DMA Buffer file descriptor (fd), virtual address, Coyote thread ID (ctid), target memory block (applicable only to Versal devices)
         case IOCTL_MAP_DMABUF:
@@ -578,6 +697,40 @@ long vfpga_dev_ioctl(struct file *file, unsigned int command, unsigned long arg)
             }
             break;
 
+        // Registers a notification ring for a Coyote thread ID (ctid); the ring is then memory mapped by the user-space (MMAP_NOTIFY + ctid)
+        // Args: Coyote thread ID (ctid)
+        case IOCTL_REGISTER_NOTIFY_RING:
+            ret_val = copy_from_user(&tmp, (unsigned long *) arg, sizeof(uint64_t));
+            if (ret_val) {
+                pr_warn("user data could not be copied, ret_val: %d\n", ret_val);
+            } else {
+                int32_t ctid = (int32_t) tmp[0];
+                if (ctid < 0 || ctid >= N_CTID_MAX) {
+                    pr_warn("invalid ctid %d for notification ring\n", ctid);
+                    ret_val = -EINVAL;
+                } else {
+                    ret_val = vfpga_register_notify_ring(device, ctid);
+                }
+            }
+            break;
+
+        // Unregisters the notification ring for a Coyote thread ID (ctid); subsequent notifications are delivered through the eventfd
+        // Args: Coyote thread ID (ctid)
+        case IOCTL_UNREGISTER_NOTIFY_RING:
+            ret_val = copy_from_user(&tmp, (unsigned long *) arg, sizeof(uint64_t));
+            if (ret_val) {
+                pr_warn("user data could not be copied, ret_val: %d\n", ret_val);
+            } else {
+                int32_t ctid = (int32_t) tmp[0];
+                if (ctid < 0 || ctid >= N_CTID_MAX) {
+                    pr_warn("invalid ctid %d for notification ring\n", ctid);
+                    ret_val = -EINVAL;
+                } else {
+                    vfpga_unregister_notify_ring(device, ctid);
+                }
+            }
+            break;
+
         default:
             dbg_info("vFPGA device %d received unknown IOCTL call %d\n", device->id, command);
             ret_val = 1;
@@ -592,6 +745,20 @@ int vfpga_dev_mmap(struct file *file, struct vm_area_struct *vma) {
     struct vfpga_dev *device = (struct vfpga_dev *) file->private_data;
     BUG_ON(!device);
 
+    // Memory map a notification ring; this is regular kernel memory, so it's mapped before the page protection is set to non-cached
+    if (vma->vm_pgoff >= MMAP_NOTIFY && vma->vm_pgoff < MMAP_NOTIFY + N_CTID_MAX) {
+        int ctid = (int) (vma->vm_pgoff - MMAP_NOTIFY);
+        dbg_info("fpga dev. %d, memory mapping notification ring for ctid %d\n", device->id, ctid);
+
+        int ret_val = vfpga_mmap_notify_ring(device, ctid, vma);
+        if (ret_val) {
+            pr_warn("remap_vmalloc_range failed for notification ring, ret_val: %d\n", ret_val);
+            return -EIO;
+        } else {
+            return 0;
+        }
+    }
+
     vma->vm_page_prot = pgprot_noncached(vma->vm_page_prot);
 
     // Memory map user registers (CSR) in vFPGAs; the ones parsed from axi_ctrl interface in the vFPGA
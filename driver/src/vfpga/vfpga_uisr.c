@@ -31,6 +31,13 @@ struct mutex user_notifier_lock[MAX_N_REGIONS][N_CTID_MAX];
 /// Values are set in vfpga_isr and read in vfpga_ops via ioctl.
 int32_t interrupt_value[MAX_N_REGIONS][N_CTID_MAX];
 
+/// List of notification rings for all possible vFPGAs and Coyote threads; NULL unless registered by the user-space
+struct vfpga_notify_ring *user_notify_ring[MAX_N_REGIONS][N_CTID_MAX];
+
+/// Protects the list of notification rings and serializes writes to them; the critical sections never wait on the user-space
+/// Also protects the eventfd contexts against being released while a notification is pushed, see vfpga_unregister_eventfd()
+static DEFINE_MUTEX(user_notify_ring_lock);
+
 int vfpga_register_eventfd(struct vfpga_dev *device, int ctid, int eventfd) {
     int ret_val = 0;
     BUG_ON(!device);
@@ -38,20 +45,121 @@ int vfpga_register_eventfd(struct vfpga_dev *device, int ctid, int eventfd) {
     mutex_init(&user_notifier_lock[device->id][ctid]);
 
     // Retrieve the kernel context from the eventfd file descriptor
-    user_notifier[device->id][ctid] = eventfd_ctx_fdget(eventfd);
-    if (IS_ERR_OR_NULL(user_notifier[device->id][ctid])) {
-        ret_val = PTR_ERR(user_notifier[device->id][ctid]);
-        user_notifier[device->id][ctid] = NULL;
+    struct eventfd_ctx *ctx = eventfd_ctx_fdget(eventfd);
+    if (IS_ERR_OR_NULL(ctx)) {
+        ret_val = PTR_ERR(ctx);
+        ctx = NULL;
         pr_warn("Could not retrieve eventfd kernel context, ret_val %d", ret_val);
     }
 
+    mutex_lock(&user_notify_ring_lock);
+    user_notifier[device->id][ctid] = ctx;
+    mutex_unlock(&user_notify_ring_lock);
+
     return ret_val;
 }
 
 void vfpga_unregister_eventfd(struct vfpga_dev *device, int ctid) {
-    // Release the kernel context and set the list entry to a nullptr
-    if (user_notifier[device->id][ctid]) {
-        eventfd_ctx_put(user_notifier[device->id][ctid]);
-    }
+    // Set the list entry to a nullptr under the lock, so that vfpga_notify_ring_push() can't signal the context after it's released
+    mutex_lock(&user_notify_ring_lock);
+    struct eventfd_ctx *ctx = user_notifier[device->id][ctid];
     user_notifier[device->id][ctid] = NULL;
+    mutex_unlock(&user_notify_ring_lock);
+
+    // Release the kernel context
+    if (ctx) {
+        eventfd_ctx_put(ctx);
+    }
+}
+
+int vfpga_register_notify_ring(struct vfpga_dev *device, int ctid) {
+    BUG_ON(!device);
+    BUILD_BUG_ON(sizeof(struct vfpga_notify_ring) > PAGE_SIZE);
+    BUILD_BUG_ON(NOTIFY_RING_SIZE & (NOTIFY_RING_SIZE - 1));
+
+    // Allocate outside of the lock; vmalloc_user returns zeroed memory which can be mapped to the user-space
+    struct vfpga_notify_ring *ring = vmalloc_user(PAGE_SIZE);
+    if (!ring) {
+        pr_warn("could not allocate notification ring, vFPGA %d, ctid %d\n", device->id, ctid);
+        return -ENOMEM;
+    }
+
+    // Re-registering (e.g. after a crashed process) replaces the previous ring
+    mutex_lock(&user_notify_ring_lock);
+    struct vfpga_notify_ring *old_ring = user_notify_ring[device->id][ctid];
+    user_notify_ring[device->id][ctid] = ring;
+    mutex_unlock(&user_notify_ring_lock);
+    
+    if (old_ring) {
+        vfree(old_ring);
+    }
+
+    dbg_info("registered notification ring, vFPGA %d, ctid %d\n", device->id, ctid);
+    return 0;
+}
+
+void vfpga_unregister_notify_ring(struct vfpga_dev *device, int ctid) {
+    mutex_lock(&user_notify_ring_lock);
+    struct vfpga_notify_ring *ring = user_notify_ring[device->id][ctid];
+    user_notify_ring[device->id][ctid] = NULL;
+    mutex_unlock(&user_notify_ring_lock);
+
+    // Pages still mapped by the user-space hold their own reference and are released on munmap
+    if (ring) {
+        vfree(ring);
+        dbg_info("unregistered notification ring, vFPGA %d, ctid %d\n", device->id, ctid);
+    }
+}
+
+int vfpga_mmap_notify_ring(struct vfpga_dev *device, int ctid, struct vm_area_struct *vma) {
+    int ret_val = -EINVAL;
+
+    mutex_lock(&user_notify_ring_lock);
+    if (user_notify_ring[device->id][ctid]) {
+        ret_val = remap_vmalloc_range(vma, user_notify_ring[device->id][ctid], 0);
+    } else {
+        pr_warn("no notification ring registered, vFPGA %d, ctid %d\n", device->id, ctid);
+    }
+    mutex_unlock(&user_notify_ring_lock);
+
+    return ret_val;
+}
+
+bool vfpga_notify_ring_push(struct vfpga_dev *device, int ctid, int32_t value) {
+    mutex_lock(&user_notify_ring_lock);
+    struct vfpga_notify_ring *ring = user_notify_ring[device->id][ctid];
+    if (!ring) {
+        mutex_unlock(&user_notify_ring_lock);
+        return false;
+    }
+
+    // The ring is single-producer (serialized by the lock above), single-consumer (the user-space)
+    uint32_t tail = ring->tail;
+    uint32_t head = READ_ONCE(ring->head);
+    if (tail - head >= NOTIFY_RING_SIZE) {
+        WRITE_ONCE(ring->dropped, ring->dropped + 1);
+        pr_warn_ratelimited("notification ring full, dropped notification, vFPGA %d, ctid %d\n", device->id, ctid);
+    } else {
+        ring->values[tail & (NOTIFY_RING_SIZE - 1)] = value;
+        // Publish the value before the new tail; pairs with the acquire load in the user-space
+        smp_store_release(&ring->tail, tail + 1);
+    }
+
+    // Order the tail update before reading the waiting flag; pairs with the fence in the user-space
+    // Otherwise, a consumer could set the flag after checking an empty ring and miss the wake-up
+    smp_mb();
+    bool wake = READ_ONCE(ring->waiting);
+
+    // Only consumers blocked on the eventfd need a signal; busy-polling consumers receive notifications without any syscalls
+    // Signalled under the lock, since vfpga_unregister_eventfd() may otherwise release the context concurrently; eventfd_signal() doesn't sleep
+    if (wake && user_notifier[device->id][ctid]) {
+        #if LINUX_VERSION_CODE >= KERNEL_VERSION(6, 8, 0)
+            eventfd_signal(user_notifier[device->id][ctid]);
+        #else
+            eventfd_signal(user_notifier[device->id][ctid], 1);
+        #endif
+    }
+    mutex_unlock(&user_notify_ring_lock);
+
+    return true;
 }
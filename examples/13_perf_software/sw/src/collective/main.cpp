@@ -0,0 +1,174 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <thread>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <boost/program_options.hpp>
+
+#include <coyote/cBench.hpp>
+#include <coyote/cOobGroup.hpp>
+#include <coyote/cCollective.hpp>
+#include <coyote/cCopyEngine.hpp>
+#include <coyote/cConnManager.hpp>
+#include "mock_thread.hpp"
+
+/**
+ * A single node of the job; all the nodes are software threads in the same process, since the loopback path of cThread 
+ * copies between the virtual addresses exchanged with the QPs. Rank 0 prints the median time of every collective, for 
+ * vectors of min_size to max_size bytes, and the corresponding algorithm bandwidth (vector size over time).
+ */
+void run_node(
+    unsigned int node, const std::vector<coyote::cPeer> &peers, uint64_t min_size, uint64_t max_size, unsigned int n_runs, bool &passed
+) {
+    coyote::fpgaCnfg cnfg;
+    cnfg.en_rdma = true;
+    cnfg.en_net = true;
+    mockThread coyote_thread(cnfg);
+
+    // RDMA buffer, shared by all the QPs: the work area of the collectives, followed by the vector
+    coyote::collConfig coll_cnfg;
+    uint64_t data_offs = coyote::cCollective::getWorkSize(peers.size(), coll_cnfg);
+    uint64_t buf_size = data_offs + max_size;
+    char *mem = (char *) std::aligned_alloc(4096, (buf_size + 4095) / 4096 * 4096);
+    if (!mem) { throw std::runtime_error("Could not allocate memory; exiting..."); }
+
+    {
+        coyote::cConnManager conn(&coyote_thread, node, peers[node].port, mem, buf_size);
+        conn.connect(peers);
+        coyote::cOobGroup group(conn);
+        coyote::cCollective coll(&coyote_thread, conn, group, coll_cnfg);
+        float *vec = (float *) (mem + data_offs);
+        unsigned int n_nodes = peers.size();
+
+        for (uint64_t size = min_size; size <= max_size; size *= 4) {
+            uint64_t count = size / sizeof(float);
+
+            // Validate once per size, before measuring
+            for (uint64_t k = 0; k < count; k++) { vec[k] = (float) (node + k % 7); }
+            coll.allreduce(data_offs, count, coyote::collDtype::FLOAT, coyote::collReduceOp::SUM);
+            for (uint64_t k = 0; k < count; k++) {
+                if (vec[k] != (float) (n_nodes * (n_nodes - 1) / 2 + n_nodes * (k % 7))) {
+                    std::cout << "Node " << node << ": incorrect all-reduce result for " << size << " bytes" << std::endl;
+                    passed = false;
+                    break;
+                }
+            }
+
+            // All the nodes start every run together
+            auto prep_fn = [&]() { group.barrier(); };
+            auto measure = [&](auto bench_fn) {
+                coyote::cBench bench(n_runs, 1);
+                bench.execute(bench_fn, prep_fn);
+                return bench.getP50();
+            };
+
+            double ring_time = measure([&]() { coll.allreduce(data_offs, count, coyote::collDtype::FLOAT, coyote::collReduceOp::SUM, coyote::collAlgo::RING); });
+            double rd_time = (n_nodes & (n_nodes - 1)) ? 0.0 : 
+                measure([&]() { coll.allreduce(data_offs, count, coyote::collDtype::FLOAT, coyote::collReduceOp::SUM, coyote::collAlgo::RECURSIVE_DOUBLING); });
+            double rs_time = measure([&]() { coll.reduceScatter(data_offs, count, coyote::collDtype::FLOAT, coyote::collReduceOp::SUM); });
+            double bcast_time = measure([&]() { coll.broadcast(data_offs, size, 0); });
+
+            if (node == 0) {
+                auto print = [&](const std::string &name, double time) {
+                    std::cout << "; " << name << std::setw(8) << time / 1e3 << " us (" << std::setw(7) << (double) size / time << " GB/s)";
+                };
+
+                std::cout << "Size: " << std::setw(9) << size << std::fixed << std::setprecision(2);
+                print("Ring all-reduce: ", ring_time);
+                if (rd_time > 0.0) {
+                    print("RD all-reduce: ", rd_time);
+                }
+                print("Reduce-scatter: ", rs_time);
+                print("Broadcast: ", bcast_time);
+                std::cout << std::endl << std::defaultfloat;
+            }
+        }
+    }
+
+    free(mem);
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int n_nodes, base_port, n_runs, n_copy_threads;
+    uint64_t min_size, max_size;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("nodes,n", boost::program_options::value<unsigned int>(&n_nodes)->default_value(4), "Number of nodes")
+        ("port,p", boost::program_options::value<unsigned int>(&base_port)->default_value(30000), "Out-of-band port of the first node; node i listens on port + i")
+        ("copy_threads,c", boost::program_options::value<unsigned int>(&n_copy_threads)->default_value(4), "Number of threads of the copy engine")
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(20), "Number of times to repeat the test")
+        ("min_size,x", boost::program_options::value<uint64_t>(&min_size)->default_value(4 * 1024), "Starting (minimum) vector size, in bytes")
+        ("max_size,X", boost::program_options::value<uint64_t>(&max_size)->default_value(16 * 1024 * 1024), "Ending (maximum) vector size, in bytes");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Number of nodes: " << n_nodes << std::endl;
+    std::cout << "First out-of-band port: " << base_port << std::endl;
+    std::cout << "Copy engine threads: " << n_copy_threads << std::endl;
+    std::cout << "Number of test runs: " << n_runs << std::endl;
+    std::cout << "Starting vector size: " << min_size << std::endl;
+    std::cout << "Ending vector size: " << max_size << std::endl;
+
+    // RDMA operations between the nodes are executed by the copy engine
+    coyote::cCopyEngine::getInstance().setThreads(n_copy_threads);
+
+    std::vector<coyote::cPeer> peers;
+    for (unsigned int i = 0; i < n_nodes; i++) {
+        peers.push_back({static_cast<int32_t>(i), "127.0.0.1", static_cast<uint16_t>(base_port + i)});
+    }
+
+    HEADER("RDMA COLLECTIVES OVER LOOPBACK [median time per collective]");
+    std::vector<std::thread> nodes;
+    std::vector<char> passed(n_nodes, true);
+    for (unsigned int i = 0; i < n_nodes; i++) {
+        nodes.emplace_back([&, i]() {
+            bool node_passed = true;
+            try {
+                run_node(i, peers, min_size, max_size, n_runs, node_passed);
+            } catch (const std::exception &e) {
+                std::cout << "Node " << i << ": " << e.what() << std::endl;
+                node_passed = false;
+            }
+            passed[i] = node_passed;
+        });
+    }
+    for (auto &node : nodes) {
+        node.join();
+    }
+
+    bool all_passed = std::all_of(passed.begin(), passed.end(), [](char p) { return p; });
+    std::cout << (all_passed ? "PASSED" : "FAILED") << std::endl;
+    return all_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <unistd.h>
+#include <boost/program_options.hpp>
+
+#include <coyote/cConnManager.hpp>
+#include "mock_thread.hpp"
+
+// Constants
+#define BUFFER_SIZE 4096
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int n_peers, base_port, timeout;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("peers,n", boost::program_options::value<unsigned int>(&n_peers)->default_value(64), "Number of peers in the mesh")
+        ("port,p", boost::program_options::value<unsigned int>(&base_port)->default_value(30000), "Out-of-band port of the first peer; peer i listens on port + i")
+        ("timeout,t", boost::program_options::value<unsigned int>(&timeout)->default_value(coyote::CONN_MANAGER_DEF_TIMEOUT), "Connection time-out, in ms");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Number of peers: " << n_peers << std::endl;
+    std::cout << "First out-of-band port: " << base_port << std::endl;
+    std::cout << "Connection time-out: " << timeout << " ms" << std::endl;
+
+    // Every peer is a Coyote thread without a vFPGA, with its own buffer, so that each peer's QPs can be told apart
+    coyote::fpgaCnfg cnfg;
+    cnfg.en_rdma = true;
+    cnfg.en_net = true;
+
+    std::vector<coyote::cPeer> peers;
+    std::vector<std::unique_ptr<mockThread>> coyote_threads;
+    std::vector<std::vector<char>> buffers(n_peers, std::vector<char>(BUFFER_SIZE));
+    for (unsigned int i = 0; i < n_peers; i++) {
+        peers.push_back({static_cast<int32_t>(i), "127.0.0.1", static_cast<uint16_t>(base_port + i)});
+        coyote_threads.emplace_back(new mockThread(cnfg));
+    }
+
+    // Bring up the full mesh, with one software thread per peer; the connection managers start listening 
+    // in their constructor, so some peers connect before others listen, which exercises the retries
+    HEADER("CONNECTION MANAGER: FULL MESH OVER LOOPBACK");
+    std::vector<std::unique_ptr<coyote::cConnManager>> conn_managers(n_peers);
+    std::vector<std::thread> workers;
+    auto begin_time = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < n_peers; i++) {
+        workers.emplace_back([&, i]() {
+            conn_managers[i].reset(new coyote::cConnManager(coyote_threads[i].get(), i, base_port + i, buffers[i].data(), BUFFER_SIZE));
+            conn_managers[i]->connect(peers, std::chrono::milliseconds(timeout));
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    auto end_time = std::chrono::steady_clock::now();
+    std::cout << "Time to full mesh: " << std::chrono::duration_cast<std::chrono::microseconds>(end_time - begin_time).count() / 1e3 << " ms" << std::endl;
+
+    // The remote side of every QP must be the local side of the peer's QP dedicated to this node
+    bool passed = true;
+    for (unsigned int i = 0; i < n_peers; i++) {
+        if (conn_managers[i]->getPeers().size() != n_peers - 1) {
+            std::cout << "Peer " << i << " is connected to " << conn_managers[i]->getPeers().size() << " peers" << std::endl;
+            passed = false;
+            continue;
+        }
+
+        for (unsigned int j = 0; j < n_peers; j++) {
+            if (i == j) {
+                continue;
+            }
+
+            coyote::ibvQp *qp = coyote_threads[i]->getQpair(conn_managers[i]->getQp(j));
+            coyote::ibvQp *peer_qp = coyote_threads[j]->getQpair(conn_managers[j]->getQp(i));
+            if (qp->remote.qpn != peer_qp->local.qpn || qp->remote.psn != peer_qp->local.psn || qp->remote.vaddr != peer_qp->local.vaddr) {
+                std::cout << "QP of peer " << i << " for peer " << j << " doesn't match the peer's QP" << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    // The out-of-band connections stay open; every peer sends its ID to every other peer, which must receive it on the socket of that peer
+    for (unsigned int i = 0; i < n_peers && passed; i++) {
+        for (unsigned int j = 0; j < n_peers; j++) {
+            if (i == j) {
+                continue;
+            }
+
+            int32_t id = i, received = -1;
+            if (write(conn_managers[i]->getSocket(j), &id, sizeof(id)) != sizeof(id) || 
+                read(conn_managers[j]->getSocket(i), &received, sizeof(received)) != sizeof(received) || received != id) {
+                std::cout << "Out-of-band connection from peer " << i << " to peer " << j << " is broken" << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+
+    // The connection managers destroy their QPs, so they're released before the Coyote threads
+    conn_managers.clear();
+    coyote_threads.clear();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,139 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <chrono>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <sys/resource.h>
+#include <boost/program_options.hpp>
+
+#include <coyote/cThread.hpp>
+
+// Constants
+#define DEFAULT_VFPGA_ID 0
+
+// Page faults of this process, minor and major, since its start
+struct faultCount {
+    uint64_t minor;
+    uint64_t major;
+};
+
+faultCount get_faults() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return { (uint64_t) usage.ru_minflt, (uint64_t) usage.ru_majflt };
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int size_gb, n_runs;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("size,s", boost::program_options::value<unsigned int>(&size_gb)->default_value(16), "Size of the allocation in GB")
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(3), "Number of times to repeat the allocation");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    if (size_gb == 0 || n_runs == 0) {
+        throw std::runtime_error("Size and number of runs must be positive; exiting...");
+    }
+    uint64_t size = (uint64_t) size_gb * coyote::HUGE_PAGE_1G_SIZE;
+
+    coyote::cThread coyote_thread(DEFAULT_VFPGA_ID, getpid());
+    uint64_t tlb_page_size = coyote_thread.getHugePageSize();
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Allocation size: " << size_gb << " GB" << std::endl;
+    std::cout << "Number of runs: " << n_runs << std::endl;
+    std::cout << "Shell's large TLB page size: " << tlb_page_size << " B" << std::endl;
+
+    HEADER("HUGE PAGES");
+    for (auto type : {coyote::CoyoteAllocType::HPF, coyote::CoyoteAllocType::HPF_1G}) {
+        bool is_1g = type == coyote::CoyoteAllocType::HPF_1G;
+        uint64_t host_page_size = is_1g ? coyote::HUGE_PAGE_1G_SIZE : tlb_page_size;
+        std::cout << (is_1g ? "HPF_1G: " : "HPF:    ");
+
+        // Every run allocates the buffer (which maps it to the vFPGA's TLB), touches every host page once and frees it
+        std::vector<double> alloc_times, touch_times;
+        faultCount alloc_faults = { 0, 0 }, touch_faults = { 0, 0 };
+        bool failed = false;
+        for (unsigned int i = 0; i < n_runs; i++) {
+            faultCount f0 = get_faults();
+            auto t0 = std::chrono::steady_clock::now();
+            char *mem = nullptr;
+            try {
+                mem = (char *) coyote_thread.getMem({type, size});
+            } catch (const std::exception &e) {
+                std::cout << e.what() << std::endl;
+            }
+            if (!mem) {
+                failed = true;
+                break;
+            }
+            auto t1 = std::chrono::steady_clock::now();
+            faultCount f1 = get_faults();
+
+            for (uint64_t offs = 0; offs < size; offs += coyote::PAGE_SIZE) {
+                mem[offs] = 1;
+            }
+            auto t2 = std::chrono::steady_clock::now();
+            faultCount f2 = get_faults();
+
+            coyote_thread.freeMem(mem);
+
+            alloc_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            touch_times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+            alloc_faults.minor += f1.minor - f0.minor; alloc_faults.major += f1.major - f0.major;
+            touch_faults.minor += f2.minor - f1.minor; touch_faults.major += f2.major - f1.major;
+        }
+        if (failed) {
+            std::cout << "allocation failed; are enough " << host_page_size << " B huge pages reserved?" << std::endl;
+            continue;
+        }
+
+        // The driver maps huge pages in chunks of the shell's large TLB page size, regardless of the host page size
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Host pages: " << std::setw(8) << size / host_page_size << "; ";
+        std::cout << "TLB entries: " << std::setw(8) << size / tlb_page_size << "; ";
+        std::cout << "getMem: " << std::setw(9) << median(alloc_times) / 1e6 << " ms; ";
+        std::cout << "First touch: " << std::setw(8) << median(touch_times) / 1e6 << " ms; ";
+        std::cout << "Faults (minor/major) in getMem: " << alloc_faults.minor / n_runs << "/" << alloc_faults.major / n_runs << ", ";
+        std::cout << "in first touch: " << touch_faults.minor / n_runs << "/" << touch_faults.major / n_runs;
+        std::cout << std::endl << std::defaultfloat;
+    }
+
+    return EXIT_SUCCESS;
+}
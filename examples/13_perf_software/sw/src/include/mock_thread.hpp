@@ -0,0 +1,140 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _MOCK_THREAD_HPP_
+#define _MOCK_THREAD_HPP_
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <algorithm>
+#include <x86intrin.h>
+
+#include <coyote/cThread.hpp>
+
+/**
+ * A Coyote thread without a vFPGA: its config registers and writeback region are plain host memory,
+ * so the software paths of cThread (command encoding, credits, register writes, tickets) can be measured 
+ * on any machine. Nothing executes the commands, so the benchmarks emulate the relevant parts of the vFPGA.
+ *
+ * @tparam Thread Coyote thread class to mock; cThread or a cThreadT specialization
+ */
+template <typename Thread>
+class mockThreadT : public Thread {
+public:
+    mockThreadT(const coyote::fpgaCnfg &cnfg, int32_t ctid = 0): Thread(cnfg, ctid) {
+        drainCmds();
+    }
+
+    // Raw command submission, bypassing invoke()
+    using Thread::postCmd;
+    using Thread::postCmds;
+
+    // Records a buffer as mapped, as userMap() does once the driver mapped it
+    using Thread::trackMapping;
+
+    /**
+     * Emulates the vFPGA consuming all the outstanding commands; the count is read from CTRL_REG, 
+     * which also receives the commands, so it has to be reset after they were written
+     */
+    void drainCmds() {
+        #ifdef EN_AVX
+        if (this->fcnfg.en_avx) {
+            // Examples aren't necessarily compiled with AVX, so the 256-bit register is cleared in 64-bit words
+            volatile uint64_t *ctrl = reinterpret_cast<volatile uint64_t*>(&this->cnfg_reg_avx[static_cast<uint32_t>(coyote::CnfgAvxRegs::CTRL_REG)]);
+            for (int i = 0; i < 4; i++) {
+                ctrl[i] = 0;
+            }
+            return;
+        }
+        #endif
+        this->cnfg_reg[static_cast<uint32_t>(coyote::CnfgLegRegs::CTRL_REG)] = 0;
+    }
+
+    /**
+     * Reads the locally tracked number of outstanding commands, if no producer is submitting at the moment;
+     * the count is only updated under the submission lock, so it must never exceed the number of credits
+     */
+    bool sampleCmdCnt(uint32_t &cnt) {
+        std::unique_lock<std::recursive_mutex> lck(this->submit_lock, std::try_to_lock);
+        if (!lck.owns_lock()) {
+            return false;
+        }
+        cnt = this->cmd_cnt;
+        return true;
+    }
+};
+
+using mockThread = mockThreadT<coyote::cThread>;
+
+/**
+ * Emulates the command FIFO of the vFPGA in a background thread: it continuously consumes the outstanding commands
+ * and samples the number of outstanding commands tracked by the Coyote thread, recording the largest value seen
+ */
+class mockDevice {
+    mockThread &coyote_thread;
+    std::atomic<bool> running = { true };
+    std::atomic<uint32_t> max_cmd_cnt = { 0 };
+    std::thread worker;
+
+public:
+    mockDevice(mockThread &coyote_thread): coyote_thread(coyote_thread) {
+        worker = std::thread([this]() {
+            while (running) {
+                this->coyote_thread.drainCmds();
+
+                uint32_t cnt;
+                if (this->coyote_thread.sampleCmdCnt(cnt)) {
+                    max_cmd_cnt = std::max(max_cmd_cnt.load(), cnt);
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    ~mockDevice() {
+        running = false;
+        worker.join();
+    }
+
+    /// Largest number of outstanding commands observed
+    uint32_t getMaxCmdCnt() const { return max_cmd_cnt; }
+};
+
+/// Returns the frequency of the time-stamp counter in GHz (i.e., cycles per ns), measured against the steady clock
+inline double tscGhz() {
+    auto begin_time = std::chrono::steady_clock::now();
+    uint64_t begin_tsc = __rdtsc();
+    while (std::chrono::steady_clock::now() - begin_time < std::chrono::milliseconds(100)) {}
+    uint64_t end_tsc = __rdtsc();
+    auto end_time = std::chrono::steady_clock::now();
+
+    return (double) (end_tsc - begin_tsc) / (double) std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - begin_time).count();
+}
+
+#endif // _MOCK_THREAD_HPP_
@@ -0,0 +1,204 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <set>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <boost/program_options.hpp>
+
+#include <coyote/cBench.hpp>
+#include "mock_thread.hpp"
+
+// Constants
+#define TRANSFER_SIZE 4096
+#define BATCH_SIZE 4
+#define MAX_CMD_CNT (coyote::CMD_FIFO_DEPTH - coyote::CMD_FIFO_THR + 1)
+
+/**
+ * Stress test: every producer issues n_invokes local reads through the same Coyote thread, alternating between single operations, 
+ * batches and transfers which are split into several commands; a background thread emulates the vFPGA consuming the commands.
+ * Local reads leave a non-zero value in CTRL_REG, so producers regularly run out of credits and wait for the emulated vFPGA.
+ * Checks that the credits are never oversubscribed, that every producer receives strictly increasing tickets and 
+ * that, across all the producers, every ticket is issued exactly once.
+ */
+bool run_stress(mockThread &coyote_thread, unsigned int n_producers, unsigned int n_invokes) {
+    coyote_thread.clearCompleted();
+
+    // The buffers are never accessed, since there is no vFPGA to execute the commands
+    static char mem[BATCH_SIZE * TRANSFER_SIZE];
+    std::vector<coyote::localSg> batch;
+    for (int i = 0; i < BATCH_SIZE; i++) {
+        batch.push_back({.addr = &mem[i * TRANSFER_SIZE], .len = TRANSFER_SIZE});
+    }
+    coyote::localSg split_sg = {.addr = mem, .len = 2 * coyote::MAX_TRANSFER_SIZE + TRANSFER_SIZE};
+
+    std::vector<std::vector<uint32_t>> seqs(n_producers);
+    uint32_t max_cmd_cnt;
+    {
+        mockDevice device(coyote_thread);
+
+        std::vector<std::thread> producers;
+        for (unsigned int p = 0; p < n_producers; p++) {
+            producers.emplace_back([&, p]() {
+                for (unsigned int i = 0; i < n_invokes; i++) {
+                    coyote::cmdTicket ticket;
+                    switch (i % 3) {
+                        case 0: ticket = coyote_thread.invoke(coyote::CoyoteOper::LOCAL_READ, batch[0]); break;
+                        case 1: ticket = coyote_thread.invoke(coyote::CoyoteOper::LOCAL_READ, batch); break;
+                        default: ticket = coyote_thread.invoke(coyote::CoyoteOper::LOCAL_READ, split_sg); break;
+                    }
+                    seqs[p].push_back(ticket.seq);
+                }
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        max_cmd_cnt = device.getMaxCmdCnt();
+    }
+
+    bool passed = true;
+    if (max_cmd_cnt > MAX_CMD_CNT) {
+        std::cout << "Outstanding commands exceeded the credits: " << max_cmd_cnt << " > " << MAX_CMD_CNT << std::endl;
+        passed = false;
+    }
+
+    std::set<uint32_t> all_seqs;
+    for (unsigned int p = 0; p < n_producers; p++) {
+        for (unsigned int i = 0; i < n_invokes; i++) {
+            if (i > 0 && seqs[p][i] <= seqs[p][i - 1]) {
+                std::cout << "Producer " << p << " received ticket " << seqs[p][i] << " after ticket " << seqs[p][i - 1] << std::endl;
+                passed = false;
+            }
+            all_seqs.insert(seqs[p][i]);
+        }
+    }
+    if (all_seqs.size() != n_producers * n_invokes || *all_seqs.begin() != 1 || *all_seqs.rbegin() != n_producers * n_invokes) {
+        std::cout << "Tickets are not a permutation of 1.." << n_producers * n_invokes << std::endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+// Measures the aggregate submission rate of n_producers threads, each issuing n_invokes local writes; returns the median time of a run, in ns
+double run_bench(mockThread &coyote_thread, unsigned int n_producers, unsigned int n_invokes, unsigned int n_runs) {
+    static char mem[TRANSFER_SIZE];
+    coyote::localSg sg = {.addr = mem, .len = TRANSFER_SIZE};
+
+    // Producers are started before the measurement and released at once, so thread creation isn't measured
+    std::atomic<bool> go;
+    std::vector<std::thread> producers;
+    auto prep_fn = [&]() {
+        go = false;
+        producers.clear();
+        for (unsigned int p = 0; p < n_producers; p++) {
+            producers.emplace_back([&]() {
+                while (!go) { std::this_thread::yield(); }
+                for (unsigned int i = 0; i < n_invokes; i++) {
+                    coyote_thread.invoke(coyote::CoyoteOper::LOCAL_WRITE, sg);
+                }
+            });
+        }
+    };
+
+    auto bench_fn = [&]() {
+        go = true;
+        for (auto &producer : producers) {
+            producer.join();
+        }
+    };
+
+    coyote::cBench bench(n_runs, 1);
+    bench.execute(bench_fn, prep_fn);
+
+    return bench.getP50();
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    bool avx;
+    unsigned int n_runs, max_producers, n_invokes;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("avx,a", boost::program_options::value<bool>(&avx)->default_value(true), "Emulate a shell with AVX config registers")
+        ("producers,p", boost::program_options::value<unsigned int>(&max_producers)->default_value(32), "Maximum number of producer threads")
+        ("invokes,i", boost::program_options::value<unsigned int>(&n_invokes)->default_value(10000), "Number of operations issued by every producer")
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(20), "Number of times to repeat the test");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "AVX config registers: " << (avx ? "Yes" : "No") << std::endl;
+    std::cout << "Maximum number of producers: " << max_producers << std::endl;
+    std::cout << "Operations per producer: " << n_invokes << std::endl;
+    std::cout << "Number of test runs: " << n_runs << std::endl;
+    std::cout << "Hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    // Create a Coyote thread without a vFPGA, shared by all the producers
+    coyote::fpgaCnfg cnfg;
+    cnfg.en_avx = avx;
+    cnfg.en_strm = true;
+    mockThread coyote_thread(cnfg);
+    coyote_thread.setMultiProducer(true);
+
+    // Stress test
+    HEADER("MULTI-PRODUCER STRESS TEST");
+    bool passed = true;
+    for (unsigned int n_producers = 1; n_producers <= max_producers; n_producers *= 2) {
+        bool producers_passed = run_stress(coyote_thread, n_producers, n_invokes / 10);
+        std::cout << "Producers: " << std::setw(2) << n_producers << "; " << (producers_passed ? "PASSED" : "FAILED") << std::endl;
+        passed &= producers_passed;
+    }
+    if (!passed) {
+        return EXIT_FAILURE;
+    }
+
+    // Benchmark sweep; a single producer is also measured without multi-producer mode, i.e., without the submission lock
+    HEADER("MULTI-PRODUCER SCALING");
+    coyote_thread.setMultiProducer(false);
+    double lock_free_time = run_bench(coyote_thread, 1, n_invokes, n_runs);
+    std::cout << "Producers:  1 (lock-free); " << std::fixed << std::setprecision(2);
+    std::cout << "Throughput: " << std::setw(8) << (double) n_invokes / lock_free_time * 1e3 << " Mops/s; ";
+    std::cout << "Time per operation: " << std::setw(8) << lock_free_time / (double) n_invokes << " ns" << std::endl;
+
+    coyote_thread.setMultiProducer(true);
+    for (unsigned int n_producers = 1; n_producers <= max_producers; n_producers *= 2) {
+        double time = run_bench(coyote_thread, n_producers, n_invokes, n_runs);
+        double n_ops = (double) n_producers * (double) n_invokes;
+        std::cout << "Producers: " << std::setw(2) << n_producers << "; ";
+        std::cout << "Throughput: " << std::setw(8) << n_ops / time * 1e3 << " Mops/s; ";
+        std::cout << "Time per operation: " << std::setw(8) << time / n_ops << " ns" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
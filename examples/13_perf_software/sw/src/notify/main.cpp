@@ -0,0 +1,170 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <boost/program_options.hpp>
+
+#include <coyote/cBench.hpp>
+#include <coyote/cThread.hpp>
+
+// Constants
+#define DEFAULT_VFPGA_ID 0
+#define DATA_SIZE_BYTES 64
+
+// Notifications received by a Coyote thread; updated by its interrupt callback, which runs on the thread of the interrupt reactor
+struct notifyState {
+    std::atomic<uint32_t> received = { 0 };
+    std::atomic<int> last_value = { 0 };
+};
+
+// A Coyote thread issuing transfers, each of which makes the vFPGA raise an interrupt with the transfer's first word as value
+struct notifyThread {
+    std::unique_ptr<notifyState> state;
+    std::unique_ptr<coyote::cThread> coyote_thread;
+    int *data;
+    coyote::localSg sg;
+};
+
+// Waits until a Coyote thread received the given number of notifications
+void wait_received(notifyState &state, uint32_t target) {
+    while (static_cast<int32_t>(state.received.load() - target) < 0) {
+        std::this_thread::yield();
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int max_threads, n_runs, n_burst;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("threads,t", boost::program_options::value<unsigned int>(&max_threads)->default_value(64), "Maximum number of Coyote threads")
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(1000), "Number of times to repeat the latency test")
+        ("burst,b", boost::program_options::value<unsigned int>(&n_burst)->default_value(1000), "Number of transfers per Coyote thread in the throughput test");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Maximum number of Coyote threads: " << max_threads << std::endl;
+    std::cout << "Number of latency test runs: " << n_runs << std::endl;
+    std::cout << "Transfers per Coyote thread in the throughput test: " << n_burst << std::endl;
+
+    HEADER("INTERRUPT NOTIFICATIONS");
+    for (unsigned int n_threads : {1, 16, 64}) {
+        if (n_threads > max_threads) {
+            break;
+        }
+
+        // All the Coyote threads register their interrupts with the same, process-wide interrupt reactor
+        std::vector<notifyThread> threads(n_threads);
+        for (auto &t : threads) {
+            t.state.reset(new notifyState());
+            notifyState *state = t.state.get();
+            t.coyote_thread.reset(new coyote::cThread(DEFAULT_VFPGA_ID, getpid(), 0, [state](int value) {
+                state->last_value = value;
+                state->received++;
+            }));
+            t.data = (int *) t.coyote_thread->getMem({coyote::CoyoteAllocType::REG, DATA_SIZE_BYTES});
+            if (!t.data) { throw std::runtime_error("Could not allocate memory; exiting..."); }
+            t.sg = {.addr = t.data, .len = DATA_SIZE_BYTES};
+        }
+
+        // Latency: every Coyote thread, driven by its own software thread, issues one transfer at a time and waits for its notification
+        std::vector<double> p50s(n_threads), p99s(n_threads);
+        std::vector<char> values_ok(n_threads, true);
+        std::vector<std::thread> workers;
+        for (unsigned int i = 0; i < n_threads; i++) {
+            workers.emplace_back([&, i]() {
+                notifyThread &t = threads[i];
+                uint32_t target = t.state->received;
+
+                auto prep_fn = [&]() {
+                    t.data[0]++;
+                    target++;
+                };
+                auto bench_fn = [&]() {
+                    t.coyote_thread->invoke(coyote::CoyoteOper::LOCAL_READ, t.sg);
+                    wait_received(*t.state, target);
+                };
+
+                coyote::cBench bench(n_runs, n_runs / 10);
+                bench.execute(bench_fn, prep_fn);
+                p50s[i] = bench.getP50();
+                p99s[i] = bench.getP99();
+                values_ok[i] = t.state->last_value == t.data[0];
+            });
+        }
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+
+        // Throughput: every Coyote thread issues a burst of transfers, without waiting for the notifications in between
+        std::atomic<bool> go(false);
+        for (unsigned int i = 0; i < n_threads; i++) {
+            workers.emplace_back([&, i]() {
+                notifyThread &t = threads[i];
+                uint32_t target = t.state->received + n_burst;
+                while (!go) { std::this_thread::yield(); }
+                for (unsigned int k = 0; k < n_burst; k++) {
+                    t.coyote_thread->invoke(coyote::CoyoteOper::LOCAL_READ, t.sg);
+                }
+                wait_received(*t.state, target);
+            });
+        }
+        auto begin_time = std::chrono::steady_clock::now();
+        go = true;
+        for (auto &worker : workers) {
+            worker.join();
+        }
+        double elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin_time).count();
+
+        double avg_p50 = 0.0;
+        for (double p50 : p50s) { avg_p50 += p50 / (double) n_threads; }
+        double max_p99 = *std::max_element(p99s.begin(), p99s.end());
+
+        std::cout << "Coyote threads: " << std::setw(2) << n_threads << "; " << std::fixed << std::setprecision(2);
+        std::cout << "Latency P50 (average): " << std::setw(8) << avg_p50 / 1e3 << " us; ";
+        std::cout << "Latency P99 (max): " << std::setw(8) << max_p99 / 1e3 << " us; ";
+        std::cout << "Throughput: " << std::setw(10) << (double) n_threads * (double) n_burst / elapsed * 1e9 << " notifications/s";
+        std::cout << std::endl << std::defaultfloat;
+
+        if (!std::all_of(values_ok.begin(), values_ok.end(), [](char ok) { return ok; })) {
+            std::cout << "Some notifications carried an unexpected value" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,190 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <atomic>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <boost/program_options.hpp>
+
+#include <coyote/cOobGroup.hpp>
+#include <coyote/cConnManager.hpp>
+#include "mock_thread.hpp"
+
+// Constants
+#define LARGE_MSG_SIZE (256 * 1024)
+
+// Prints the latency statistics of a collective
+void print_stats(const std::string &name, const coyote::oobCollStats &stats) {
+    std::cout << name << std::fixed << std::setprecision(2);
+    std::cout << "Calls: " << std::setw(5) << stats.n_calls << "; ";
+    std::cout << "Average: " << std::setw(8) << (double) stats.total.count() / (double) stats.n_calls / 1e3 << " us; ";
+    std::cout << "Min: " << std::setw(8) << (double) stats.min.count() / 1e3 << " us; ";
+    std::cout << "Max: " << std::setw(8) << (double) stats.max.count() / 1e3 << " us" << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+/**
+ * A single node of the job, running in its own process: connects to all the other nodes and runs n_iters iterations of
+ * barriers, broadcasts (from a different root and with a different size every time) and allgathers, validating the results.
+ * The number of nodes which entered a barrier is counted in memory shared by all the processes, so that it can be checked 
+ * that no node leaves a barrier before all the others entered it.
+ */
+bool run_node(
+    unsigned int node, unsigned int n_nodes, unsigned int base_port, unsigned int n_iters, std::atomic<unsigned int> *entered
+) {
+    coyote::fpgaCnfg cnfg;
+    cnfg.en_rdma = true;
+    cnfg.en_net = true;
+    mockThread coyote_thread(cnfg);
+
+    // Node IDs don't have to be consecutive; they are mapped to ranks in ascending order
+    std::vector<coyote::cPeer> peers;
+    for (unsigned int i = 0; i < n_nodes; i++) {
+        peers.push_back({static_cast<int32_t>(3 * i + 1), "127.0.0.1", static_cast<uint16_t>(base_port + i)});
+    }
+
+    static char mem[4096];
+    coyote::cConnManager conn(&coyote_thread, 3 * node + 1, base_port + node, mem, sizeof(mem));
+    conn.connect(peers);
+    coyote::cOobGroup group(conn);
+
+    bool passed = group.getRank() == static_cast<int32_t>(node) && group.getSize() == static_cast<int32_t>(n_nodes);
+    for (unsigned int it = 0; it < n_iters && passed; it++) {
+        // Barrier
+        (*entered)++;
+        group.barrier();
+        passed &= entered->load() >= (it + 1) * n_nodes;
+
+        // Broadcast
+        int32_t root = it % n_nodes;
+        std::vector<char> buf(it * 37 + 1);
+        if (group.getRank() == root) {
+            for (size_t k = 0; k < buf.size(); k++) { buf[k] = (char) (k + it); }
+        }
+        group.broadcast(buf.data(), buf.size(), root);
+        for (size_t k = 0; k < buf.size(); k++) { passed &= buf[k] == (char) (k + it); }
+
+        // Allgather, of a buffer and of a value
+        std::vector<uint64_t> contribution(it + 1, node * 1000 + it), all((it + 1) * n_nodes);
+        group.allgather(contribution.data(), contribution.size() * sizeof(uint64_t), all.data());
+        for (unsigned int r = 0; r < n_nodes; r++) {
+            for (unsigned int k = 0; k <= it; k++) { passed &= all[r * (it + 1) + k] == r * 1000 + it; }
+        }
+
+        std::vector<int32_t> ids = group.allgather<int32_t>(3 * node + 1);
+        for (unsigned int r = 0; r < n_nodes; r++) { passed &= ids[r] == static_cast<int32_t>(3 * r + 1); }
+    }
+
+    // Large messages don't fit the socket buffers, so they only complete if sending and receiving progress concurrently
+    std::vector<char> large(LARGE_MSG_SIZE, (char) node), large_all((size_t) LARGE_MSG_SIZE * n_nodes);
+    group.allgather(large.data(), large.size(), large_all.data());
+    for (unsigned int r = 0; r < n_nodes; r++) { passed &= large_all[(size_t) r * LARGE_MSG_SIZE + LARGE_MSG_SIZE - 1] == (char) r; }
+
+    // Results of all the nodes are collected on rank 0, which prints them together with its statistics
+    std::vector<uint8_t> results = group.allgather<uint8_t>(passed);
+    if (group.getRank() == 0) {
+        for (unsigned int r = 0; r < n_nodes; r++) {
+            if (!results[r]) { std::cout << "Node " << r << " received incorrect results" << std::endl; }
+        }
+        print_stats("Barrier:   ", group.getStats(coyote::oobCollOp::BARRIER));
+        print_stats("Broadcast: ", group.getStats(coyote::oobCollOp::BROADCAST));
+        print_stats("Allgather: ", group.getStats(coyote::oobCollOp::ALLGATHER));
+    }
+    group.barrier();
+
+    return passed;
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int max_nodes, base_port, n_iters;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("nodes,n", boost::program_options::value<unsigned int>(&max_nodes)->default_value(32), "Maximum number of nodes (processes)")
+        ("port,p", boost::program_options::value<unsigned int>(&base_port)->default_value(30000), "Out-of-band port of the first node; node i listens on port + i")
+        ("iterations,i", boost::program_options::value<unsigned int>(&n_iters)->default_value(200), "Number of iterations of the collectives");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Maximum number of nodes: " << max_nodes << std::endl;
+    std::cout << "First out-of-band port: " << base_port << std::endl;
+    std::cout << "Number of iterations: " << n_iters << std::endl;
+
+    // Barrier counter, shared by all the processes
+    void *shared = mmap(NULL, sizeof(std::atomic<unsigned int>), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) { throw std::runtime_error("Could not allocate shared memory; exiting..."); }
+    std::atomic<unsigned int> *entered = new (shared) std::atomic<unsigned int>(0);
+
+    // Group sizes include ones which aren't powers of two, since these take partial rounds in the collectives
+    bool passed = true;
+    for (unsigned int n_nodes : {2, 3, 5, 8, 13, 21, 32}) {
+        if (n_nodes > max_nodes) {
+            break;
+        }
+
+        HEADER("OUT-OF-BAND COLLECTIVES: " << n_nodes << " NODES");
+        std::cout.flush();
+        *entered = 0;
+
+        std::vector<pid_t> pids;
+        for (unsigned int node = 0; node < n_nodes; node++) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                bool node_passed = false;
+                try {
+                    node_passed = run_node(node, n_nodes, base_port, n_iters, entered);
+                } catch (const std::exception &e) {
+                    std::cout << "Node " << node << ": " << e.what() << std::endl;
+                }
+                std::cout.flush();
+                _exit(node_passed ? EXIT_SUCCESS : EXIT_FAILURE);
+            } else if (pid < 0) {
+                throw std::runtime_error("Could not fork a node; exiting...");
+            }
+            pids.push_back(pid);
+        }
+
+        bool nodes_passed = true;
+        for (pid_t pid : pids) {
+            int status;
+            waitpid(pid, &status, 0);
+            nodes_passed &= WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+        }
+        std::cout << (nodes_passed ? "PASSED" : "FAILED") << std::endl;
+        passed &= nodes_passed;
+    }
+
+    munmap(shared, sizeof(std::atomic<unsigned int>));
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,122 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <boost/program_options.hpp>
+
+#include <coyote/cBench.hpp>
+#include <coyote/cThreadT.hpp>
+#include "mock_thread.hpp"
+
+// Constants
+#define TRANSFER_SIZE 4096
+#define N_OPS 256
+
+// Shell configurations, with host streams and writeback
+using avxTraits = coyote::shellTraits<true, true, true, false>;
+using legacyTraits = coyote::shellTraits<false, true, true, false>;
+
+/**
+ * Measures a Coyote thread of the given class, for the shell configuration in ShellTraits; returns the median time, in ns, of
+ * (1) submitting a local write with invoke() and (2) polling for the completion of an operation with isDone()
+ */
+template <typename Thread, typename ShellTraits>
+std::pair<double, double> run_bench(unsigned int n_runs) {
+    coyote::fpgaCnfg cnfg;
+    cnfg.en_avx = ShellTraits::en_avx;
+    cnfg.en_wb = ShellTraits::en_wb;
+    cnfg.en_strm = ShellTraits::en_strm;
+    cnfg.en_mem = ShellTraits::en_mem;
+    mockThreadT<Thread> coyote_thread(cnfg);
+
+    // The buffer is never accessed, since there is no vFPGA to execute the commands
+    static char mem[TRANSFER_SIZE];
+    coyote::localSg sg = {.addr = mem, .len = TRANSFER_SIZE};
+
+    // Submission; the calls resolve to the specialized functions for cThreadT, since they're made on the derived class
+    coyote::cmdTicket ticket;
+    auto prep_fn = [&]() {
+        coyote_thread.drainCmds();
+    };
+    auto invoke_fn = [&]() {
+        for (int i = 0; i < N_OPS; i++) {
+            ticket = coyote_thread.invoke(coyote::CoyoteOper::LOCAL_WRITE, sg);
+        }
+    };
+
+    coyote::cBench bench(n_runs, n_runs / 10);
+    bench.execute(invoke_fn, prep_fn);
+    double invoke_time = bench.getP50() / (double) N_OPS;
+
+    // Completion polling; nothing completes, so every poll reads the counter and returns false
+    volatile bool done;
+    auto poll_fn = [&]() {
+        for (int i = 0; i < N_OPS; i++) {
+            done = coyote_thread.isDone(ticket);
+        }
+    };
+
+    bench.execute(poll_fn, prep_fn);
+    double poll_time = bench.getP50() / (double) N_OPS;
+
+    return {invoke_time, poll_time};
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int n_runs;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(10000), "Number of times to repeat the test");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Number of test runs: " << n_runs << std::endl;
+
+    double ghz = tscGhz();
+    std::cout << "TSC frequency: " << ghz << " GHz" << std::endl;
+
+    HEADER("cThread VS cThreadT [ns (cycles) per operation]");
+    auto print = [&](const std::string &name, std::pair<double, double> times) {
+        std::cout << name << std::fixed << std::setprecision(1);
+        std::cout << "invoke: " << std::setw(6) << times.first << " (" << std::setw(6) << times.first * ghz << "); ";
+        std::cout << "isDone: " << std::setw(6) << times.second << " (" << std::setw(6) << times.second * ghz << ")" << std::endl;
+        std::cout << std::defaultfloat;
+    };
+
+    print("AVX, cThread:     ", run_bench<coyote::cThread, avxTraits>(n_runs));
+    print("AVX, cThreadT:    ", run_bench<coyote::cThreadT<avxTraits>, avxTraits>(n_runs));
+    print("Legacy, cThread:  ", run_bench<coyote::cThread, legacyTraits>(n_runs));
+    print("Legacy, cThreadT: ", run_bench<coyote::cThreadT<legacyTraits>, legacyTraits>(n_runs));
+
+    return EXIT_SUCCESS;
+}
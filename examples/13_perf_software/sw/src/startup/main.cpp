@@ -0,0 +1,136 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <memory>
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <boost/program_options.hpp>
+
+#include <coyote/cBench.hpp>
+#include <coyote/cThread.hpp>
+#include <coyote/cThreadPool.hpp>
+
+// Constants
+#define DEFAULT_VFPGA_ID 0
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+// Constructs and destroys cThreads and reports the median duration of the constructor and its phases, see cThread::getStartupStats()
+void bench_construction(unsigned int n_runs, bool cached) {
+    std::unique_ptr<coyote::cThread> coyote_thread;
+    std::vector<double> open, register_ctid, shell_cnfg, interrupts, mmap, total;
+    unsigned int n_cached = 0;
+
+    // cBench only measures the whole constructor, so the phases are recorded before every cThread is destroyed
+    auto record_fn = [&]() {
+        if (!coyote_thread) {
+            return;
+        }
+        coyote::startupStats stats = coyote_thread->getStartupStats();
+        open.push_back(stats.open.count());
+        register_ctid.push_back(stats.register_ctid.count());
+        shell_cnfg.push_back(stats.shell_cnfg.count());
+        interrupts.push_back(stats.interrupts.count());
+        mmap.push_back(stats.mmap.count());
+        total.push_back(stats.total.count());
+        n_cached += stats.cnfg_cached;
+        coyote_thread.reset();
+    };
+    auto prep_fn = [&]() {
+        record_fn();
+        if (!cached) {
+            coyote::cThread::invalidateShellCnfg();
+        }
+    };
+    auto bench_fn = [&]() {
+        coyote_thread.reset(new coyote::cThread(DEFAULT_VFPGA_ID, getpid()));
+    };
+
+    // No warm-up runs, so that every recorded constructor corresponds to a measured one
+    coyote::cBench bench(n_runs, 0);
+    bench.execute(bench_fn, prep_fn);
+    record_fn();
+
+    std::cout << (cached ? "cThread, cached configuration:   " : "cThread, uncached configuration: ") << std::fixed << std::setprecision(2);
+    std::cout << "Construction (cBench P50): " << std::setw(8) << bench.getP50() / 1e3 << " us; ";
+    std::cout << "open: " << median(open) / 1e3 << " us, ";
+    std::cout << "register ctid: " << median(register_ctid) / 1e3 << " us, ";
+    std::cout << "shell config: " << median(shell_cnfg) / 1e3 << " us, ";
+    std::cout << "interrupts: " << median(interrupts) / 1e3 << " us, ";
+    std::cout << "mmap: " << median(mmap) / 1e3 << " us, ";
+    std::cout << "total: " << median(total) / 1e3 << " us; ";
+    std::cout << "configuration cached in " << n_cached << "/" << n_runs << " runs";
+    std::cout << std::endl << std::defaultfloat;
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int n_runs;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(100), "Number of times to repeat the test");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    if (n_runs == 0) {
+        throw std::runtime_error("Number of runs must be positive; exiting...");
+    }
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Number of test runs: " << n_runs << std::endl;
+
+    HEADER("COYOTE THREAD STARTUP");
+    bench_construction(n_runs, false);
+    bench_construction(n_runs, true);
+
+    // A pooled cThread is constructed once; afterwards, acquiring it only takes it from the pool and returning it resets it
+    coyote::cThreadPool pool(DEFAULT_VFPGA_ID, 1);
+    coyote::cThreadPool::threadHandle handle;
+
+    coyote::cBench acquire_bench(n_runs, n_runs / 10);
+    acquire_bench.execute([&]() { handle = pool.acquire(); }, [&]() { handle.reset(); });
+    handle.reset();
+
+    coyote::cBench release_bench(n_runs, n_runs / 10);
+    release_bench.execute([&]() { handle.reset(); }, [&]() { handle = pool.acquire(); });
+
+    coyote::threadPoolStats stats = pool.getStats();
+    std::cout << "cThreadPool:                     " << std::fixed << std::setprecision(2);
+    std::cout << "Acquire (cBench P50): " << std::setw(8) << acquire_bench.getP50() / 1e3 << " us; ";
+    std::cout << "Return and reset (cBench P50): " << std::setw(8) << release_bench.getP50() / 1e3 << " us; ";
+    std::cout << "cThreads constructed: " << stats.n_created << ", reused: " << stats.n_reused;
+    std::cout << std::endl << std::defaultfloat;
+
+    return EXIT_SUCCESS;
+}
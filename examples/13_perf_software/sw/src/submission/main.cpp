@@ -0,0 +1,140 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <vector>
+#include <iomanip>
+#include <iostream>
+#include <boost/program_options.hpp>
+
+#include <coyote/cBench.hpp>
+#include "mock_thread.hpp"
+
+// Constants
+#define TRANSFER_SIZE 4096
+#define MAX_BATCH_SIZE 256
+
+// Measures the submission of n_cmds commands and returns the median time per command, in ns
+template <class SubmitFunc>
+double run_bench(mockThread &coyote_thread, unsigned int n_cmds, unsigned int n_runs, SubmitFunc const &submit_fn) {
+    // Before every run, emulate the vFPGA consuming the previous commands, so that the credits never run out
+    auto prep_fn = [&]() {
+        coyote_thread.drainCmds();
+    };
+
+    auto bench_fn = [&]() {
+        submit_fn(n_cmds);
+    };
+
+    coyote::cBench bench(n_runs, n_runs / 10);
+    bench.execute(bench_fn, prep_fn);
+
+    return bench.getP50() / (double) n_cmds;
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    bool avx;
+    unsigned int n_runs;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("avx,a", boost::program_options::value<bool>(&avx)->default_value(true), "Emulate a shell with AVX config registers")
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(10000), "Number of times to repeat the test");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "AVX config registers: " << (avx ? "Yes" : "No") << std::endl;
+    std::cout << "Number of test runs: " << n_runs << std::endl;
+
+    // Create a Coyote thread without a vFPGA; local writes leave zero in CTRL_REG, so the outstanding 
+    // command count reads back as zero and the credit check never blocks, even within a run
+    coyote::fpgaCnfg cnfg;
+    cnfg.en_avx = avx;
+    cnfg.en_strm = true;
+    mockThread coyote_thread(cnfg);
+
+    // The buffers are never accessed, since there is no vFPGA to execute the commands
+    static char mem[MAX_BATCH_SIZE * TRANSFER_SIZE];
+    std::vector<coyote::localSg> sgs;
+    std::vector<std::array<uint64_t, 4>> cmds;
+    for (int i = 0; i < MAX_BATCH_SIZE; i++) {
+        coyote::localSg sg = {.addr = &mem[i * TRANSFER_SIZE], .len = TRANSFER_SIZE};
+        sgs.push_back(sg);
+        cmds.push_back(coyote::localCmd(coyote::CoyoteOper::LOCAL_WRITE, coyote_thread.getCtid(), sg, true));
+    }
+
+    // Single submission: one invoke() per command; every command carries last, as with independent operations
+    auto single_fn = [&](unsigned int n_cmds) {
+        for (unsigned int i = 0; i < n_cmds; i++) {
+            coyote_thread.invoke(coyote::CoyoteOper::LOCAL_WRITE, sgs[i]);
+        }
+    };
+
+    // Batched submission: one invoke() for all the commands, with a single credit check per burst
+    std::vector<coyote::localSg> batch;
+    auto batched_fn = [&](unsigned int n_cmds) {
+        coyote_thread.invoke(coyote::CoyoteOper::LOCAL_WRITE, batch);
+    };
+
+    // The same, for pre-encoded commands, which isolates the credit check and the register writes
+    auto single_raw_fn = [&](unsigned int n_cmds) {
+        for (unsigned int i = 0; i < n_cmds; i++) {
+            coyote_thread.postCmd(cmds[i][0], cmds[i][1], cmds[i][2], cmds[i][3]);
+        }
+    };
+
+    std::vector<std::array<uint64_t, 4>> raw_batch;
+    auto batched_raw_fn = [&](unsigned int n_cmds) {
+        coyote_thread.postCmds(raw_batch);
+    };
+
+    double ghz = tscGhz();
+    std::cout << "TSC frequency: " << ghz << " GHz" << std::endl << std::endl;
+
+    // Benchmark sweep; reported times are per command
+    HEADER("COMMAND SUBMISSION [ns (cycles) per command]");
+    for (unsigned int n_cmds = 1; n_cmds <= MAX_BATCH_SIZE; n_cmds *= 4) {
+        batch.assign(sgs.begin(), sgs.begin() + n_cmds);
+        raw_batch.assign(cmds.begin(), cmds.begin() + n_cmds);
+
+        double single_time = run_bench(coyote_thread, n_cmds, n_runs, single_fn);
+        double batched_time = run_bench(coyote_thread, n_cmds, n_runs, batched_fn);
+        double single_raw_time = run_bench(coyote_thread, n_cmds, n_runs, single_raw_fn);
+        double batched_raw_time = run_bench(coyote_thread, n_cmds, n_runs, batched_raw_fn);
+
+        std::cout << "Commands: " << std::setw(4) << n_cmds << "; " << std::fixed << std::setprecision(1);
+        std::cout << "invoke single: " << std::setw(6) << single_time << " (" << std::setw(6) << single_time * ghz << "); ";
+        std::cout << "invoke batched: " << std::setw(6) << batched_time << " (" << std::setw(6) << batched_time * ghz << "); ";
+        std::cout << "postCmd: " << std::setw(6) << single_raw_time << " (" << std::setw(6) << single_raw_time * ghz << "); ";
+        std::cout << "postCmds: " << std::setw(6) << batched_raw_time << " (" << std::setw(6) << batched_raw_time * ghz << ")" << std::endl;
+        std::cout << std::defaultfloat;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+// Includes
+#include <vector>
+#include <random>
+#include <iomanip>
+#include <iostream>
+#include <algorithm>
+#include <boost/program_options.hpp>
+
+#include <coyote/cBench.hpp>
+#include "mock_thread.hpp"
+
+// Constants
+#define TRANSFER_SIZE 4096
+#define N_INVOKES 1024
+#define MAX_BUFFERS 65536
+
+// Measures n_invokes local writes, to the buffers in the given order; returns the median time per operation, in ns
+double run_bench(mockThread &coyote_thread, const std::vector<coyote::localSg> &sgs, unsigned int n_runs) {
+    auto prep_fn = [&]() {
+        coyote_thread.drainCmds();
+    };
+
+    auto bench_fn = [&]() {
+        for (auto &sg : sgs) {
+            coyote_thread.invoke(coyote::CoyoteOper::LOCAL_WRITE, sg);
+        }
+    };
+
+    coyote::cBench bench(n_runs, n_runs / 10);
+    bench.execute(bench_fn, prep_fn);
+
+    return bench.getP50() / (double) sgs.size();
+}
+
+int main(int argc, char *argv[]) {
+    // CLI arguments
+    unsigned int n_runs;
+
+    boost::program_options::options_description runtime_options("Coyote Perf Software Options");
+    runtime_options.add_options()
+        ("runs,r", boost::program_options::value<unsigned int>(&n_runs)->default_value(1000), "Number of times to repeat the test");
+    boost::program_options::variables_map command_line_arguments;
+    boost::program_options::store(boost::program_options::parse_command_line(argc, argv, runtime_options), command_line_arguments);
+    boost::program_options::notify(command_line_arguments);
+
+    HEADER("CLI PARAMETERS:");
+    std::cout << "Number of test runs: " << n_runs << std::endl;
+
+    coyote::fpgaCnfg cnfg;
+    cnfg.en_avx = true;
+    cnfg.en_strm = true;
+
+    // Benchmark sweep over the number of mapped buffers; reported times are per operation
+    HEADER("VALIDATED INVOKE [ns per operation]");
+    std::mt19937 rng(42);
+    for (unsigned int n_buffers = 1; n_buffers <= MAX_BUFFERS; n_buffers *= 16) {
+        // A new Coyote thread for every sweep, so that only n_buffers buffers are mapped
+        mockThread coyote_thread(cnfg);
+
+        // Buffers are recorded as mapped without the driver and never accessed, so they don't have to exist; 
+        // they're separated by gaps, so the lookup can't merge adjacent buffers
+        std::vector<coyote::localSg> buffers;
+        for (unsigned int i = 0; i < n_buffers; i++) {
+            void *vaddr = reinterpret_cast<void*>(0x100000000ULL + 2ULL * i * TRANSFER_SIZE);
+            coyote_thread.trackMapping(vaddr, TRANSFER_SIZE);
+            buffers.push_back({.addr = vaddr, .len = TRANSFER_SIZE});
+        }
+
+        // Every operation targets the same buffer, which is served from the lookup cache of the last matched buffer
+        std::vector<coyote::localSg> same_sgs(N_INVOKES, buffers[n_buffers / 2]);
+
+        // Every operation targets a random buffer, which requires a lookup in the ordered map of mapped buffers
+        std::vector<coyote::localSg> random_sgs;
+        std::uniform_int_distribution<unsigned int> dist(0, n_buffers - 1);
+        for (unsigned int i = 0; i < N_INVOKES; i++) {
+            random_sgs.push_back(buffers[dist(rng)]);
+        }
+
+        coyote_thread.setValidation(false);
+        double unvalidated_time = run_bench(coyote_thread, random_sgs, n_runs);
+
+        coyote_thread.setValidation(true);
+        double same_time = run_bench(coyote_thread, same_sgs, n_runs);
+        double random_time = run_bench(coyote_thread, random_sgs, n_runs);
+
+        std::cout << "Mapped buffers: " << std::setw(6) << n_buffers << "; " << std::fixed << std::setprecision(1);
+        std::cout << "Validation disabled: " << std::setw(6) << unvalidated_time << "; ";
+        std::cout << "Validated, same buffer: " << std::setw(6) << same_time << "; ";
+        std::cout << "Validated, random buffer: " << std::setw(6) << random_time << std::endl;
+        std::cout << std::defaultfloat;
+    }
+
+    return EXIT_SUCCESS;
+}
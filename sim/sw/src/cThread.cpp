@@ -31,7 +31,11 @@
 #include <iostream>
 #include <iomanip>
 
+#include <poll.h>
+#include <unistd.h>
 #include <sys/mman.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
 
 #include <coyote/cThread.hpp>
 #include <coyote/Common.hpp>
@@ -53,6 +57,10 @@ public:
     std::thread out_thread; // Thread running the BinaryOutputReader
     std::thread irq_thread; // Thread handling interrupts
 
+    // Notification ring, filled by the interrupt thread in place of the driver; kept until destruction, since the thread is only joined then
+    std::unique_ptr<notifyRing> notify_ring;
+    std::atomic<bool> notify_ring_en{false};
+
     std::mutex get_csr_mtx;
     std::mutex check_completed_mtx;
 
@@ -94,8 +102,7 @@ public:
 
 cThread::cThread(int32_t vfid, pid_t hpid, uint32_t device, std::function<void(int)> uisr):
   hpid(hpid), vfid(vfid),
-  vlock(boost::interprocess::open_or_create, ("vpga_mtx_user_" + std::to_string(std::time(nullptr))).c_str()),
-  additional_state(std::make_unique<AdditionalState>()) { // Timestamp for plock to prevent multiple users aquiring the same lock at the same time which does not matter for the simulation, only for hardware
+  additional_state(std::make_unique<AdditionalState>()) {
     auto raw_sim_dir = std::getenv("COYOTE_SIM_DIR");
     if (raw_sim_dir == nullptr) {
         FATAL("you must set the COYOTE_SIM_DIR environment variable to the directory "
@@ -180,7 +187,16 @@ cThread::cThread(int32_t vfid, pid_t hpid, uint32_t device, std::function<void(i
     DEBUG("Constructor(" << vfid << ", " << hpid << ") finished")
 }
 
+cThread::cThread(const fpgaCnfg &cnfg, int32_t ctid) {
+    FATAL("cThread without a vFPGA not implemented in simulation target")
+    std::terminate();
+}
+
 cThread::~cThread() {
+    // Release recycled buffers and cached registrations before the explicitly mapped buffers
+    recycler.reset();
+    reg_cache.reset();
+
     // Memory: Free the memory and clear the mapped pages 
 	while (!mapped_pages.empty()) {
 		freeMem((*mapped_pages.begin()).first);
@@ -194,12 +210,32 @@ cThread::~cThread() {
 
     if (additional_state->irq_thread.joinable())
         additional_state->irq_thread.join();
+
+    if (notify_efd != -1)
+        close(notify_efd);
 }
 
 void cThread::postCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_t offs_0) {
     // Do nothing because protected function
 }
 
+uint32_t cThread::waitCmdCredits(uint32_t n) {
+    // Do nothing because protected function
+    return n;
+}
+
+void cThread::writeCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_t offs_0) {
+    // Do nothing because protected function
+}
+
+void cThread::postCmds(const std::vector<std::array<uint64_t, 4>> &cmds) {
+    // Do nothing because protected function
+}
+
+void cThread::mmapCtrl() const {
+    // Do nothing because protected function
+}
+
 void cThread::mmapFpga() {
     // Do nothing because protected function
 }
@@ -212,13 +248,147 @@ void cThread::userMap(void *vaddr, uint64_t len, int32_t mem_block) {
     if (mem_block != -1) {
         WARNING("Non-default values for mem_block " << mem_block << "are currently ignored");
     }
+    if (reg_cache) {
+        reg_cache->invalidate(vaddr, len);
+    }
+
+    mapHostMem(vaddr, len, mem_block);
+    trackMapping(vaddr, len);
+
+    if (reg_cache) {
+        reg_cache->insertPinned(vaddr, len);
+    }
+}
+
+void cThread::userUnmap(void *vaddr) {
+    untrackMapping(vaddr);
+
+    if (reg_cache) {
+        reg_cache->removePinned(vaddr);
+    }
+
+    unmapHostMem(vaddr);
+}
+
+std::vector<int> cThread::mapHostMemBatch(const std::vector<mapRange> &ranges) const {
+    for (auto &range : ranges) {
+        additional_state->tlb_pages.emplace(range.vaddr, range.len);
+        additional_state->executeUnlessCrash([&] { 
+            additional_state->input_writer.userMap(reinterpret_cast<uint64_t>(range.vaddr), range.len);
+        });
+    }
+    return std::vector<int>(ranges.size(), 0);
+}
+
+void cThread::unmapHostMemBatch(const std::vector<void*> &vaddrs) {
+    for (void *vaddr : vaddrs) {
+        unmapHostMem(vaddr);
+    }
+}
+
+void cThread::finishMapBatch(const std::vector<mapRange> &ranges, const std::vector<int> &codes) {
+    for (auto &range : ranges) {
+        trackMapping(range.vaddr, range.len);
+        if (reg_cache) {
+            reg_cache->insertPinned(range.vaddr, range.len);
+        }
+    }
+}
+
+void cThread::userMapBatch(const std::vector<mapRange> &ranges) {
+    for (auto &range : ranges) {
+        userMap(range.vaddr, range.len, range.mem_block);
+    }
+}
+
+mapHandle cThread::userMapAsync(std::vector<mapRange> ranges) {
+    // The simulation input writer isn't thread-safe, so the buffers are mapped synchronously
+    userMapBatch(ranges);
+    return mapHandle{};
+}
+
+bool cThread::waitMap(mapHandle handle, std::chrono::nanoseconds timeout) {
+    return true;
+}
+
+void cThread::userUnmapBatch(const std::vector<void*> &vaddrs) {
+    for (void *vaddr : vaddrs) {
+        userUnmap(vaddr);
+    }
+}
+
+void cThread::trackMapping(void *vaddr, uint64_t len) {
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr);
+    auto it = mapped_ranges.find(start);
+    if (it == mapped_ranges.end() || it->second < start + len) {
+        mapped_ranges[start] = start + len;
+    }
+}
+
+void cThread::untrackMapping(void *vaddr) {
+    mapped_ranges.erase(reinterpret_cast<uint64_t>(vaddr));
+    last_mapped_start = last_mapped_end = 0;
+}
+
+bool cThread::isMapped(const void *vaddr, uint64_t len) const {
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr);
+    uint64_t end = start + len;
+
+    // Fast path: consecutive operations typically target the same buffer
+    if (start >= last_mapped_start && end <= last_mapped_end) {
+        return true;
+    }
+
+    // Find the range with the closest start address before the buffer, then follow adjacent or overlapping ranges until the buffer is covered
+    auto it = mapped_ranges.upper_bound(start);
+    if (it == mapped_ranges.begin()) {
+        return false;
+    }
+    it--;
+
+    uint64_t range_start = it->first;
+    uint64_t covered = start;
+    while (it != mapped_ranges.end() && it->first <= covered) {
+        covered = std::max(covered, it->second);
+        if (covered >= end) {
+            last_mapped_start = range_start;
+            last_mapped_end = covered;
+            return true;
+        }
+        it++;
+    }
+    
+    return false;
+}
+
+void cThread::setValidation(bool en) {
+    DEBUG("cThread: Setting invoke validation to " << en)
+    validate_sg = en;
+}
+
+void cThread::setMultiProducer(bool en) {
+    DEBUG("cThread: Setting multi-producer mode to " << en)
+    std::lock_guard<std::recursive_mutex> guard(submit_lock);
+    multi_producer = en;
+}
+
+void cThread::checkMapped(const void *vaddr, uint64_t len) const {
+    if (!isMapped(vaddr, len)) {
+        throw std::runtime_error(
+            "ERROR: cThread::invoke() - buffer at vaddr " + std::to_string(reinterpret_cast<uint64_t>(vaddr)) + 
+            " with length " + std::to_string(len) + " is not mapped; use userMap() or getMem(), exiting..."
+        );
+    }
+}
+
+void cThread::mapHostMem(void *vaddr, uint64_t len, int32_t mem_block) {
     additional_state->tlb_pages.emplace(vaddr, len);
     additional_state->executeUnlessCrash([&] { 
         additional_state->input_writer.userMap(reinterpret_cast<uint64_t>(vaddr), len);
     });
 }
 
-void cThread::userUnmap(void *vaddr) {
+void cThread::unmapHostMem(void *vaddr) {
     auto status = additional_state->tlb_pages.erase(vaddr);
     if (status < 1) {
         ERROR("Tried to userUnmap non-existent page at vaddr " << vaddr)
@@ -235,6 +405,19 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
 
     // Only continue with the operation if the cs_alloc-struct has a size > 0 so that actual memory needs to be allocated 
 	if(alloc.size > 0) {
+        // Recycled buffers are still mapped; only the book-keeping of userMap is repeated
+        mem = recycler ? recycler->get(alloc) : nullptr;
+        if (mem) {
+            trackMapping(mem, alloc.size);
+            if (reg_cache) {
+                reg_cache->insertPinned(mem, alloc.size);
+            }
+
+            mapped_pages.emplace(mem, alloc);
+            DEBUG("getMem(" << alloc.size << ") reused recycled memory at " << std::hex << reinterpret_cast<uint64_t>(mem) << std::dec)
+            return mem;
+        }
+
 		switch (alloc.alloc) { // Further steps depend on the allocation type that is selected in the allocation struct 
             // Regular allocation 
 			case CoyoteAllocType::REG : {
@@ -253,8 +436,9 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
 
                 break;
             }
-            case CoyoteAllocType::HPF : {
-                mem = mmap(NULL, alloc.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            case CoyoteAllocType::HPF : case CoyoteAllocType::HPF_1G : {
+                int huge_flag = (alloc.alloc == CoyoteAllocType::HPF_1G) ? (HUGE_PAGE_1G_SHIFT << MAP_HUGE_SHIFT) : 0;
+                mem = mmap(NULL, alloc.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_flag, -1, 0);
                 if (mem == MAP_FAILED) {
                     FATAL("Cannot obtain huge pages with mmap")
                     std::terminate();
@@ -276,20 +460,53 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
 	return mem;
 }
 
+double cThread::getHugePageFraction(const void *vaddr, uint64_t len) const {
+    WARNING("Huge page verification is not implemented in simulation target")
+    return 0.0;
+}
+
+void cThread::releaseHostAlloc(void *vaddr, const CoyoteAlloc &alloc) {
+    switch (alloc.alloc) {
+        case CoyoteAllocType::REG: case CoyoteAllocType::THP: {
+            free(vaddr);
+            break;
+        }
+        case CoyoteAllocType::HPF: case CoyoteAllocType::HPF_1G: {
+            munmap(vaddr, alloc.size);
+            break;
+        }
+        default: break;
+    }
+}
+
+void cThread::releaseRecycled(const std::vector<std::pair<void*, CoyoteAlloc>> &buffs) {
+    for (auto &buff : buffs) {
+        unmapHostMem(buff.first);
+        releaseHostAlloc(buff.first, buff.second);
+    }
+}
+
 void cThread::freeMem(void* vaddr) {
 	if (mapped_pages.find(vaddr) != mapped_pages.end()) {
 		auto mapped = mapped_pages[vaddr];
 		
 		switch (mapped.alloc) {
-            case CoyoteAllocType::REG: case CoyoteAllocType::THP: {
-                userUnmap(vaddr);
-                free(vaddr);
+            case CoyoteAllocType::REG: case CoyoteAllocType::THP: case CoyoteAllocType::HPF: case CoyoteAllocType::HPF_1G: {
+                if (recycler) {
+                    untrackMapping(vaddr);
+                    if (reg_cache) {
+                        reg_cache->removePinned(vaddr);
+                    }
+
+                    if (!recycler->put(vaddr, mapped)) {
+                        unmapHostMem(vaddr);
+                        releaseHostAlloc(vaddr, mapped);
+                    }
+                    break;
+                }
 
-                break;
-            }
-            case CoyoteAllocType::HPF: {
                 userUnmap(vaddr);
-                munmap(vaddr, mapped.size);
+                releaseHostAlloc(vaddr, mapped);
 
                 break;
             }
@@ -301,6 +518,59 @@ void cThread::freeMem(void* vaddr) {
     DEBUG("freeMem(" << reinterpret_cast<uint64_t>(vaddr) << ") finished")
 }
 
+void cThread::enableRegCache(uint64_t budget) {
+    DEBUG("cThread: Enabling registration cache with budget " << budget)
+
+    reg_cache = std::make_unique<cRegCache>(
+        budget,
+        [this](void *vaddr, uint64_t len) { mapHostMem(vaddr, len, -1); },
+        [this](void *vaddr) { unmapHostMem(vaddr); },
+        [this](const cmdTicket &ticket) { return isDone(ticket); }
+    );
+
+    for (auto &mapped : mapped_pages) {
+        reg_cache->insertPinned(mapped.first, mapped.second.size);
+    }
+}
+
+void cThread::disableRegCache() {
+    reg_cache.reset();
+}
+
+void cThread::invalidateRegCache(void *vaddr, uint64_t len) {
+    if (reg_cache) {
+        reg_cache->invalidate(vaddr, len);
+    }
+}
+
+regCacheStats cThread::getRegCacheStats() const {
+    return reg_cache ? reg_cache->getStats() : regCacheStats{};
+}
+
+void cThread::enableRecycling(uint64_t budget, std::chrono::nanoseconds idle_timeout) {
+    DEBUG("cThread: Enabling buffer recycling with budget " << budget)
+
+    recycler.reset();
+    recycler = std::make_unique<cRecycler>(
+        budget, idle_timeout,
+        [this](const std::vector<std::pair<void*, CoyoteAlloc>> &buffs) { releaseRecycled(buffs); }
+    );
+}
+
+void cThread::disableRecycling() {
+    recycler.reset();
+}
+
+void cThread::trimRecycled() {
+    if (recycler) {
+        recycler->trim();
+    }
+}
+
+recycleStats cThread::getRecycleStats() const {
+    return recycler ? recycler->getStats() : recycleStats{};
+}
+
 void cThread::setCSR(uint64_t val, uint32_t offs) {
     additional_state->executeUnlessCrash([&] { 
         additional_state->input_writer.setCSR(offs, val);
@@ -368,7 +638,7 @@ void cThread::invoke(CoyoteOper oper, syncSg sg) {
     DEBUG("invoke(...) finished")
 }
 
-void cThread::invoke(CoyoteOper oper, localSg sg, bool last) {
+cmdTicket cThread::invoke(CoyoteOper oper, localSg sg, bool last) {
     // Argument checks
     DEBUG("cThread: Call invoke for a one-side local operation with address " << sg.addr << ", length " << sg.len)
 
@@ -376,10 +646,24 @@ void cThread::invoke(CoyoteOper oper, localSg sg, bool last) {
         throw std::runtime_error("ERROR: cThread::invoke() called with localSg flags, but the operation is not a LOCAL_READ or LOCAL_WRITE; exiting...");
     }
 
+    // Held across the chunks of a large transfer, so they are submitted contiguously in multi-producer mode
+    auto submission = lockSubmission();
+
+    // Large transfers are split into chunks, of which only the final one carries last
     if (sg.len > MAX_TRANSFER_SIZE) {
-        throw std::runtime_error("ERROR: cThread::invoke() - transfers over 128MB are currently not supported in Coyote, exiting...");
+        while (sg.len > MAX_TRANSFER_SIZE) {
+            localSg chunk = sg;
+            chunk.len = MAX_TRANSFER_SIZE;
+            invoke(oper, chunk, false);
+
+            sg.addr = (void*) ((uint64_t) sg.addr + MAX_TRANSFER_SIZE);
+            sg.len -= MAX_TRANSFER_SIZE;
+        }
+        return invoke(oper, sg, last);
     }
 
+    prepareBuffer(sg.addr, sg.len);
+
     // Trigger the operation
     if (isLocalRead(oper)) {
         additional_state->executeUnlessCrash([&] {
@@ -411,9 +695,24 @@ void cThread::invoke(CoyoteOper oper, localSg sg, bool last) {
     }
 
     DEBUG("invoke(...) finished")
+    return holdBuffers(issueTicket(oper, last));
 }
 
-void cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last) {
+cmdTicket cThread::invoke(CoyoteOper oper, const std::vector<localSg> &sgs, bool last) {
+    if (oper != CoyoteOper::LOCAL_READ && oper != CoyoteOper::LOCAL_WRITE) {
+        throw std::runtime_error("ERROR: cThread::invoke() called with a batch of localSg flags, but the operation is not a LOCAL_READ or LOCAL_WRITE; exiting...");
+    }
+
+    // The simulation has no command FIFO to batch into, so the entries are simply forwarded one-by-one
+    auto submission = lockSubmission();
+    cmdTicket ticket;
+    for (size_t i = 0; i < sgs.size(); i++) {
+        ticket = invoke(oper, sgs[i], last && (i == sgs.size() - 1));
+    }
+    return ticket;
+}
+
+cmdTicket cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last) {
     // Argument checks
     DEBUG(
         "cThread: Call invoke for a two-sided local operation with source address " 
@@ -425,10 +724,30 @@ void cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last)
         throw std::runtime_error("ERROR: cThread::invoke() called with two localSg flags, but the operation is not a LOCAL_TRANSFER; exiting...");
     }
 
-    if (src_sg.len > MAX_TRANSFER_SIZE || dst_sg.len > MAX_TRANSFER_SIZE) {
-        throw std::runtime_error("ERROR: cThread::invoke() - transfers over 128MB are currently not supported in Coyote, exiting...");
+    if ((src_sg.len > MAX_TRANSFER_SIZE || dst_sg.len > MAX_TRANSFER_SIZE) && src_sg.len != dst_sg.len) {
+        throw std::runtime_error("ERROR: cThread::invoke() - transfers over 128MB require equal source and destination lengths, exiting...");
     }
 
+    auto submission = lockSubmission();
+
+    // Large transfers are split into paired chunks, of which only the final one carries last
+    if (src_sg.len > MAX_TRANSFER_SIZE) {
+        while (src_sg.len > MAX_TRANSFER_SIZE) {
+            localSg src_chunk = src_sg, dst_chunk = dst_sg;
+            src_chunk.len = dst_chunk.len = MAX_TRANSFER_SIZE;
+            invoke(oper, src_chunk, dst_chunk, false);
+
+            src_sg.addr = (void*) ((uint64_t) src_sg.addr + MAX_TRANSFER_SIZE);
+            dst_sg.addr = (void*) ((uint64_t) dst_sg.addr + MAX_TRANSFER_SIZE);
+            src_sg.len -= MAX_TRANSFER_SIZE;
+            dst_sg.len -= MAX_TRANSFER_SIZE;
+        }
+        return invoke(oper, src_sg, dst_sg, last);
+    }
+
+    prepareBuffer(src_sg.addr, src_sg.len);
+    prepareBuffer(dst_sg.addr, dst_sg.len);
+
     // Trigger the operation
     additional_state->executeUnlessCrash([&] {
         additional_state->input_writer.writeMem(
@@ -455,16 +774,85 @@ void cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last)
             last
         );
     });
+    return holdBuffers(issueTicket(oper, last));
 }
 
-void cThread::invoke(CoyoteOper oper, rdmaSg sg, bool last) {
+cmdTicket cThread::invoke(CoyoteOper oper, rdmaSg sg, bool last) {
     ASSERT("Networking not implemented in simulation target!")
+    return {};
+}
+
+cmdTicket cThread::invoke(CoyoteOper oper, const std::vector<rdmaSg> &sgs, bool last) {
+    ASSERT("Networking not implemented in simulation target!")
+    return {};
 }
 
 void cThread::invoke(CoyoteOper oper, tcpSg sg, bool last) {
     ASSERT("Networking not implemented in simulation target!")
 }
 
+cCmdTemplate cThread::prepareCmd(CoyoteOper oper, localSg sg, bool last) {
+    if (oper != CoyoteOper::LOCAL_READ && oper != CoyoteOper::LOCAL_WRITE) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called with localSg flags, but the operation is not a LOCAL_READ or LOCAL_WRITE; exiting...");
+    }
+
+    if (sg.len > MAX_TRANSFER_SIZE) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() - transfers over 128MB can't be posted as a single command, exiting...");
+    }
+
+    return cCmdTemplate(oper, last, ctid, localCmd(oper, ctid, sg, last), oper == CoyoteOper::LOCAL_READ, oper == CoyoteOper::LOCAL_WRITE);
+}
+
+cCmdTemplate cThread::prepareCmd(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last) {
+    if (oper != CoyoteOper::LOCAL_TRANSFER) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called with two localSg flags, but the operation is not a LOCAL_TRANSFER; exiting...");
+    }
+
+    if (src_sg.len > MAX_TRANSFER_SIZE || dst_sg.len > MAX_TRANSFER_SIZE) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() - transfers over 128MB can't be posted as a single command, exiting...");
+    }
+
+    std::array<uint64_t, 4> cmd = {
+        reinterpret_cast<uint64_t>(dst_sg.addr), localCtrlCmd(ctid, dst_sg, last),
+        reinterpret_cast<uint64_t>(src_sg.addr), localCtrlCmd(ctid, src_sg, last)
+    };
+    return cCmdTemplate(oper, last, ctid, cmd, true, true);
+}
+
+cCmdTemplate cThread::prepareCmd(CoyoteOper oper, rdmaSg sg, bool last) {
+    ASSERT("Networking not implemented in simulation target!")
+    return {};
+}
+
+cmdTicket cThread::post(const cCmdTemplate &tmpl) {
+    if (tmpl.ctid != ctid) {
+        throw std::runtime_error("ERROR: cThread::post() - the command was prepared by a different cThread, exiting...");
+    }
+
+    if (isRemoteRdma(tmpl.oper)) {
+        ASSERT("Networking not implemented in simulation target!")
+        return {};
+    }
+
+    // The simulation takes scatter-gather entries rather than encoded commands, so the template is decoded again
+    auto decode = [](uint64_t addr, uint64_t ctrl) {
+        localSg sg;
+        sg.addr = (void*) addr;
+        sg.len = (ctrl >> CTRL_LEN_OFFS) & CTRL_LEN_MASK;
+        sg.stream = (ctrl >> CTRL_STRM_OFFS) & CTRL_STRM_MASK;
+        sg.dest = (ctrl >> CTRL_DEST_OFFS) & CTRL_DEST_MASK;
+        return sg;
+    };
+
+    if (tmpl.has_src && tmpl.has_dst) {
+        return invoke(tmpl.oper, decode(tmpl.cmd[2], tmpl.cmd[3]), decode(tmpl.cmd[0], tmpl.cmd[1]), tmpl.last);
+    } else if (tmpl.has_src) {
+        return invoke(tmpl.oper, decode(tmpl.cmd[2], tmpl.cmd[3]), tmpl.last);
+    } else {
+        return invoke(tmpl.oper, decode(tmpl.cmd[0], tmpl.cmd[1]), tmpl.last);
+    }
+}
+
 uint32_t cThread::checkCompleted(CoyoteOper oper) const {
     if (isRemoteRdma(oper)) {ASSERT("Networking not implemented in simulation target!")}
     if (isRemoteTcp(oper)) {ASSERT("Networking not implemented in simulation target!")}
@@ -483,13 +871,196 @@ uint32_t cThread::checkCompleted(CoyoteOper oper) const {
     return result;
 }
 
+uint32_t cThread::checkCompleted(CoyoteOper oper, int32_t qp_id) const {
+    return checkCompleted(oper);
+}
+
+cmdTicket cThread::issueTicket(CoyoteOper oper, bool last, int32_t qp_id) {
+    // Only local operations are supported in simulation; LOCAL_TRANSFER completes on the write side
+    uint32_t *issued;
+    if (isLocalWrite(oper)) {
+        issued = &cmpl_issued[WR_WBACK];
+    } else if (isLocalRead(oper)) {
+        issued = &cmpl_issued[RD_WBACK];
+    } else {
+        return {};
+    }
+
+    if (!last) {
+        return {oper, *issued + 1};
+    }
+
+    if (oper == CoyoteOper::LOCAL_TRANSFER) {
+        cmpl_issued[RD_WBACK]++;
+    }
+    return {oper, ++(*issued)};
+}
+
+bool cThread::isDone(cmdTicket ticket) const {
+    return static_cast<int32_t>(checkCompleted(ticket.oper) - ticket.seq) >= 0;
+}
+
+bool cThread::wait(cmdTicket ticket, std::chrono::nanoseconds timeout, waitPolicy policy, waitStats *stats) const {
+    return waitCompleted(ticket.oper, ticket.seq, timeout, policy, stats, ticket.qp_id);
+}
+
+bool cThread::waitCompleted(CoyoteOper oper, uint32_t target, std::chrono::nanoseconds timeout, waitPolicy policy, waitStats *stats, int32_t qp_id) const {
+    // Every poll is a round-trip to the simulation, so there is no need to back off; the wait policy is ignored
+    auto start = std::chrono::steady_clock::now();
+    uint64_t n_polls = 0;
+    bool done = false;
+
+    while (true) {
+        n_polls++;
+        if (static_cast<int32_t>(checkCompleted(oper) - target) >= 0) {
+            done = true;
+            break;
+        }
+        if (std::chrono::steady_clock::now() - start >= timeout) {
+            break;
+        }
+    }
+
+    if (stats) {
+        stats->n_polls = n_polls;
+        stats->elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    }
+    DEBUG("waitCompleted(" << target << ") finished")
+    return done;
+}
+
 void cThread::clearCompleted() {
+    for (uint32_t i = 0; i < N_WBACKS; i++) {
+        cmpl_issued[i] = 0;
+    }
+
     additional_state->executeUnlessCrash([&] { 
         additional_state->input_writer.clearCompleted();
     });
+
+    if (reg_cache) {
+        reg_cache->releaseAll();
+    }
+    n_clears.fetch_add(1, std::memory_order_release);
     DEBUG("clearCompleted() finished")
 }
 
+uint32_t cThread::getClearCount() const {
+    return n_clears.load(std::memory_order_acquire);
+}
+
+void cThread::enableNotifyRing() {
+    if (notify_ring) {
+        return;
+    }
+
+    // Without a driver, the interrupt thread appends notifications to the ring; it's started on the first call
+    if (!additional_state->notify_ring) {
+        if (additional_state->irq_thread.joinable()) {
+            throw std::runtime_error("ERROR: cThread::enableNotifyRing() - a user interrupt service routine is already registered, exiting...");
+        }
+
+        notify_efd = eventfd(0, EFD_NONBLOCK);
+        if (notify_efd == -1) {
+            throw std::runtime_error("ERROR: cThread could not create eventfd");
+        }
+
+        additional_state->notify_ring = std::make_unique<notifyRing>();
+        additional_state->irq_thread = std::thread([this] {
+            notifyRing *ring = additional_state->notify_ring.get();
+            uint32_t value;
+            while (additional_state->output_reader.getNextIRQ(value)) {
+                if (!additional_state->notify_ring_en) {
+                    DEBUG("Dropped notification because the notification ring is disabled")
+                    continue;
+                }
+
+                uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+                if (tail - ring->head.load(std::memory_order_acquire) >= NOTIFY_RING_SIZE) {
+                    ring->dropped.fetch_add(1, std::memory_order_relaxed);
+                } else {
+                    ring->values[tail & (NOTIFY_RING_SIZE - 1)] = value;
+                    ring->tail.store(tail + 1, std::memory_order_release);
+                }
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (ring->waiting.load(std::memory_order_relaxed)) {
+                    eventfd_write(notify_efd, 1);
+                }
+            }
+            DEBUG("Interrupt queue was stopped. Cannot continue interrupt handler thread!")
+        });
+    }
+
+    notifyRing *ring = additional_state->notify_ring.get();
+    ring->head.store(ring->tail.load());
+    additional_state->notify_ring_en = true;
+    notify_ring = ring;
+}
+
+void cThread::disableNotifyRing() {
+    additional_state->notify_ring_en = false;
+    notify_ring = nullptr;
+}
+
+bool cThread::pollNotification(int32_t &value) {
+    if (!notify_ring) {
+        throw std::runtime_error("ERROR: cThread::pollNotification() - notification ring not enabled, use enableNotifyRing(), exiting...");
+    }
+
+    uint32_t head = notify_ring->head.load(std::memory_order_relaxed);
+    if (head == notify_ring->tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    value = notify_ring->values[head & (NOTIFY_RING_SIZE - 1)];
+    notify_ring->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool cThread::waitNotification(int32_t &value, int timeout_ms) {
+    if (pollNotification(value)) {
+        return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        notify_ring->waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (pollNotification(value)) {
+            notify_ring->waiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        int remaining_ms = -1;
+        if (timeout_ms >= 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            remaining_ms = remaining > 0 ? (int) remaining : 0;
+        }
+
+        struct pollfd pfd = { notify_efd, POLLIN, 0 };
+        int ret_val = poll(&pfd, 1, remaining_ms);
+        notify_ring->waiting.store(0, std::memory_order_relaxed);
+
+        if (ret_val > 0) {
+            eventfd_t cnt;
+            eventfd_read(notify_efd, &cnt);
+        } else if (ret_val == 0) {
+            return pollNotification(value);
+        } else if (errno != EINTR) {
+            throw std::runtime_error("ERROR: cThread::waitNotification() - eventfd poll failed");
+        }
+
+        if (pollNotification(value)) {
+            return true;
+        }
+    }
+}
+
+uint32_t cThread::getDroppedNotifications() const {
+    return notify_ring ? notify_ring->dropped.load(std::memory_order_relaxed) : 0;
+}
+
 void cThread::doArpLookup(uint32_t ip_addr) {
     ASSERT("Networking not implemented in simulation target")
 }
@@ -497,6 +1068,10 @@ void cThread::doArpLookup(uint32_t ip_addr) {
 void cThread::writeQpContext(uint32_t port) {
     ASSERT("Networking not implemented in simulation target")
 }
+
+void cThread::writeQpContext(const ibvQp &qp, uint32_t port) {
+    ASSERT("Networking not implemented in simulation target")
+}
  
 uint32_t cThread::readAck() {
     ASSERT("Networking not implemented in simulation target")
@@ -520,6 +1095,28 @@ void cThread::closeConn() {
     ASSERT("Networking not implemented in simulation target")
 }
 
+int32_t cThread::createQp(void *mem, uint64_t size) {
+    ASSERT("Networking not implemented in simulation target")
+    return {};
+}
+
+void cThread::connectQp(int32_t qp_id, const ibvQ &remote, uint16_t port) {
+    ASSERT("Networking not implemented in simulation target")
+}
+
+void cThread::destroyQp(int32_t qp_id) {
+    ASSERT("Networking not implemented in simulation target")
+}
+
+qpEntry* cThread::findQp(int32_t qp_id) const {
+    // Do nothing because protected function
+    return nullptr;
+}
+
+void cThread::clearCounters(int32_t target_ctid) {
+    // Do nothing because protected function
+}
+
 void cThread::lock() {
     ASSERT("Scheduling not implemented in simulation target")
 }
@@ -534,7 +1131,73 @@ int32_t cThread::getCtid() const { return ctid; };
 
 pid_t  cThread::getHpid() const { return hpid; };
 
-ibvQp* cThread::getQpair() const { return qpair.get(); }
+ibvQp* cThread::getQpair(int32_t qp_id) const { return qpair.get(); }
+
+int32_t cThread::getNumaNode() const { return numa_node; }
+
+startupStats cThread::getStartupStats() const { return startup_stats; }
+
+void cThread::invalidateShellCnfg() {
+    // Do nothing, since the simulation doesn't cache the shell configuration
+}
+
+void cThread::reset() {
+    disableNotifyRing();
+
+    // Release recycled buffers and cached registrations before the explicitly mapped buffers, and restore the default settings
+    recycler.reset();
+    reg_cache.reset();
+    setMultiProducer(false);
+    validate_sg = false;
+
+    while (!mapped_pages.empty()) {
+        freeMem(mapped_pages.begin()->first);
+    }
+
+    while (!mapped_ranges.empty()) {
+        userUnmap(reinterpret_cast<void*>(mapped_ranges.begin()->first));
+    }
+
+    clearCompleted();
+}
+
+uint64_t cThread::getPageSize() const { return fcnfg.getPageSize(); }
+
+uint64_t cThread::getHugePageSize() const { return fcnfg.getHugePageSize(); }
+
+std::map<int32_t, uint64_t> cThread::getMemNodes(const void *vaddr, uint64_t len) const {
+    std::map<int32_t, uint64_t> nodes;
+    if (len == 0) {
+        return nodes;
+    }
+
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr) & ~(PAGE_SIZE - 1);
+    uint64_t end = reinterpret_cast<uint64_t>(vaddr) + len;
+    
+    // Query the pages in batches; move_pages without target nodes only reports the current node of each page
+    constexpr uint64_t BATCH = 1024;
+    void *pages[BATCH];
+    int status[BATCH];
+
+    for (uint64_t addr = start; addr < end;) {
+        uint64_t n = 0;
+        for (; n < BATCH && addr + n * PAGE_SIZE < end; n++) {
+            pages[n] = reinterpret_cast<void*>(addr + n * PAGE_SIZE);
+        }
+
+        if (syscall(SYS_move_pages, 0, n, pages, NULL, status, 0)) {
+            int err = errno;
+            throw std::runtime_error("ERROR: cThread::getMemNodes() - move_pages failed: " + std::string(strerror(err)));
+        }
+
+        for (uint64_t i = 0; i < n; i++) {
+            nodes[status[i] >= 0 ? status[i] : -1] += PAGE_SIZE;
+        }
+        addr += n * PAGE_SIZE;
+    }
+
+    return nodes;
+}
 
 void cThread::printDebug() const {
     std::cout << std::setw(35) << "Sent local reads: \t-" << std::endl;
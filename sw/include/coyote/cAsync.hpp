@@ -0,0 +1,124 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CASYNC_HPP_
+#define _COYOTE_CASYNC_HPP_
+
+#include <coyote/cOps.hpp>
+#include <coyote/cThread.hpp>
+#include <coyote/cPoller.hpp>
+
+/*
+ * Coroutine awaitables require C++20; the rest of Coyote is built as C++17, 
+ * so this header is empty unless the including translation unit is compiled with coroutine support.
+ */
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+
+namespace coyote {
+
+namespace async {
+
+/**
+ * @brief Awaitable for a single Coyote operation
+ *
+ * The operation is invoked eagerly, when the awaitable is created. Awaiting it checks
+ * whether the operation has already completed; if not, the coroutine is suspended and 
+ * registered with a cPoller, which resumes it from cPoller::poll(), once the operation completes.
+ */
+class cmdAwaitable {
+
+private:
+    cThread &thread;
+    cPoller &poller;
+    cmdTicket ticket;
+
+public:
+    cmdAwaitable(cThread &thread, cPoller &poller, cmdTicket ticket) : thread(thread), poller(poller), ticket(ticket) {}
+
+    bool await_ready() const { return thread.isDone(ticket); }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        poller.enqueue(thread, ticket, [](void *ctx) { std::coroutine_handle<>::from_address(ctx).resume(); }, handle.address());
+    }
+
+    void await_resume() const {}
+
+    /// Returns the completion ticket of the underlying operation
+    cmdTicket getTicket() const { return ticket; }
+};
+
+/**
+ * @brief Coroutine-friendly wrapper around a cThread
+ *
+ * Each of the functions invokes the corresponding operation on the cThread and returns an awaitable, e.g.:
+ * 
+ *   co_await athread.read(sg);
+ * 
+ * Coroutines are resumed by the thread driving the cPoller (i.e., calling poll() or drain()), 
+ * so a single thread can serve many outstanding operations across many cThreads.
+ *
+ * @note The cThread and cPoller must outlive all outstanding awaitables.
+ */
+class cAsyncThread {
+
+private:
+    cThread &thread;
+    cPoller &poller;
+
+public:
+    cAsyncThread(cThread &thread, cPoller &poller) : thread(thread), poller(poller) {}
+
+    /// Equivalent to cThread::invoke(CoyoteOper::LOCAL_READ, sg)
+    cmdAwaitable read(localSg sg) { return {thread, poller, thread.invoke(CoyoteOper::LOCAL_READ, sg)}; }
+
+    /// Equivalent to cThread::invoke(CoyoteOper::LOCAL_WRITE, sg)
+    cmdAwaitable write(localSg sg) { return {thread, poller, thread.invoke(CoyoteOper::LOCAL_WRITE, sg)}; }
+
+    /// Equivalent to cThread::invoke(CoyoteOper::LOCAL_TRANSFER, src_sg, dst_sg)
+    cmdAwaitable transfer(localSg src_sg, localSg dst_sg) { return {thread, poller, thread.invoke(CoyoteOper::LOCAL_TRANSFER, src_sg, dst_sg)}; }
+
+    /// Equivalent to cThread::invoke(CoyoteOper::REMOTE_RDMA_WRITE, sg)
+    cmdAwaitable rdmaWrite(rdmaSg sg) { return {thread, poller, thread.invoke(CoyoteOper::REMOTE_RDMA_WRITE, sg)}; }
+
+    /// Equivalent to cThread::invoke(CoyoteOper::REMOTE_RDMA_READ, sg)
+    cmdAwaitable rdmaRead(rdmaSg sg) { return {thread, poller, thread.invoke(CoyoteOper::REMOTE_RDMA_READ, sg)}; }
+
+    /// Equivalent to cThread::invoke(CoyoteOper::REMOTE_RDMA_SEND, sg)
+    cmdAwaitable rdmaSend(rdmaSg sg) { return {thread, poller, thread.invoke(CoyoteOper::REMOTE_RDMA_SEND, sg)}; }
+
+    /// Returns the underlying cThread
+    cThread& getThread() { return thread; }
+};
+
+}
+
+}
+
+#endif // __cpp_impl_coroutine
+
+#endif // _COYOTE_CASYNC_HPP_
@@ -0,0 +1,144 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CCMDTEMPLATE_HPP_
+#define _COYOTE_CCMDTEMPLATE_HPP_
+
+#include <array>
+#include <stdexcept>
+
+#include <coyote/cOps.hpp>
+
+namespace coyote {
+
+/**
+ * @brief A pre-encoded command, for transfers of the same shape that are issued repeatedly
+ *
+ * Created with cThread::prepareCmd(), which validates the operation and encodes the control words once;
+ * cThread::post() then writes the stored command to the vFPGA, without any re-encoding or re-validation. 
+ * The address and length can be patched in-place between posts, which only updates the affected fields.
+ *
+ * @note A template can only be posted through the cThread that prepared it
+ */
+class cCmdTemplate {
+    friend class cThread;
+
+private:
+    /// Operation; determines the completion counter of the issued tickets
+    CoyoteOper oper = { CoyoteOper::NOOP };
+
+    /// Whether the command was encoded with last set
+    bool last = { true };
+
+    /// Coyote thread ID of the cThread (or, for RDMA operations, of the queue pair) that prepared the command
+    int32_t ctid = { -1 };
+
+    /// Queue pair of RDMA operations, see cThread::createQp(); 0 for the default QP and local operations
+    int32_t qp_id = { 0 };
+
+    /// Encoded command, in the argument order of cThread::postCmd(): destination address and control, source address and control
+    std::array<uint64_t, 4> cmd = { 0, 0, 0, 0 };
+
+    /// Which halves of the command describe a transfer; e.g., LOCAL_READ only has a source
+    bool has_src = { false };
+    bool has_dst = { false };
+
+    static constexpr uint64_t LEN_FIELD = static_cast<uint64_t>(CTRL_LEN_MASK) << CTRL_LEN_OFFS;
+
+    cCmdTemplate(CoyoteOper oper, bool last, int32_t ctid, const std::array<uint64_t, 4> &cmd, bool has_src, bool has_dst, int32_t qp_id = 0):
+        oper(oper), last(last), ctid(ctid), qp_id(qp_id), cmd(cmd), has_src(has_src), has_dst(has_dst) {}
+
+public:
+    cCmdTemplate() = default;
+
+    /// Getter: operation
+    CoyoteOper getOper() const { return oper; }
+
+    /// Getter: whether the command is posted with last set
+    bool isLast() const { return last; }
+
+    /// Getter: Coyote thread ID of the cThread (or, for RDMA operations, of the queue pair) that prepared the command
+    int32_t getCtid() const { return ctid; }
+
+    /// Getter: queue pair of RDMA operations
+    int32_t getQpId() const { return qp_id; }
+
+    /// Getter: encoded command, in the argument order of cThread::postCmd()
+    const std::array<uint64_t, 4>& getCmd() const { return cmd; }
+
+    /// Getter: source address (or 0, if the command has no source)
+    uint64_t getSrcAddr() const { return cmd[2]; }
+
+    /// Getter: destination address (or 0, if the command has no destination)
+    uint64_t getDstAddr() const { return cmd[0]; }
+
+    /// Getter: source length, in bytes (or 0, if the command has no source)
+    uint64_t getSrcLen() const { return (cmd[3] & LEN_FIELD) >> CTRL_LEN_OFFS; }
+
+    /// Getter: destination length, in bytes (or 0, if the command has no destination)
+    uint64_t getDstLen() const { return (cmd[1] & LEN_FIELD) >> CTRL_LEN_OFFS; }
+
+    /// Patches the source address; for RDMA operations, this is the full (local or remote) virtual address
+    void setSrcAddr(uint64_t addr) {
+        if (!has_src) {
+            throw std::runtime_error("ERROR: cCmdTemplate::setSrcAddr() - the command has no source, exiting...");
+        }
+        cmd[2] = addr;
+    }
+
+    /// Patches the destination address; for RDMA operations, this is the full (local or remote) virtual address
+    void setDstAddr(uint64_t addr) {
+        if (!has_dst) {
+            throw std::runtime_error("ERROR: cCmdTemplate::setDstAddr() - the command has no destination, exiting...");
+        }
+        cmd[0] = addr;
+    }
+
+    /// Patches the address of a one-sided local operation (LOCAL_READ or LOCAL_WRITE)
+    void setAddr(const void *vaddr) {
+        if (has_src == has_dst) {
+            throw std::runtime_error("ERROR: cCmdTemplate::setAddr() - only applicable to one-sided operations, use setSrcAddr() or setDstAddr(), exiting...");
+        }
+        cmd[has_src ? 2 : 0] = reinterpret_cast<uint64_t>(vaddr);
+    }
+
+    /// Patches the transfer length, of both the source and destination, if present
+    void setLen(uint64_t len) {
+        if (len > MAX_TRANSFER_SIZE) {
+            throw std::runtime_error("ERROR: cCmdTemplate::setLen() - transfers over 128MB can't be posted as a single command, exiting...");
+        }
+        if (has_dst) {
+            cmd[1] = (cmd[1] & ~LEN_FIELD) | (len << CTRL_LEN_OFFS);
+        }
+        if (has_src) {
+            cmd[3] = (cmd[3] & ~LEN_FIELD) | (len << CTRL_LEN_OFFS);
+        }
+    }
+};
+
+}
+
+#endif // _COYOTE_CCMDTEMPLATE_HPP_
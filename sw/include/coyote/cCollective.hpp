@@ -0,0 +1,326 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CCOLLECTIVE_HPP_
+#define _COYOTE_CCOLLECTIVE_HPP_
+
+#include <array>
+#include <deque>
+#include <chrono>
+#include <vector>
+#include <utility>
+
+#include <coyote/cDefs.hpp>
+#include <coyote/cOps.hpp>
+#include <coyote/cThread.hpp>
+#include <coyote/cOobGroup.hpp>
+#include <coyote/cConnManager.hpp>
+
+namespace coyote {
+
+/// @brief All-reduce algorithm, see cCollective::allreduce()
+enum class collAlgo {
+    /// Recursive doubling for vectors up to collConfig::rd_threshold bytes and a power-of-two number of nodes, ring otherwise
+    AUTO = 0,
+    /// Reduce-scatter followed by an allgather around a ring; bandwidth-optimal, 2 * (N - 1) steps
+    RING = 1,
+    /// Pair-wise exchanges of the full vector; latency-optimal, log2(N) steps; requires a power-of-two number of nodes
+    RECURSIVE_DOUBLING = 2
+};
+
+/// @brief Element type of a reduction
+enum class collDtype {
+    INT32 = 0,
+    INT64 = 1,
+    FLOAT = 2,
+    DOUBLE = 3
+};
+
+/// @brief Reduction operator
+enum class collReduceOp {
+    SUM = 0,
+    MIN = 1,
+    MAX = 2
+};
+
+/// @brief Configuration of the RDMA collectives; must be the same on all nodes
+struct collConfig {
+    /// Offset of the work area (control words and receive slots) in the RDMA buffer, see cCollective::getWorkSize()
+    uint64_t work_offs = { 0 };
+
+    /// Size of the chunks in which buffers are transferred and reduced, in bytes; must be a multiple of 64
+    uint64_t chunk_size = { COLL_DEF_CHUNK_SIZE };
+
+    /// Number of receive slots per sender, i.e., chunks in flight between a pair of nodes
+    uint32_t n_slots = { COLL_DEF_N_SLOTS };
+
+    /// Largest vector (in bytes) all-reduced with recursive doubling, when using collAlgo::AUTO
+    uint64_t rd_threshold = { COLL_DEF_RD_THRESHOLD };
+
+    /// If set, chunks are reduced by the vFPGA instead of the host, see cCollective
+    bool fpga_reduce = { false };
+
+    /// First of the two vFPGA streams used for reductions, if fpga_reduce is set
+    uint32_t fpga_dest = { 0 };
+
+    /// Time-out of a single collective
+    std::chrono::milliseconds timeout = { std::chrono::milliseconds(COLL_DEF_TIMEOUT) };
+};
+
+/**
+ * @brief RDMA collectives (allreduce, reduce-scatter, broadcast) across many nodes
+ *
+ * Data moves with one-sided RDMA writes on the QPs of a connection manager; all of these QPs must share the 
+ * same RDMA buffer, with the same layout on all nodes. The buffers passed to the collectives, as well as the 
+ * work area of the collectives, are given as offsets into this buffer. Buffers are split into chunks, 
+ * so that transfers, reductions and forwarding of different chunks overlap.
+ *
+ * Chunks that have to be reduced are written into receive slots in the work area of the receiver, with credit-based 
+ * flow control; chunks that are final (allgather phase, broadcast) are written straight into the destination buffer. 
+ * Once the completion counter of the QP shows that a chunk was written, the sender writes a delivery count 
+ * into a control word of the receiver, which the receiver polls. No other synchronization is needed, so the 
+ * out-of-band group is only used when setting up the collectives.
+ *
+ * Reductions run on the host, with SIMD kernels. Alternatively, with collConfig::fpga_reduce, each chunk 
+ * received (A) and the corresponding local chunk (B) are streamed into the vFPGA, on axis_host_recv[fpga_dest] 
+ * and axis_host_recv[fpga_dest + 1] respectively, and the result is written back in place of B from 
+ * axis_host_send[fpga_dest]. The vFPGA must implement the reduction for the data type and operator in use.
+ *
+ * On a single machine, where all the QPs are served by the loopback path of cThread, the nodes must be cThreads in 
+ * the same process, since the copies target the virtual addresses exchanged with the QPs.
+ *
+ * @note All the nodes must call the same collectives in the same order; a cCollective must not be used by multiple threads at once
+ */
+class cCollective {
+
+private:
+    /// Control words in the work area, one per sender and word; each is a count, which only ever grows
+    enum ctrlWord {
+        /// Deliveries (chunks written) from the sender to this node
+        CTRL_DELIVERED = 0,
+        /// Chunks of this node released by the sender from its receive slots
+        CTRL_CREDITS = 1,
+        /// Sequence number of the last collective for which the sender accepts direct writes from this node
+        CTRL_READY = 2,
+        N_CTRL_WORDS = 3
+    };
+
+    /// Per-peer state of the RDMA channels
+    struct peerChan {
+        /// QP to the peer, as created by the connection manager
+        int32_t qp_id = { 0 };
+
+        /// Index of the receive slots of this node at the peer, and of the peer at this node
+        int32_t remote_slots = { -1 };
+        int32_t local_slots = { -1 };
+
+        /// Data writes to the peer which have not been announced yet, oldest first
+        std::deque<cmdTicket> inflight;
+
+        /// Deliveries to the peer: issued and announced
+        uint64_t n_issued = { 0 };
+        uint64_t n_announced = { 0 };
+
+        /// Chunks written into the receive slots of the peer
+        uint64_t n_slots_sent = { 0 };
+
+        /// Deliveries from the peer consumed by this node; chunks from the peer received into and released from the receive slots
+        uint64_t n_recv = { 0 };
+        uint64_t n_slots_recv = { 0 };
+        uint64_t n_slots_released = { 0 };
+
+        /// Control words of this node at the peer: latest value, last value written and the ticket of that write
+        std::array<uint64_t, N_CTRL_WORDS> ctrl_val = {};
+        std::array<uint64_t, N_CTRL_WORDS> ctrl_sent = {};
+        std::array<cmdTicket, N_CTRL_WORDS> ctrl_tickets = {};
+    };
+
+    /// cThread issuing the RDMA writes
+    cThread *cthread;
+
+    /// Configuration, as passed to the constructor
+    collConfig cnfg;
+
+    /// Rank of this node and number of nodes
+    int32_t rank = { 0 };
+    int32_t size = { 1 };
+
+    /// Channels to all the ranks, indexed by rank; unused for this node
+    std::vector<peerChan> chans;
+
+    /// Start and size of the RDMA buffer shared by the QPs
+    char *base = { nullptr };
+    uint64_t base_size = { 0 };
+
+    /// Sequence number of the current collective
+    uint64_t coll_seq = { 0 };
+
+    /// Time by which the current collective must complete
+    std::chrono::steady_clock::time_point deadline;
+
+    /// Offset of a control word written by src, in the work area
+    uint64_t ctrlOffs(ctrlWord word, int32_t src) const;
+
+    /// Offset of the staging word, from which a control word is written into the work area of dst
+    uint64_t stagingOffs(int32_t dst, ctrlWord word) const;
+
+    /// Offset of a receive slot: group of slots and the number of the chunk
+    uint64_t slotOffs(int32_t slots, uint64_t idx) const;
+
+    /// Index of the receive slots at node dst for chunks sent by node src; -1 if src never sends chunks for reduction to dst
+    int32_t slotIndex(int32_t src, int32_t dst) const;
+
+    /// Reads a control word of the work area, written by a peer
+    uint64_t readCtrl(ctrlWord word, int32_t src) const;
+
+    /**
+     * @brief Updates a control word of this node in the work area of a peer
+     *
+     * At most one write per word and peer is outstanding, so that a stale value can never overwrite a newer one; 
+     * updates made in the meantime are merged, and written by flushCtrl() once the outstanding write completes.
+     */
+    void setCtrl(int32_t dst, ctrlWord word, uint64_t val);
+
+    /// Writes the control words of a peer that changed, unless a write of the same word is still outstanding
+    void flushCtrl(int32_t dst);
+
+    /// Announces the data writes which have completed to their receivers and writes any pending control words
+    void progress();
+
+    /// Polls until cond() holds, announcing completed writes in the meantime; throws if the collective times out
+    template<typename Cond>
+    void waitFor(Cond cond, const char *what, int32_t peer = -1);
+
+    /// Writes a chunk into the next receive slot of a peer, waiting for a free slot if needed
+    cmdTicket sendSlot(int32_t dst, uint64_t local_offs, uint64_t len);
+
+    /// Writes a chunk to the same offset in the buffer of a peer
+    cmdTicket sendDirect(int32_t dst, uint64_t offs, uint64_t len);
+
+    /// Waits for the next delivery from a peer, written to the same offset in the buffer of this node
+    void recvDirect(int32_t src);
+
+    /// Waits for the next delivery from a peer into its receive slots; returns the offset of the slot
+    uint64_t recvSlot(int32_t src);
+
+    /// Releases the oldest receive slot of a peer, returning a credit
+    void release(int32_t src);
+
+    /// Tells a peer that it may write into the buffers of this node for the current collective
+    void signalReady(int32_t dst);
+
+    /// Waits until a peer allows writing into its buffers for the current collective
+    void waitReady(int32_t src);
+
+    /// Reduces count elements at src_offs into dst_offs, on the host or the vFPGA
+    void reduce(uint64_t dst_offs, uint64_t src_offs, uint64_t count, collDtype dtype, collReduceOp op);
+
+    /// Starts a collective: checks the buffer and sets the deadline
+    void begin(uint64_t offs, uint64_t len);
+
+    /// Completes a collective: waits until all the data writes have been announced and all the control words written
+    void end();
+
+    /// Reduce-scatter phase of the ring algorithm; rank r ends with segment r fully reduced
+    void ringReduceScatter(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op);
+
+    /// Allgather phase of the ring algorithm
+    void ringAllgather(uint64_t offs, uint64_t count, collDtype dtype);
+
+    /// Recursive doubling all-reduce
+    void rdAllreduce(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op);
+
+public:
+    /**
+     * @brief Sets up the collectives across all the nodes connected by a connection manager
+     *
+     * @param cthread cThread owning the QPs of the connection manager
+     * @param conn Connection manager, after connect(); all its QPs must share one RDMA buffer
+     * @param group Out-of-band group of the same nodes, for synchronizing the set-up
+     * @param cnfg Configuration, must be the same on all nodes
+     *
+     * @note Collective call: blocks until all the nodes have cleared their work areas
+     */
+    cCollective(cThread *cthread, const cConnManager &conn, cOobGroup &group, collConfig cnfg = {});
+
+    /// Waits for all outstanding writes, which may still access the RDMA buffer
+    ~cCollective();
+
+    /**
+     * @brief Size of the work area, in bytes
+     *
+     * @param n_nodes Number of nodes
+     * @param cnfg Configuration
+     * @return Number of bytes needed at cnfg.work_offs in the RDMA buffer; must not overlap the buffers of the collectives
+     */
+    static uint64_t getWorkSize(int32_t n_nodes, const collConfig &cnfg);
+
+    /**
+     * @brief All-reduces a vector in place
+     *
+     * @param offs Offset of the vector in the RDMA buffer
+     * @param count Number of elements
+     * @param dtype Element type
+     * @param op Reduction operator
+     * @param algo Algorithm (default: chosen by the size of the vector)
+     */
+    void allreduce(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op, collAlgo algo = collAlgo::AUTO);
+
+    /**
+     * @brief Reduce-scatters a vector in place, using the ring algorithm
+     *
+     * Rank r ends with segment r of the vector (see getSegment()) fully reduced; the other segments hold partial results.
+     *
+     * @param offs Offset of the vector in the RDMA buffer
+     * @param count Number of elements
+     * @param dtype Element type
+     * @param op Reduction operator
+     */
+    void reduceScatter(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op);
+
+    /**
+     * @brief Broadcasts a buffer from one rank to all the others, in a pipelined chain
+     *
+     * @param offs Offset of the buffer in the RDMA buffer
+     * @param len Length of the buffer, in bytes
+     * @param root Rank of the sender
+     */
+    void broadcast(uint64_t offs, uint64_t len, int32_t root);
+
+    /// Segment of a vector of count elements owned by a rank, as {first element, number of elements}
+    std::pair<uint64_t, uint64_t> getSegment(uint64_t count, int32_t rank) const;
+
+    /// Getter: rank of this node
+    int32_t getRank() const;
+
+    /// Getter: number of nodes
+    int32_t getSize() const;
+
+};
+
+}
+
+#endif // _COYOTE_CCOLLECTIVE_HPP_
@@ -0,0 +1,195 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CCONNMANAGER_HPP_
+#define _COYOTE_CCONNMANAGER_HPP_
+
+#include <map>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <coyote/cDefs.hpp>
+#include <coyote/cThread.hpp>
+
+namespace coyote {
+
+/// @brief A node taking part in an RDMA job, as seen by the connection manager
+struct cPeer {
+    /// Unique ID of the node in the job (e.g., its rank)
+    int32_t node_id = { -1 };
+
+    /// Host name or IP address of the node's out-of-band listener
+    std::string address;
+
+    /// Port of the node's out-of-band listener
+    uint16_t port = { DEF_PORT };
+};
+
+/// @brief Header of a message exchanged by the connection manager; followed by len bytes of payload
+struct qpExchangeHdr {
+    /// Always QP_EXCHANGE_MAGIC; guards against unrelated connections
+    uint32_t magic;
+
+    /// Protocol version, QP_EXCHANGE_VERSION; peers with a different version are rejected
+    uint16_t version;
+
+    /// Message type, see qpExchangeType
+    uint16_t type;
+
+    /// Length of the payload, in bytes
+    uint32_t len;
+};
+
+/// @brief Message types of the QP exchange
+enum class qpExchangeType: uint16_t {
+    /// Sent by the connecting node: its node ID and the local side of the QP dedicated to the accepting node
+    HELLO = 1,
+
+    /// Reply of the accepting node: its node ID and the local side of the QP dedicated to the connecting node
+    REPLY = 2
+};
+
+/// @brief Payload of HELLO and REPLY messages
+struct qpExchangeMsg {
+    /// Node ID of the sender
+    int32_t node_id;
+
+    /// Local side of the sender's QP, i.e., the remote side for the receiver
+    ibvQ qp;
+};
+
+/**
+ * @brief Connection manager, setting up RDMA queue pairs between one cThread and many peers
+ *
+ * Each node runs one connection manager, which listens for peers from the moment it is constructed. connect() 
+ * then brings up a full mesh: the node connects to all peers with a lower node ID and accepts the peers with 
+ * a higher node ID. All the connections are driven by one epoll loop, so the exchanges with all the peers 
+ * proceed in parallel, rather than as O(N) serialized handshakes; connection attempts to peers which 
+ * aren't listening yet are retried until the time-out. Every peer gets its own QP, created with cThread::createQp(),
+ * which is programmed into the vFPGA as soon as its exchange completes, overlapping with the remaining exchanges.
+ *
+ * The out-of-band connections stay open after the exchange and can be used for synchronization, see getSocket().
+ */
+class cConnManager {
+
+private:
+    /// An out-of-band connection whose exchange is still in progress
+    struct pendingConn {
+        /// Socket file descriptor
+        int fd = { -1 };
+
+        /// Peer; for accepted connections, only known once its HELLO was received
+        int32_t node_id = { -1 };
+
+        /// Set for connections initiated by this node, which send HELLO and expect REPLY
+        bool outgoing = { false };
+
+        /// Set while a non-blocking connect() is in progress
+        bool connecting = { false };
+
+        /// Received bytes of the current message
+        std::vector<char> rx;
+    };
+
+    /// cThread on which the QPs are created
+    cThread *cthread;
+
+    /// ID of this node
+    int32_t node_id;
+
+    /// Port of the out-of-band listener; also used as the port of the QP connections
+    uint16_t port;
+
+    /// Local buffer of the QPs; if nullptr, the buffer of the cThread's default QP is shared
+    void *mem;
+    uint64_t size;
+
+    /// Listening socket and epoll instance
+    int listen_fd = { -1 };
+    int epoll_fd = { -1 };
+
+    /// QP id (see cThread::createQp()) and out-of-band socket of every connected peer, keyed by the peer's node ID
+    std::map<int32_t, int32_t> peer_qps;
+    std::map<int32_t, int> peer_fds;
+
+    /// Opens a non-blocking connection to a peer; returns -1 if the peer could not be resolved
+    int openConn(const cPeer &peer);
+
+    /// Sends a message in full; the socket buffer of a fresh connection always fits it
+    void sendMsg(int fd, qpExchangeType type, const qpExchangeMsg &msg);
+
+    /// Reads as much of the pending message as available; returns 1 once the complete message is in conn.rx, 0 if more bytes are needed and -1 if the connection was closed
+    int recvMsg(pendingConn &conn);
+
+    /// Validates a received message and returns its payload; throws an std::runtime_error on a malformed message
+    qpExchangeMsg parseMsg(const pendingConn &conn, qpExchangeType type);
+
+public:
+    /**
+     * @brief Creates the connection manager and starts listening for peers
+     *
+     * @param cthread cThread on which the QPs are created; must outlive the connection manager
+     * @param node_id Unique ID of this node in the job
+     * @param port Port of the out-of-band listener
+     * @param mem Local buffer of the QPs; if nullptr, the buffer of the cThread's default QP is shared (see cThread::createQp())
+     * @param size Size of the local buffer, in bytes
+     */
+    cConnManager(cThread *cthread, int32_t node_id, uint16_t port = DEF_PORT, void *mem = nullptr, uint64_t size = 0);
+
+    /// Default destructor; closes all out-of-band connections and destroys the QPs
+    ~cConnManager();
+
+    cConnManager(const cConnManager&) = delete;
+    cConnManager& operator=(const cConnManager&) = delete;
+
+    /**
+     * @brief Connects to all peers, creating and programming one QP per peer
+     *
+     * @param peers All the other nodes in the job; may include this node, which is then skipped
+     * @param timeout Maximum time to wait for all peers
+     * @throws std::runtime_error if not all peers are connected within the time-out, or a peer sent an invalid message;
+     * 		   the QPs of the peers that did connect remain usable
+     */
+    void connect(const std::vector<cPeer> &peers, std::chrono::milliseconds timeout = std::chrono::milliseconds(CONN_MANAGER_DEF_TIMEOUT));
+
+    /// Getter: QP id of a connected peer, to be used in rdmaSg::qp_id
+    int32_t getQp(int32_t peer_id) const;
+
+    /// Getter: out-of-band socket of a connected peer (blocking), e.g., for barriers
+    int getSocket(int32_t peer_id) const;
+
+    /// Getter: node IDs of all connected peers, in ascending order
+    std::vector<int32_t> getPeers() const;
+
+    /// Getter: ID of this node
+    int32_t getNodeId() const;
+
+};
+
+}
+
+#endif // _COYOTE_CCONNMANAGER_HPP_
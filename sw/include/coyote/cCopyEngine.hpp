@@ -0,0 +1,163 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CCOPYENGINE_HPP_
+#define _COYOTE_CCOPYENGINE_HPP_
+
+#include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include <coyote/cDefs.hpp>
+
+namespace coyote {
+
+/**
+ * @brief Completion counter for copies executed by the copy engine, mimicking a hardware completion counter
+ *
+ * Copies can finish out of order (e.g., when they run on different workers), but the counter only advances 
+ * over the longest prefix of finished copies, in the order they were reserved. As in hardware, only copies 
+ * with last set increment the counter, so the tickets issued by cThread stay valid.
+ */
+class copyCounter {
+
+private:
+    /// Completed copies with last set, in the finished prefix
+    std::atomic<uint32_t> cmpl = { 0 };
+
+    std::mutex clock;
+    std::condition_variable cdone;
+
+    /// Position of the next reserved copy, and the length of the finished prefix
+    uint64_t n_reserved = { 0 };
+    uint64_t n_done = { 0 };
+
+    /// Copies that finished ahead of the prefix, keyed by position, with their last flag
+    std::map<uint64_t, bool> finished;
+
+public:
+    /// Reserves the position of a copy that is about to be submitted
+    uint64_t reserve();
+
+    /// Marks the copy at position pos as finished
+    void finish(uint64_t pos, bool last);
+
+    /// Getter: number of completed copies with last set
+    uint32_t completed() const { return cmpl.load(std::memory_order_acquire); }
+
+    /// Blocks until all the reserved copies have finished
+    void drain();
+
+    /// Waits for all the reserved copies to finish, then resets the counter
+    void clear();
+};
+
+/**
+ * @brief Process-wide engine for host-side memory copies, e.g., RDMA operations between a cThread and itself (loopback)
+ *
+ * Large copies use non-temporal (streaming) stores, with AVX-512 or AVX2 as supported by the CPU, so they don't evict 
+ * the caller's working set from the caches. Optionally, copies are offloaded to a pool of worker threads; copies larger 
+ * than COPY_ENGINE_CHUNK_SIZE are split across the workers, so a single copy can use the memory bandwidth of several cores.
+ * Without workers (the default), copies are executed synchronously on the submitting thread.
+ */
+class cCopyEngine {
+
+private:
+    /// A chunk of a submitted copy
+    struct copyTask {
+        void *dst;
+        const void *src;
+        size_t len;
+
+        /// Number of chunks of the copy still in flight, and the callback to run when the last one finishes
+        std::shared_ptr<std::atomic<uint32_t>> pending;
+        std::shared_ptr<std::function<void()>> done;
+    };
+
+    std::vector<std::thread> workers;
+
+    /// Queue of chunks, shared by all workers
+    std::deque<copyTask> tasks;
+    std::mutex qlock;
+    std::condition_variable qcv;
+    bool terminate = { false };
+
+    cCopyEngine() = default;
+
+    /// Main loop of a worker thread
+    void run();
+
+public:
+    /**
+     * @brief Returns the process-wide copy engine ("singleton" implementation)
+     */
+    static cCopyEngine& getInstance();
+
+    /**
+     * @brief Default destructor; finishes the queued copies and stops all the workers
+     */
+    ~cCopyEngine();
+
+    cCopyEngine(const cCopyEngine&) = delete;
+    cCopyEngine& operator=(const cCopyEngine&) = delete;
+
+    /**
+     * @brief Sets the number of worker threads
+     *
+     * @param n Number of threads; 0 executes copies synchronously, on the submitting thread
+     * @note Waits for queued copies to finish before replacing the workers
+     */
+    void setThreads(uint32_t n);
+
+    /// Getter: number of worker threads
+    uint32_t getThreads();
+
+    /**
+     * @brief Submits a copy; the callback is invoked once the copy has finished
+     *
+     * @param dst Destination buffer
+     * @param src Source buffer; must not overlap with the destination
+     * @param len Number of bytes to copy
+     * @param done Callback, invoked on the thread that finishes the copy (the submitting thread, if there are no workers)
+     */
+    void submit(void *dst, const void *src, size_t len, std::function<void()> done);
+
+    /**
+     * @brief Copies synchronously, on the calling thread; uses non-temporal stores from COPY_ENGINE_NT_THRESHOLD bytes onwards
+     * @note Same arguments as memcpy
+     */
+    static void copy(void *dst, const void *src, size_t len);
+};
+
+}
+
+#endif // _COYOTE_CCOPYENGINE_HPP_
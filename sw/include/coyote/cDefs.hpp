@@ -27,6 +27,7 @@
 #ifndef _COYOTE_CDEFS_HPP_
 #define _COYOTE_CDEFS_HPP_
 
+#include <atomic>
 #include <chrono> 
 #include <cstring> 
 #include <cstdint>
@@ -100,6 +101,18 @@ namespace coyote {
 // Retrieves notification value
 #define IOCTL_GET_NOTIFICATION_VALUE        _IOR('F', 19, unsigned long)
 
+// Register a notification ring, which is memory mapped and receives user interrupts (notifications) without any syscalls
+#define IOCTL_REGISTER_NOTIFY_RING          _IOW('F', 20, unsigned long)
+
+// Unregister a previously registered notification ring
+#define IOCTL_UNREGISTER_NOTIFY_RING        _IOW('F', 21, unsigned long)
+
+// Map a batch of user buffers into the TLBs, with a single ioctl
+#define IOCTL_MAP_USER_MEM_BATCH            _IOW('F', 22, unsigned long)
+
+// Unmap a batch of previously mapped buffers from the TLBs, with a single ioctl
+#define IOCTL_UNMAP_USER_MEM_BATCH          _IOW('F', 23, unsigned long)
+
 // Allocate memory for partial reconfiguration
 #define IOCTL_ALLOC_HOST_RECONFIG_MEM       _IOW('P', 1, unsigned long)
 
@@ -243,15 +256,55 @@ constexpr unsigned long const MAX_TRANSFER_SIZE = 128 * 1024 * 1024;
 // Sleep time in nanoseconds for buszy wait loops; used while waiting for hardware to complete
 constexpr long const SLEEP_TIME = 100L;
 
-// Maximum number of user interrupts to process simultaneously
-constexpr int const MAX_EVENTS = 1;
+// Number of busy polls between two time-out checks when waiting for completion; reading the clock is more expensive than polling
+constexpr unsigned int const WAIT_CLOCK_POLLS = 64;
+
+// Maximum number of user interrupts to process in one batch, by each interrupt reactor thread
+constexpr int const MAX_EVENTS = 64;
 
-// Memory and page configuration --- TODO: Think about making these configurable at run-time based on the shell TLB config
+// Default number of interrupt reactor threads, shared by all cThreads in the process
+constexpr unsigned int const REACTOR_DEF_THREADS = 1;
+
+// Default number of idle cThreads kept by a cThreadPool
+constexpr unsigned int const THREAD_POOL_DEF_SIZE = 4;
+
+// Memory and page configuration; host defaults, the page sizes of the shell's TLBs are obtained at run-time, see fpgaCnfg::getHugePageSize()
 constexpr unsigned long long const PAGE_SIZE = (4ULL * 1024ULL);
 constexpr unsigned long long const HUGE_PAGE_SIZE = (2ULL * 1024ULL * 1024ULL);
 constexpr unsigned long const PAGE_SHIFT = 12UL;
 constexpr unsigned long const HUGE_PAGE_SHIFT = 21UL;
 
+// 1GB huge pages, see CoyoteAllocType::HPF_1G
+constexpr unsigned long long const HUGE_PAGE_1G_SIZE = (1ULL * 1024ULL * 1024ULL * 1024ULL);
+constexpr unsigned long const HUGE_PAGE_1G_SHIFT = 30UL;
+
+// Page size of the host buffers for partial bitstreams; must match the driver (RECONFIG_BUFF_PAGE_SHIFT in coyote_defs.h)
+constexpr unsigned long long const RECONFIG_BUFF_PAGE_SIZE = (2ULL * 1024ULL * 1024ULL);
+constexpr unsigned long const RECONFIG_BUFF_PAGE_SHIFT = 21UL;
+
+// Memory pool configuration; size classes are powers of two, from MEM_POOL_MIN_BLOCK to MEM_POOL_SLAB_SIZE
+constexpr unsigned long long const MEM_POOL_MIN_BLOCK = PAGE_SIZE;
+constexpr unsigned long long const MEM_POOL_SLAB_SIZE = (1ULL * 1024ULL * 1024ULL);
+constexpr unsigned int const MEM_POOL_N_CLASSES = 9;
+constexpr unsigned long long const MEM_POOL_ARENA_SIZE = (64ULL * HUGE_PAGE_SIZE);
+constexpr unsigned int const MEM_POOL_MAX_ARENAS = 64;
+constexpr unsigned int const MEM_POOL_MAX_THREADS = 64;
+constexpr unsigned int const MEM_POOL_CACHE_SIZE = 32;
+
+// Default budget for memory pinned by the registration cache, see cThread::enableRegCache()
+constexpr unsigned long long const REG_CACHE_DEF_BUDGET = (1ULL * 1024ULL * 1024ULL * 1024ULL);
+
+// Default budget and idle time-out for buffers kept mapped after freeMem, see cThread::enableRecycling()
+constexpr unsigned long long const RECYCLE_DEF_BUDGET = (256ULL * 1024ULL * 1024ULL);
+constexpr std::chrono::milliseconds const RECYCLE_DEF_IDLE_TIMEOUT = 1000ms;
+
+// Copy engine configuration; copies from COPY_ENGINE_NT_THRESHOLD bytes use non-temporal stores and are split into chunks of COPY_ENGINE_CHUNK_SIZE across the workers
+constexpr unsigned long long const COPY_ENGINE_NT_THRESHOLD = (1ULL * 1024ULL * 1024ULL);
+constexpr unsigned long long const COPY_ENGINE_CHUNK_SIZE = (4ULL * 1024ULL * 1024ULL);
+
+// Maximum number of NUMA nodes considered when setting memory policies
+constexpr unsigned int const MAX_NUMA_NODES = 64;
+
 // Maximum number of Coyote threads per vFPGA
 constexpr int const N_CTID_MAX = 64;
 
@@ -271,6 +324,10 @@ constexpr unsigned long const MMAP_CNFG = 0x1 << PAGE_SHIFT;
 constexpr unsigned long const MMAP_CNFG_AVX = 0x2 << PAGE_SHIFT;
 constexpr unsigned long const MMAP_CTRL = 0x3 << PAGE_SHIFT;
 constexpr unsigned long const MMAP_RECONFIG = 0x100 << PAGE_SHIFT;
+constexpr unsigned long const MMAP_NOTIFY = 0x200 << PAGE_SHIFT;  // The ring of a Coyote thread is at MMAP_NOTIFY + ctid * PAGE_SIZE
+
+// Number of entries in a notification ring; must match the driver (NOTIFY_RING_SIZE in coyote_defs.h)
+constexpr uint32_t const NOTIFY_RING_SIZE = 512;
 
 // Writeback region constants; there are deidcated writebacks for reads, writes, remote reads and remote writes
 constexpr unsigned long const N_WBACKS = 4;
@@ -282,6 +339,9 @@ constexpr unsigned long const WR_RDMA_WBACK = 3;
 // Maximum number of user arguments for IOCTL calls passed from the user space to the driver
 constexpr auto const MAX_USER_ARGS = 32;
 
+// Maximum number of buffers per batched map/unmap ioctl; must match the driver (MAX_MAP_BATCH in coyote_defs.h)
+constexpr unsigned int const MAP_BATCH_MAX = 256;
+
 // Data source/destination stream in the vFPGA; e.g., axis_host_(recv|send). axis_card_(recv|send)
 constexpr unsigned long const STRM_CARD = 0;
 constexpr unsigned long const STRM_HOST = 1;
@@ -307,6 +367,57 @@ constexpr unsigned long const SLEEP_INTERVAL_CLIENT_CONN_MANAGER = 500; // us
 static constexpr struct timeval SERVER_RECV_TIMEOUT = {.tv_sec = 0, .tv_usec = 5000}; 
 static constexpr struct timeval CLIENT_RECV_TIMEOUT = {.tv_sec = 0, .tv_usec = 500}; 
 
+// Out-of-band QP exchange of the connection manager, see cConnManager; peers with a different version are rejected
+constexpr uint32_t const QP_EXCHANGE_MAGIC = 0x43595451;
+constexpr uint16_t const QP_EXCHANGE_VERSION = 1;
+constexpr unsigned long const CONN_MANAGER_DEF_TIMEOUT = 30000; // ms
+constexpr unsigned long const CONN_MANAGER_RETRY_INTERVAL = 10; // ms
+constexpr int const CONN_MANAGER_BACKLOG = 1024;
+constexpr unsigned long const OOB_COLL_DEF_TIMEOUT = 30000; // ms
+
+// RDMA collectives, see cCollective; vectors up to COLL_DEF_RD_THRESHOLD bytes are all-reduced with recursive doubling by default
+constexpr unsigned long long const COLL_DEF_CHUNK_SIZE = (256ULL * 1024ULL);
+constexpr unsigned int const COLL_DEF_N_SLOTS = 4;
+constexpr unsigned long long const COLL_DEF_RD_THRESHOLD = (64ULL * 1024ULL);
+constexpr unsigned long const COLL_DEF_TIMEOUT = 30000; // ms
+
+// Streaming RDMA writes, see cRdmaStream; messages in the ring are aligned to STREAM_MSG_ALIGN bytes, 
+// and each end needs STREAM_CTRL_SIZE bytes of control words in its RDMA buffer
+constexpr unsigned long long const STREAM_DEF_RING_SIZE = (4ULL * 1024ULL * 1024ULL);
+constexpr unsigned int const STREAM_DEF_WINDOW = 16;
+constexpr unsigned long long const STREAM_MSG_ALIGN = 64;
+constexpr unsigned long long const STREAM_CTRL_SIZE = 192;
+
+/**
+ * @brief Notification ring, shared with the driver (struct vfpga_notify_ring in coyote_defs.h)
+ *
+ * The driver appends notification values at the tail, the user-space consumes them from the head;
+ * both indices are free-running and placed on separate cache lines, since each is written by one side only.
+ */
+struct notifyRing {
+    /// Index of the next value to be written; written by the driver
+    std::atomic<uint32_t> tail;
+
+    /// Number of notifications dropped because the ring was full; written by the driver
+    std::atomic<uint32_t> dropped;
+
+    uint32_t rsrvd_0[14];
+
+    /// Index of the next value to be read; written by the user-space
+    std::atomic<uint32_t> head;
+
+    /// Set while the consumer is blocked on the eventfd; the driver only signals the eventfd if set
+    std::atomic<uint32_t> waiting;
+
+    uint32_t rsrvd_1[14];
+
+    /// Notification values
+    int32_t values[NOTIFY_RING_SIZE];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "notifyRing requires lock-free 32-bit atomics");
+static_assert(sizeof(notifyRing) <= PAGE_SIZE, "notifyRing must fit in a single page");
+
 /// @brief RDMA Queue (QP) --- keeps all the necessary information of a single node in RDMA connections
 struct ibvQ {
     /// Node IP address
@@ -334,7 +445,7 @@ struct ibvQ {
     char gid[33] = { 0 };
 
     /// Converter GID to integer 
-    uint32_t gidToUint(int idx) {
+    uint32_t gidToUint(int idx) const {
         if(idx > 24) {
             std::cerr << "Invalid index for gidToUint" << std::endl;
             return 0;
@@ -443,6 +554,16 @@ typedef struct __attribute__((packed)) {
     void parseCtrlReg(uint64_t value){
         ctrl_reg = *(ctrl_cnfg_reg_bits*) &value;
     }
+
+    /// Page size of the shell's small TLB; PAGE_SIZE if unknown
+    uint64_t getPageSize() const {
+        return ctrl_reg.pg_s_bits ? (1ULL << ctrl_reg.pg_s_bits) : PAGE_SIZE;
+    }
+
+    /// Page size of the shell's large TLB, i.e., the size of the huge pages used by HPF allocations; HUGE_PAGE_SIZE if unknown
+    uint64_t getHugePageSize() const {
+        return ctrl_reg.pg_l_bits ? (1ULL << ctrl_reg.pg_l_bits) : HUGE_PAGE_SIZE;
+    }
 };
 
 ///////////////////////////////////////////////////
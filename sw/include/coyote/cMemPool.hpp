@@ -0,0 +1,212 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CMEMPOOL_HPP_
+#define _COYOTE_CMEMPOOL_HPP_
+
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+#include <coyote/cDefs.hpp>
+#include <coyote/cOps.hpp>
+#include <coyote/cThread.hpp>
+
+namespace coyote {
+
+/// @brief Memory pool statistics, aggregated across all threads using the pool
+struct memPoolStats {
+    /// Number of calls to alloc()
+    uint64_t n_allocs = { 0 };
+
+    /// Number of calls to free()
+    uint64_t n_frees = { 0 };
+
+    /// Number of allocations served from the calling thread's cache
+    uint64_t n_cache_hits = { 0 };
+
+    /// Number of slabs carved from the arenas into size classes
+    uint64_t n_slab_refills = { 0 };
+
+    /// Number of live allocations larger than the largest size class, served directly by cThread::getMem()
+    uint64_t n_large_allocs = { 0 };
+
+    /// Number of arenas obtained from cThread::getMem()
+    uint64_t n_arenas = { 0 };
+
+    /// Total memory mapped by the pool, including large allocations, in bytes
+    uint64_t mapped_bytes = { 0 };
+
+    /// Memory currently handed out to users, rounded up to the size class, in bytes
+    uint64_t used_bytes = { 0 };
+};
+
+/**
+ * @brief Pool allocator for buffers used in Coyote operations
+ *
+ * Every call to cThread::getMem() and cThread::freeMem() performs a system call and an ioctl, which
+ * pins the pages and updates the vFPGA's TLB. For small, frequently allocated buffers, this dominates the latency.
+ * Instead, the pool obtains large arenas (by default, hugepages) through getMem() once, and sub-allocates
+ * power-of-two size classes, from MEM_POOL_MIN_BLOCK to MEM_POOL_SLAB_SIZE, entirely in user-space.
+ * 
+ * Each size class has a lock-free free-list, shared by all threads. On top of that, every thread 
+ * has a small cache of blocks for each size class, such that most allocations and frees neither take 
+ * a lock nor perform an atomic read-modify-write. Arenas are carved into slabs of MEM_POOL_SLAB_SIZE, 
+ * each belonging to exactly one size class; hence, blocks are naturally aligned to their size, 
+ * since arenas are aligned to MEM_POOL_SLAB_SIZE. THP and HPF arenas are aligned by construction; 
+ * REG arenas are only page-aligned, so they are over-allocated by up to one slab and the start is rounded up.
+ * 
+ * Allocations larger than MEM_POOL_SLAB_SIZE bypass the pool and are forwarded to cThread::getMem().
+ *
+ * @note Memory is only returned to the cThread when the pool is destroyed, so the pool must be destroyed before its cThread.
+ * @note Only the first MEM_POOL_MAX_THREADS threads that use any pool get a thread cache; all other threads use the shared free-lists.
+ * Blocks cached by a thread that has exited remain in its cache until the pool is destroyed.
+ */
+class cMemPool {
+
+private:
+    /// A contiguous region obtained through cThread::getMem(), carved into slabs
+    struct memArena {
+        /// Memory as returned by cThread::getMem(); released with cThread::freeMem()
+        void *mem;
+
+        /// Start of the first slab, aligned to MEM_POOL_SLAB_SIZE, and the size of the slabs
+        char *base;
+        uint64_t size;
+
+        /// Size class of each slab in the arena; written before any block of the slab is published
+        std::unique_ptr<uint8_t[]> slab_class;
+    };
+
+    /// Per-thread cache of blocks, for each size class; only accessed by the thread owning it
+    struct alignas(64) threadCache {
+        uint32_t n_blocks[MEM_POOL_N_CLASSES] = { 0 };
+        void *blocks[MEM_POOL_N_CLASSES][MEM_POOL_CACHE_SIZE];
+    };
+
+    /// Statistic counters; kept for each thread cache, plus one shared set for threads without a cache
+    struct alignas(64) poolCounters {
+        std::atomic<uint64_t> n_allocs = { 0 };
+        std::atomic<uint64_t> n_frees = { 0 };
+        std::atomic<uint64_t> n_cache_hits = { 0 };
+        std::atomic<int64_t> used_bytes = { 0 };
+    };
+
+    /// cThread which maps the arenas
+    cThread &thread;
+
+    /// Memory type of the arenas
+    CoyoteAllocType type;
+
+    /// Size of each arena, in bytes
+    uint64_t arena_size;
+
+    /// Memory obtained in addition to each arena, for aligning it to MEM_POOL_SLAB_SIZE; only needed for REG arenas
+    uint64_t arena_pad;
+
+    /// Heads of the free-lists, for each size class; a 48-bit pointer and a 16-bit tag, preventing the ABA problem
+    std::atomic<uint64_t> free_heads[MEM_POOL_N_CLASSES];
+
+    /// Arenas; entries are only appended, and published by incrementing n_arenas 
+    std::array<memArena, MEM_POOL_MAX_ARENAS> arenas;
+    std::atomic<uint32_t> n_arenas = { 0 };
+
+    /// Number of slabs already carved from the last arena
+    uint64_t n_slabs_used = { 0 };
+
+    /// Number of slabs carved since the pool was created
+    uint64_t n_slab_refills = { 0 };
+
+    /// Allocations larger than the largest size class, and their sizes
+    std::unordered_map<void*, uint64_t> large_allocs;
+    uint64_t large_bytes = { 0 };
+
+    /// Lock for arena creation, slab carving and large allocations; not taken on the hot path
+    mutable std::mutex plock;
+
+    /// Thread caches and statistics, indexed by the thread's slot
+    std::unique_ptr<threadCache[]> caches;
+    std::unique_ptr<poolCounters[]> counters;
+
+    /// Adds a new arena to the pool; must be called with plock held; returns false if the arena could not be obtained
+    bool addArena();
+
+    /// Carves a new slab into blocks of the given size class, returns one and pushes the others to the free-list
+    void* refill(uint32_t cls);
+
+    /// Pushes a chain of blocks, linked through their first 8 bytes, onto the free-list of the size class
+    void pushBlocks(uint32_t cls, void *first, void *last);
+
+    /// Pops a block from the free-list of the size class; nullptr if empty
+    void* popBlock(uint32_t cls);
+
+    /// Returns the size class of a block from the pool, or -1 if the address was not allocated from an arena
+    int32_t findClass(void *ptr) const;
+
+public:
+    /**
+     * @brief Constructs a memory pool and maps its first arena
+     *
+     * @param thread cThread used for mapping the arenas; must outlive the pool
+     * @param type Memory type of the arenas; HPF by default, REG, THP and HPF_1G are supported as well
+     * @param arena_size Size of each arena, in bytes; rounded up to a multiple of MEM_POOL_SLAB_SIZE
+     *
+     * @throws std::runtime_error if the type is not supported or the first arena can't be mapped
+     */
+    cMemPool(cThread &thread, CoyoteAllocType type = CoyoteAllocType::HPF, uint64_t arena_size = MEM_POOL_ARENA_SIZE);
+
+    /**
+     * @brief Default destructor; releases all arenas and large allocations to the cThread
+     */
+    ~cMemPool();
+
+    cMemPool(const cMemPool&) = delete;
+    cMemPool& operator=(const cMemPool&) = delete;
+
+    /**
+     * @brief Allocates a buffer, already mapped into the vFPGA's TLB
+     *
+     * @param size Size of the buffer, in bytes; rounded up to the next size class
+     * @return Pointer to the buffer, aligned to its size class; nullptr if the pool can't grow
+     */
+    void* alloc(uint64_t size);
+
+    /**
+     * @brief Returns a buffer to the pool
+     *
+     * @param ptr Pointer previously returned by alloc(); nullptr is ignored
+     */
+    void free(void *ptr);
+
+    /// Returns the pool statistics; counters are sampled without stopping concurrent users, so they may be slightly inconsistent
+    memPoolStats getStats() const;
+};
+
+}
+
+#endif // _COYOTE_CMEMPOOL_HPP_
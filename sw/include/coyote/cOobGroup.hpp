@@ -0,0 +1,201 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_COOBGROUP_HPP_
+#define _COYOTE_COOBGROUP_HPP_
+
+#include <map>
+#include <array>
+#include <chrono>
+#include <vector>
+#include <cstring>
+#include <type_traits>
+
+#include <coyote/cDefs.hpp>
+#include <coyote/cConnManager.hpp>
+
+namespace coyote {
+
+/// @brief Collective operations over the out-of-band channel, see cOobGroup
+enum class oobCollOp: uint16_t {
+    BARRIER = 0,
+    BROADCAST = 1,
+    ALLGATHER = 2
+};
+
+/// Number of collective operation types, for indexing the statistics
+constexpr unsigned int const N_OOB_COLL_OPS = 3;
+
+/// @brief Latency statistics of one collective operation type, as reported by cOobGroup::getStats()
+struct oobCollStats {
+    /// Number of completed calls
+    uint64_t n_calls = { 0 };
+
+    /// Total, minimum and maximum time per call
+    std::chrono::nanoseconds total = { 0ns };
+    std::chrono::nanoseconds min = std::chrono::nanoseconds::max();
+    std::chrono::nanoseconds max = { 0ns };
+};
+
+/**
+ * @brief Collectives (barrier, broadcast, allgather) across many nodes, over the out-of-band TCP connections
+ *
+ * Meant for synchronization and small metadata (QP info, buffer addresses etc.), as opposed to RDMA data transfers.
+ * Nodes are ordered by their node ID; the position of a node in this order is its rank. All the collectives take
+ * O(log N) rounds: the barrier uses the dissemination algorithm, broadcast a binomial tree and allgather the Bruck 
+ * algorithm. In every round, a node sends to one peer and receives from another; both directions progress 
+ * concurrently on non-blocking sockets, so no round can deadlock, regardless of the message size.
+ *
+ * Every message carries a header with the sequence number of the collective, the operation and the round, 
+ * so a node that calls the collectives in a different order than its peers fails with an error, instead of hanging.
+ *
+ * @note All the nodes must call the same collectives in the same order; the group must not be used by multiple threads at once
+ */
+class cOobGroup {
+
+private:
+    /// Header of every out-of-band collective message
+    struct oobMsgHdr {
+        uint32_t seq;
+        uint16_t op;
+        uint16_t round;
+        uint64_t len;
+    };
+
+    /// Node IDs of all the nodes in the group, in ascending order; the index is the rank
+    std::vector<int32_t> nodes;
+
+    /// Out-of-band socket of every rank; -1 for this node
+    std::vector<int> fds;
+
+    /// Rank of this node
+    int32_t rank = { 0 };
+
+    /// Sequence number of the next collective
+    uint32_t seq = { 0 };
+
+    /// Time-out of a single collective
+    std::chrono::milliseconds timeout;
+
+    /// Latency statistics, indexed by oobCollOp
+    std::array<oobCollStats, N_OOB_COLL_OPS> stats;
+
+    /**
+     * @brief One round of a collective: sends a message to one rank, while receiving a message from another
+     *
+     * @param send_rank Rank to send to; -1 if nothing is sent in this round
+     * @param sbuf Payload to send
+     * @param slen Payload length, in bytes
+     * @param recv_rank Rank to receive from; -1 if nothing is received in this round
+     * @param rbuf Buffer for the received payload
+     * @param rlen Expected payload length, in bytes
+     * @param op Collective operation, for validating the received header
+     * @param round Round of the collective, for validating the received header
+     * @param deadline Time by which the round must complete
+     */
+    void exchange(
+        int32_t send_rank, const void *sbuf, uint64_t slen, int32_t recv_rank, void *rbuf, uint64_t rlen, 
+        oobCollOp op, uint16_t round, std::chrono::steady_clock::time_point deadline
+    );
+
+    /// Updates the statistics of an operation, for a call that started at start
+    void record(oobCollOp op, std::chrono::steady_clock::time_point start);
+
+public:
+    /**
+     * @brief Creates a group of all the nodes connected by a connection manager
+     *
+     * @param conn Connection manager, after connect(); its sockets are used by the group, so it must outlive the group
+     * @param timeout Time-out of a single collective; an std::runtime_error is thrown if it expires
+     */
+    cOobGroup(const cConnManager &conn, std::chrono::milliseconds timeout = std::chrono::milliseconds(OOB_COLL_DEF_TIMEOUT));
+
+    /**
+     * @brief Creates a group from already connected sockets
+     *
+     * @param node_id ID of this node
+     * @param peer_fds Connected stream socket to every other node, keyed by node ID; the sockets stay owned by the caller
+     * @param timeout Time-out of a single collective
+     */
+    cOobGroup(int32_t node_id, const std::map<int32_t, int> &peer_fds, std::chrono::milliseconds timeout = std::chrono::milliseconds(OOB_COLL_DEF_TIMEOUT));
+
+    /// Blocks until all the nodes in the group have entered the barrier
+    void barrier();
+
+    /**
+     * @brief Broadcasts a buffer from one rank to all the others
+     *
+     * @param buf Buffer; sent from the root and overwritten on all the other ranks
+     * @param len Length of the buffer, in bytes; must be the same on all ranks
+     * @param root Rank of the sender
+     */
+    void broadcast(void *buf, uint64_t len, int32_t root);
+
+    /**
+     * @brief Gathers a buffer from every rank on all the ranks
+     *
+     * @param sbuf Buffer contributed by this rank
+     * @param len Length of the contributed buffer, in bytes; must be the same on all ranks
+     * @param rbuf Output buffer of getSize() * len bytes; the contribution of rank i is placed at offset i * len
+     */
+    void allgather(const void *sbuf, uint64_t len, void *rbuf);
+
+    /// Same as above, for a trivially copyable value; returns the values of all ranks, indexed by rank
+    template<typename T>
+    std::vector<T> allgather(const T &val) {
+        static_assert(std::is_trivially_copyable<T>::value, "cOobGroup::allgather() requires a trivially copyable type");
+        std::vector<T> vals(nodes.size());
+        allgather(&val, sizeof(T), vals.data());
+        return vals;
+    }
+
+    /// Same as broadcast(), for a trivially copyable value
+    template<typename T>
+    void broadcast(T &val, int32_t root) {
+        static_assert(std::is_trivially_copyable<T>::value, "cOobGroup::broadcast() requires a trivially copyable type");
+        broadcast(&val, sizeof(T), root);
+    }
+
+    /// Getter: rank of this node
+    int32_t getRank() const;
+
+    /// Getter: number of nodes in the group
+    int32_t getSize() const;
+
+    /// Getter: node ID of a rank
+    int32_t getNodeId(int32_t rank) const;
+
+    /// Getter: latency statistics of an operation
+    oobCollStats getStats(oobCollOp op) const;
+
+    /// Resets the latency statistics of all operations
+    void resetStats();
+
+};
+
+}
+
+#endif // _COYOTE_COOBGROUP_HPP_
@@ -31,6 +31,8 @@
 #include <cuda.h>
 #endif
 
+#include <array>
+
 #include <coyote/cDefs.hpp>
 
 namespace coyote {
@@ -94,6 +96,91 @@ inline constexpr bool isRemoteWriteOrSend(CoyoteOper oper) { return oper == Coyo
 
 inline constexpr bool isRemoteTcp(CoyoteOper oper) { return oper == CoyoteOper::REMOTE_TCP_SEND; }
 
+///////////////////////////////////////////////////
+//              COYOTE COMPLETIONS              //
+//////////////////////////////////////////////////
+
+/// @brief Strategies for waiting on completion counters, see cThread::waitCompleted()
+enum class CoyoteWait {
+    /// Busy-poll the completion counter; lowest latency, but occupies a full CPU core
+    SPIN = 0,
+
+    /// Busy-poll for a while, then execute a pause instruction between polls; frees up resources for the sibling hyper-thread
+    PAUSE = 1,
+
+    /// Busy-poll for a while, then yield the CPU core to other threads between polls
+    YIELD = 2,
+
+    /// Busy-poll for a while, then sleep between polls; the sleep interval is doubled after every poll, up to a bound
+    SLEEP = 3
+};
+
+/// @brief Parameters of a wait strategy, used when blocking on completion counters
+struct waitPolicy {
+    /// Wait strategy
+    CoyoteWait wait = { CoyoteWait::PAUSE };
+
+    /// Number of busy polls before backing off; ignored for CoyoteWait::SPIN
+    uint32_t n_spins = { 1024 };
+
+    /// Initial sleep interval, for CoyoteWait::SLEEP
+    std::chrono::nanoseconds min_sleep = { 1us };
+
+    /// Maximum sleep interval, for CoyoteWait::SLEEP
+    std::chrono::nanoseconds max_sleep = { 100us };
+};
+
+/**
+ * @brief Completion ticket of an invoked operation, see cThread::isDone() and cThread::wait()
+ *
+ * A ticket holds the value the (cumulative) completion counter of its operation type must reach for the
+ * operation to be considered completed. Therefore, tickets can be checked at any time without clearing
+ * the completion counters, but they are invalidated by cThread::clearCompleted().
+ */
+struct cmdTicket {
+    /// Operation type; determines which completion counter the ticket refers to
+    CoyoteOper oper = { CoyoteOper::NOOP };
+
+    /// Value of the completion counter at which the operation is completed
+    uint32_t seq = { 0 };
+
+    /// Queue pair the operation was issued on; only relevant for RDMA operations, which are counted per QP
+    int32_t qp_id = { 0 };
+};
+
+/// @brief Statistics about a completed wait, as reported by cThread::waitCompleted()
+struct waitStats {
+    /// Number of times the completion counter was polled
+    uint64_t n_polls = { 0 };
+
+    /// Total time spent waiting
+    std::chrono::nanoseconds elapsed = { 0ns };
+};
+
+/// @brief Time spent in the steps of constructing a cThread, as reported by cThread::getStartupStats()
+struct startupStats {
+    /// Opening the vFPGA char device
+    std::chrono::nanoseconds open = { 0ns };
+
+    /// Registering the Coyote thread ID with the driver
+    std::chrono::nanoseconds register_ctid = { 0ns };
+
+    /// Obtaining the shell configuration, NUMA node and IP address (if RDMA is enabled)
+    std::chrono::nanoseconds shell_cnfg = { 0ns };
+
+    /// Creating the eventfd and registering it with the interrupt reactor, if a uisr was provided
+    std::chrono::nanoseconds interrupts = { 0ns };
+
+    /// Mapping the vFPGA regions and clearing the completion counters
+    std::chrono::nanoseconds mmap = { 0ns };
+
+    /// Whole constructor
+    std::chrono::nanoseconds total = { 0ns };
+
+    /// Whether the shell configuration was taken from the per-device cache, see cThread::invalidateShellCnfg()
+    bool cnfg_cached = { false };
+};
+
 ///////////////////////////////////////////////////
 //                 COYOTE MEMORY                //
 //////////////////////////////////////////////////
@@ -114,7 +201,27 @@ enum class CoyoteAllocType {
     PRM = 3,
 
     /// Memory on the GPU (for GPU-FPGA DMA)
-    GPU = 4 
+    GPU = 4,
+
+    /// Huge pages of 1GB, regardless of the shell's TLB configuration; requires 1GB pages to be reserved (e.g., hugepagesz=1G hugepages=N)
+    /// NOTE: The driver maps huge pages in chunks of the shell's large TLB page size, so each 1GB page takes (1GB / large TLB page size) TLB entries (e.g., 512 with 2MB);
+    /// the host still benefits from fewer page faults and host TLB misses. Shells with large TLB pages bigger than 1GB can't map these pages, see cThread::getMem()
+    HPF_1G = 5
+};
+
+/// @brief NUMA placement policies for memory allocated through cThread::getMem()
+enum class CoyoteNuma {
+    /// Default system policy; typically, pages are placed on the node of the thread touching them first
+    NONE = 0,
+
+    /// Prefer the node the FPGA is attached to, as reported by the driver
+    DEVICE = 1,
+
+    /// Prefer the node given by CoyoteAlloc::numa_node
+    NODE = 2,
+
+    /// Interleave the pages across all nodes with memory
+    INTERLEAVE = 3
 };
 
 struct CoyoteAlloc {
@@ -137,6 +244,21 @@ struct CoyoteAlloc {
     /// TODO: Add a pointer to some docs, once available
     int32_t mem_block = { -1 };
 
+    /// NUMA placement of the host pages; only applicable to REG, THP and HPF allocations
+    CoyoteNuma numa = { CoyoteNuma::NONE };
+
+    /// Target NUMA node, when numa == CoyoteNuma::NODE
+    int32_t numa_node = { -1 };
+
+    /// Populate (prefault) the pages at allocation, so that the first transfer doesn't go through the page fault path; only applicable to REG, THP and HPF allocations
+    bool populate = { false };
+
+    /// Advise the kernel to back the allocation with transparent huge pages (madvise(MADV_HUGEPAGE)), e.g., when THP is set to "madvise"; only applicable to REG and THP allocations
+    bool thp_advise = { false };
+
+    /// Check which fraction of the allocation is backed by huge pages and warn if not all of it is; see cThread::getHugePageFraction()
+    bool verify_huge = { false };
+
     /// Pointer to the allocated memory; the struct keeps track of it so that it can be freed automatically after use
     void *mem = { nullptr };
 
@@ -146,6 +268,24 @@ struct CoyoteAlloc {
     #endif
 };
 
+/// @brief A host buffer to be mapped into the vFPGA's TLB, see cThread::userMapBatch()
+struct mapRange {
+    /// Buffer address
+    void *vaddr = { nullptr };
+
+    /// Buffer length in bytes
+    uint64_t len = { 0 };
+
+    /// Target memory block on the card; only applicable to Versal devices; otherwise ignored
+    int32_t mem_block = { -1 };
+};
+
+/// @brief Handle of an asynchronous mapping, as returned by cThread::userMapAsync()
+struct mapHandle {
+    /// Sequence number of the mapping; 0 for an empty batch, which is always done
+    uint64_t id = { 0 };
+};
+
 ///////////////////////////////////////////////////
 //             COYOTE SG ENTRIES                //
 //////////////////////////////////////////////////
@@ -169,8 +309,8 @@ struct localSg {
     /// Buffer address
     void* addr = { nullptr };
 
-    /// Buffer length in bytes
-    uint32_t len = { 0 };
+    /// Buffer length in bytes; transfers longer than MAX_TRANSFER_SIZE are split into multiple commands by cThread::invoke()
+    uint64_t len = { 0 };
 
     /// Buffer stream: HOST or CARD
     uint32_t stream = { STRM_HOST };
@@ -200,8 +340,11 @@ struct rdmaSg {
     /// Target AXI4 destination stream; a value of i will write write data to axis_(host|card)_send[i] in the remote vFPGA
     uint32_t remote_dest = { 0 };
 
-    /// Lenght of the RDMA transfer, in bytes
-    uint32_t len = { 0 };
+    /// Lenght of the RDMA transfer, in bytes; transfers longer than MAX_TRANSFER_SIZE are split into multiple commands by cThread::invoke()
+    uint64_t len = { 0 };
+
+    /// Queue pair on which the operation is issued; 0 is the default QP (set up by initRDMA), others are created with cThread::createQp()
+    int32_t qp_id = { 0 };
 };
 
 /// @brief Scatter-gather entry for TCP operations (REMOTE_TCP_SEND)
@@ -211,6 +354,69 @@ struct tcpSg {
     uint32_t len = { 0 };
 };
 
+///////////////////////////////////////////////////
+//              COMMAND ENCODING                //
+//////////////////////////////////////////////////
+
+/// Utility function, encodes the control word of a local DMA command (LOCAL_READ, LOCAL_WRITE, LOCAL_TRANSFER)
+inline uint64_t localCtrlCmd(int32_t ctid, const localSg &sg, bool last) {
+    return
+        ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
+        ((sg.dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
+        (last ? CTRL_LAST : 0x0) |
+        ((sg.stream & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
+        (CTRL_START) | 
+        (0x0) | 
+        (static_cast<uint64_t>(sg.len) << CTRL_LEN_OFFS);
+}
+
+/// Utility function, encodes a one-sided local command (LOCAL_READ or LOCAL_WRITE), in the argument order of postCmd
+inline std::array<uint64_t, 4> localCmd(CoyoteOper oper, int32_t ctid, const localSg &sg, bool last) {
+    uint64_t ctrl_cmd = localCtrlCmd(ctid, sg, last);
+    uint64_t addr_cmd = reinterpret_cast<uint64_t>(sg.addr);
+
+    if (oper == CoyoteOper::LOCAL_READ) {
+        return {0, 0, addr_cmd, ctrl_cmd};
+    } else {
+        return {addr_cmd, ctrl_cmd, 0, 0};
+    }
+}
+
+/// Utility function, encodes an RDMA command (REMOTE_RDMA_READ, REMOTE_RDMA_WRITE), in the argument order of postCmd
+inline std::array<uint64_t, 4> rdmaCmd(CoyoteOper oper, int32_t ctid, const ibvQp &qpair, const rdmaSg &sg, bool last) {
+    // Local command and address
+    uint64_t ctrl_cmd_l =
+        (((static_cast<uint64_t>(oper) - REMOTE_OFFS_OPS) & CTRL_OPCODE_MASK) << CTRL_OPCODE_OFFS) |
+        ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
+        ((sg.local_dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
+        (last ? CTRL_LAST : 0x0) |
+        ((sg.local_stream & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
+        (0x0) | 
+        (static_cast<uint64_t>(sg.len) << CTRL_LEN_OFFS);
+    
+    uint64_t addr_cmd_l = static_cast<uint64_t>((uint64_t) qpair.local.vaddr + sg.local_offs);
+
+    // Remote command and address
+    uint64_t ctrl_cmd_r =                    
+        (((static_cast<uint64_t>(oper) - REMOTE_OFFS_OPS) & CTRL_OPCODE_MASK) << CTRL_OPCODE_OFFS) |
+        ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
+        ((sg.remote_dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
+        (last ? CTRL_LAST : 0x0) |
+        ((STRM_RDMA & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
+        (CTRL_START) |
+        (0x0) | 
+        (static_cast<uint64_t>(sg.len) << CTRL_LEN_OFFS);
+
+    uint64_t addr_cmd_r = static_cast<uint64_t>((uint64_t) qpair.remote.vaddr + sg.remote_offs); 
+
+    // Order - based on the distinction between Read and Write, determine what is source and what is destination 
+    uint64_t ctrl_cmd_src = isRemoteRead(oper) ? ctrl_cmd_r : ctrl_cmd_l;
+    uint64_t addr_cmd_src = isRemoteRead(oper) ? addr_cmd_r : addr_cmd_l;
+    uint64_t ctrl_cmd_dst = isRemoteRead(oper) ? ctrl_cmd_l : ctrl_cmd_r;
+    uint64_t addr_cmd_dst = isRemoteRead(oper) ? addr_cmd_l : addr_cmd_r;
+
+    return {addr_cmd_dst, ctrl_cmd_dst, addr_cmd_src, ctrl_cmd_src};
+}
 
 }
 
@@ -0,0 +1,144 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CPOLLER_HPP_
+#define _COYOTE_CPOLLER_HPP_
+
+#include <array>
+#include <mutex>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+#include <coyote/cOps.hpp>
+#include <coyote/cThread.hpp>
+
+namespace coyote {
+
+/**
+ * @brief Completion poller, which tracks outstanding operations across many cThreads
+ *
+ * Instead of dedicating one thread per cThread that spins on checkCompleted(), operations are registered 
+ * with the poller, together with a callback. Every call to poll() sweeps the completion counters of all 
+ * the cThreads with outstanding operations and invokes the callbacks of the completed ones. Since tickets
+ * of the same type complete in order, each completion counter is read at most once per sweep, 
+ * regardless of the number of outstanding operations. The poller is the building block for the 
+ * C++20 coroutine awaitables in cAsync.hpp, but it can be used on its own from any event loop.
+ *
+ * @note All functions are thread-safe; callbacks are invoked from poll(), outside the internal lock, 
+ * so they may register new operations with the same poller.
+ */
+class cPoller {
+
+private:
+    /// Callback of an outstanding operation, as a plain function pointer and context, to avoid allocations on the hot path
+    struct pendingOp {
+        cmdTicket ticket;
+        void (*callback)(void*);
+        void *ctx;
+    };
+
+    /// Orders outstanding operations such that the one with the lowest (wrap-around safe) ticket is at the top of the queue
+    struct pendingCmp {
+        bool operator()(const pendingOp &a, const pendingOp &b) const {
+            return static_cast<int32_t>(a.ticket.seq - b.ticket.seq) > 0;
+        }
+    };
+
+    typedef std::priority_queue<pendingOp, std::vector<pendingOp>, pendingCmp> pendingQueue;
+
+    /// Completion counters of a cThread are identified by the cThread and the QP; RDMA operations are counted per QP, local ones always under QP 0
+    struct pendingKey {
+        cThread *thread;
+        int32_t qp_id;
+
+        bool operator==(const pendingKey &other) const {
+            return thread == other.thread && qp_id == other.qp_id;
+        }
+    };
+
+    struct pendingKeyHash {
+        size_t operator()(const pendingKey &key) const {
+            return std::hash<cThread*>()(key.thread) ^ (std::hash<int32_t>()(key.qp_id) << 1);
+        }
+    };
+
+    /// Outstanding operations of a cThread and QP, for each of their completion counters (RD_WBACK, WR_WBACK etc.)
+    struct pendingQueues {
+        /// Value of cThread::getClearCount() when the operations were registered; once it changes, their tickets are no longer valid
+        uint32_t n_clears = { 0 };
+        std::array<pendingQueue, N_WBACKS> queues;
+    };
+
+    /// Outstanding operations, for each cThread and QP
+    std::unordered_map<pendingKey, pendingQueues, pendingKeyHash> pending;
+
+    /// Moves all the operations of a cThread and QP to a list of completed ones
+    static void flush(pendingQueues &queues, std::vector<pendingOp> &completed);
+
+    /// Total number of outstanding operations
+    size_t n_pending = { 0 };
+
+    /// Operations without a completion counter (e.g., RDMA loopback copies), which complete on the next sweep
+    std::vector<pendingOp> ready;
+
+    /// Lock for pending, ready and n_pending
+    std::mutex plock;
+
+public:
+    /**
+     * @brief Registers an outstanding operation with the poller
+     *
+     * @param thread cThread on which the operation was invoked; must outlive the operation
+     * @param ticket Completion ticket, as returned by cThread::invoke()
+     * @param callback Function called from poll(), once the operation has completed
+     * @param ctx Argument passed to the callback
+     *
+     * @note Tickets that don't refer to any completion counter (e.g., RDMA loopback copies) are completed on the next poll()
+     * @note Tickets invalidated by cThread::clearCompleted() are completed on the next poll() as well
+     */
+    void enqueue(cThread &thread, cmdTicket ticket, void (*callback)(void*), void *ctx);
+
+    /**
+     * @brief Sweeps the completion counters of all cThreads with outstanding operations and invokes the callbacks of completed ones
+     * @return Number of completed operations
+     */
+    size_t poll();
+
+    /**
+     * @brief Calls poll() until there are no more outstanding operations
+     * @param policy Back-off strategy between sweeps which complete no operations, see CoyoteWait
+     */
+    void drain(waitPolicy policy = {});
+
+    /// Returns the number of outstanding operations
+    size_t getPending();
+};
+
+}
+
+#endif // _COYOTE_CPOLLER_HPP_
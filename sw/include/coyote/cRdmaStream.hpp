@@ -0,0 +1,274 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CRDMASTREAM_HPP_
+#define _COYOTE_CRDMASTREAM_HPP_
+
+#include <deque>
+#include <chrono>
+
+#include <coyote/cDefs.hpp>
+#include <coyote/cOps.hpp>
+#include <coyote/cThread.hpp>
+
+namespace coyote {
+
+/// @brief End of an RDMA stream
+enum class streamRole {
+    SENDER = 0,
+    RECEIVER = 1
+};
+
+/// @brief How the receiver of an RDMA stream returns credits (consumed ring space) to the sender
+enum class streamCredits {
+    /// Small RDMA writes into the RDMA buffer of the sender
+    RDMA = 0,
+    /// Messages on an out-of-band stream socket
+    OOB = 1
+};
+
+/// @brief Configuration of an RDMA stream; the offsets and sizes must be the same on both ends
+struct streamConfig {
+    /// Offset of the ring in the RDMA buffer; on the sender, the same region holds the messages before they are written
+    uint64_t ring_offs = { 0 };
+
+    /// Size of the ring, in bytes; a multiple of STREAM_MSG_ALIGN
+    uint64_t ring_size = { STREAM_DEF_RING_SIZE };
+
+    /// Offset of the STREAM_CTRL_SIZE bytes of control words in the RDMA buffer; must not overlap the ring
+    uint64_t ctrl_offs = { STREAM_DEF_RING_SIZE };
+
+    /// Maximum number of RDMA writes of messages in flight
+    uint32_t window = { STREAM_DEF_WINDOW };
+
+    /// Credit return path
+    streamCredits credits = { streamCredits::RDMA };
+
+    /// Connected stream socket to the other end, for streamCredits::OOB; stays owned by the caller
+    int oob_fd = { -1 };
+
+    /// With streamCredits::OOB, credits are returned once this many bytes have been released, or when the receiver runs out of messages (0: a quarter of the ring)
+    uint64_t credit_batch = { 0 };
+};
+
+/// @brief Statistics of an RDMA stream, as reported by cRdmaStream::getStats()
+struct streamStats {
+    /// Messages and payload bytes sent or received
+    uint64_t n_msgs = { 0 };
+    uint64_t n_bytes = { 0 };
+
+    /// RDMA writes of messages issued by the sender; messages committed while the window is full are coalesced into one write
+    uint64_t n_writes = { 0 };
+
+    /// Number of times and total time the sender was blocked, waiting for credits
+    uint64_t n_stalls = { 0 };
+    std::chrono::nanoseconds stalled = { 0ns };
+};
+
+/**
+ * @brief Continuous stream of variable-sized messages from one node to another, with RDMA writes into a ring
+ *
+ * The ring lives at the same offset in the RDMA buffers of both ends (i.e., the buffers of the queue pair).
+ * The sender builds each message in place in its own copy of the ring (see reserve() and commit()) and writes 
+ * it to the same position of the receiver's ring. Up to streamConfig::window writes are kept in flight; messages 
+ * committed while the window is full are coalesced into a single write once a write completes. Each message starts 
+ * with a small header and occupies a multiple of STREAM_MSG_ALIGN bytes; messages never wrap around the ring.
+ *
+ * Once the completion counter of the queue pair shows that a write has completed, the sender publishes the 
+ * new end of the stream to the receiver with an 8-byte RDMA write. The receiver consumes the messages in place 
+ * and returns the space with credits, either with 8-byte RDMA writes or on an out-of-band socket. 
+ * When the ring is full, the sender blocks (back-pressure) until credits arrive.
+ *
+ * @note Both ends must be constructed, which clears their control words, before the sender starts sending; 
+ * e.g. through cThread::connSync(). Each end must be used by one thread at a time.
+ */
+class cRdmaStream {
+
+private:
+    /// Header of a message in the ring
+    struct streamMsgHdr {
+        /// Payload length; for padding at the end of the ring, the length of the padding, including the header
+        uint32_t len;
+        uint32_t flags;
+    };
+
+    /// Flags of a message header: padding up to the end of the ring
+    static constexpr uint32_t const MSG_PAD = 0x1;
+
+    /// Control words, at streamConfig::ctrl_offs: the end of the stream (written by the sender), credits (written by the receiver) and a staging word for writing either
+    static constexpr uint64_t const CTRL_HEAD = 0;
+    static constexpr uint64_t const CTRL_TAIL = 64;
+    static constexpr uint64_t const CTRL_STAGING = 128;
+
+    /// An RDMA write of messages in flight and the stream position up to which it writes
+    struct streamWrite {
+        cmdTicket ticket;
+        uint64_t end;
+    };
+
+    /// cThread owning the queue pair
+    cThread *cthread;
+
+    /// End of the stream
+    streamRole role;
+
+    /// Configuration, as passed to the constructor
+    streamConfig cnfg;
+
+    /// Queue pair of the stream
+    int32_t qp_id;
+
+    /// Local RDMA buffer of the queue pair
+    char *base;
+
+    /// Statistics
+    streamStats stats;
+
+    /*
+     * Stream positions, in bytes since the start of the stream; the position in the ring is the stream position modulo the ring size
+     * Sender: reserved >= committed >= issued >= completed >= announced, and credited (consumed by the receiver)
+     * Receiver: head (published by the sender) >= next (next message to read) >= tail (released) >= credited (returned to the sender)
+     */
+    uint64_t reserved = { 0 };
+    uint64_t committed = { 0 };
+    uint64_t issued = { 0 };
+    uint64_t completed = { 0 };
+    uint64_t announced = { 0 };
+    uint64_t next = { 0 };
+    uint64_t tail = { 0 };
+    uint64_t credited = { 0 };
+
+    /// Sender: message writes in flight, oldest first
+    std::deque<streamWrite> inflight;
+
+    /// Receiver: end positions of the messages read but not released yet, oldest first
+    std::deque<uint64_t> unreleased;
+
+    /// Ticket of the last control write; the staging word is only re-used once it completed
+    cmdTicket ctrl_ticket;
+
+    /// Partially received credit from the out-of-band socket
+    uint64_t oob_credit = { 0 };
+    uint32_t oob_credit_len = { 0 };
+
+    /// Checks that a function is called on the right end of the stream
+    void checkRole(streamRole expected, const char *func) const;
+
+    /// Reads a control word of the local RDMA buffer, written by the other end
+    uint64_t readCtrl(uint64_t word) const;
+
+    /// Writes a control word into the RDMA buffer of the other end, unless the previous control write is still in flight; returns whether it was written
+    bool writeCtrl(uint64_t word, uint64_t val);
+
+    /// Sender: picks up credits returned by the receiver
+    void readCredits();
+
+    /// Receiver: returns the credits for the released messages, if any
+    void returnCredits(bool force);
+
+    /// Sender: reserves len bytes (a multiple of STREAM_MSG_ALIGN) in the ring, padding up to the end of the ring if needed; returns false if there isn't enough space yet
+    bool tryAdvance(uint64_t len);
+
+    /// Polls until cond() holds or the time-out expires, making progress in the meantime; returns false on time-out
+    template<typename Cond>
+    bool waitFor(Cond cond, std::chrono::nanoseconds timeout);
+
+public:
+    /**
+     * @brief Creates one end of a stream
+     *
+     * @param cthread cThread owning the queue pair
+     * @param role End of the stream
+     * @param cnfg Configuration; the offsets and sizes must match the other end
+     * @param qp_id Queue pair, as returned by cThread::createQp() (default: the default QP)
+     */
+    cRdmaStream(cThread *cthread, streamRole role, streamConfig cnfg = {}, int32_t qp_id = 0);
+
+    /// Sender: waits for all the writes in flight, which still read from the RDMA buffer
+    ~cRdmaStream();
+
+    /**
+     * @brief Sender: reserves space for a message in the ring, blocking while the ring is full
+     *
+     * @param len Payload length, in bytes
+     * @param timeout Maximum time to wait for credits (default: no time-out)
+     * @return Pointer to the payload in the local copy of the ring, valid until commit(); nullptr if the wait timed out
+     */
+    void* reserve(uint64_t len, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+    /// Sender: same as reserve(), but never blocks; returns nullptr if the ring is full
+    void* tryReserve(uint64_t len);
+
+    /// Sender: commits the message from the last reserve(), which is written to the receiver as soon as the window allows
+    void commit();
+
+    /**
+     * @brief Sender: copies a message into the ring and commits it
+     *
+     * @param data Payload
+     * @param len Payload length, in bytes
+     * @param timeout Maximum time to wait for credits (default: no time-out)
+     * @return true if the message was committed, false if the wait timed out
+     */
+    bool send(const void *data, uint64_t len, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+    /**
+     * @brief Sender: blocks until all the committed messages have been written and published to the receiver
+     *
+     * @param timeout Maximum time to wait (default: no time-out)
+     * @return true if all the messages were published, false if the wait timed out
+     */
+    bool flush(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+    /**
+     * @brief Receiver: retrieves the next message, if one has arrived, without blocking
+     *
+     * @param data Set to the payload, in place in the ring; valid until the message is released
+     * @param len Set to the payload length, in bytes
+     * @return true if a message was retrieved
+     */
+    bool poll(const void *&data, uint64_t &len);
+
+    /// Receiver: same as poll(), but blocks until a message arrives or the time-out expires
+    bool recv(const void *&data, uint64_t &len, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+    /// Receiver: releases the oldest retrieved message, returning its space to the sender
+    void release();
+
+    /// Makes progress without blocking: issues coalesced writes, publishes completed ones and exchanges credits
+    void progress();
+
+    /// Getter: statistics
+    streamStats getStats() const;
+
+    /// Resets the statistics
+    void resetStats();
+
+};
+
+}
+
+#endif // _COYOTE_CRDMASTREAM_HPP_
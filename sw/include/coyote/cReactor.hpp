@@ -0,0 +1,173 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CREACTOR_HPP_
+#define _COYOTE_CREACTOR_HPP_
+
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+
+#include <coyote/cDefs.hpp>
+
+namespace coyote {
+
+/**
+ * @brief Process-wide reactor for user interrupts (notifications)
+ *
+ * Instead of one thread (and epoll instance) per cThread, all cThreads with a user interrupt service 
+ * routine (uisr) register their eventfd with the reactor. The reactor runs a small, configurable number 
+ * of threads, each with its own epoll instance; every eventfd is assigned to the least loaded thread. 
+ * Each thread waits for up to MAX_EVENTS notifications at once and dispatches them to the callbacks of the 
+ * corresponding cThreads. Notifications of one cThread are always handled by the same thread, in order.
+ *
+ * @note The callbacks run on the reactor threads, so long-running callbacks delay notifications of other cThreads 
+ * assigned to the same thread; in that case, increase the number of threads with setThreads().
+ */
+class cReactor {
+
+private:
+    /// A registered eventfd and the cThread it belongs to
+    struct eventReg {
+        /// vFPGA device file descriptor, for acknowledging notifications
+        int fd;
+
+        /// Event file descriptor, signalled by the driver
+        int efd;
+
+        /// Coyote thread ID
+        int32_t ctid;
+
+        /// User interrupt service routine
+        std::function<void(int)> uisr;
+
+        /// Index of the reactor thread handling this eventfd
+        uint32_t worker;
+
+        /// Number of dispatches of this eventfd in progress (at most one, since it's handled by one thread); protected by rlock
+        uint32_t in_flight = { 0 };
+
+        /// Reactor thread running the dispatch in progress, if any
+        std::thread::id dispatcher;
+
+        /// Set once the registration is removed; notifications in flight are no longer acknowledged
+        bool removed = { false };
+
+        /// Set if the registration was removed from within its own callback; the dispatch loop releases it afterwards
+        bool orphaned = { false };
+    };
+
+    /// A reactor thread, with its own epoll instance
+    struct reactorWorker {
+        int epoll_fd = { -1 };
+
+        /// Termination event file descriptor for stopping the thread
+        int terminate_efd = { -1 };
+
+        std::thread thread;
+
+        /// Number of eventfds assigned to this thread
+        uint32_t n_regs = { 0 };
+    };
+
+    /// Reactor threads; started on the first registration
+    std::vector<std::unique_ptr<reactorWorker>> workers;
+
+    /// Registrations, keyed by their eventfd
+    std::unordered_map<int, std::unique_ptr<eventReg>> regs;
+
+    /// Lock for workers, regs and the dispatch state of the registrations
+    std::mutex rlock;
+
+    /// Signalled whenever a dispatch completes; unregistering waits on it, for the dispatch of its registration only
+    std::condition_variable rcond;
+
+    /// Number of reactor threads to start
+    uint32_t n_threads = { REACTOR_DEF_THREADS };
+
+    cReactor() = default;
+
+    /// Starts the reactor threads; must be called with rlock held
+    void start();
+
+    /// Main loop of a reactor thread
+    void run(reactorWorker *worker);
+
+    /// Reads a notification of a registration and calls its callback; must be called without holding rlock
+    void dispatch(eventReg *reg);
+
+public:
+    /**
+     * @brief Returns the process-wide reactor instance ("singleton" implementation)
+     */
+    static cReactor& getInstance();
+
+    /**
+     * @brief Default destructor; stops all reactor threads
+     */
+    ~cReactor();
+
+    cReactor(const cReactor&) = delete;
+    cReactor& operator=(const cReactor&) = delete;
+
+    /**
+     * @brief Sets the number of reactor threads
+     *
+     * @param n Number of threads; must be at least 1
+     * @note Only takes effect if called before the first cThread with a uisr is created; ignored afterwards
+     */
+    void setThreads(uint32_t n);
+
+    /**
+     * @brief Registers an eventfd of a cThread with the reactor
+     *
+     * @param fd vFPGA device file descriptor of the cThread
+     * @param efd Non-blocking event file descriptor, signalled by the driver on notifications
+     * @param ctid Coyote thread ID
+     * @param uisr User interrupt service routine, called with the notification value
+     */
+    void registerEvents(int fd, int efd, int32_t ctid, std::function<void(int)> uisr);
+
+    /**
+     * @brief Removes an eventfd from the reactor
+     *
+     * Once this function returns, the callback of the eventfd is not running and will not be called anymore,
+     * unless called from within that callback, in which case the callback completes normally. Only the callback
+     * of this eventfd is waited for, so callbacks may unregister the eventfds of other threads; however, two callbacks 
+     * which unregister each other's eventfds at the same time wait for each other indefinitely.
+     *
+     * @param efd Event file descriptor, as passed to registerEvents()
+     */
+    void unregisterEvents(int efd);
+};
+
+}
+
+#endif // _COYOTE_CREACTOR_HPP_
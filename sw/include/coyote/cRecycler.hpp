@@ -0,0 +1,160 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CRECYCLER_HPP_
+#define _COYOTE_CRECYCLER_HPP_
+
+#include <map>
+#include <list>
+#include <deque>
+#include <tuple>
+#include <chrono>
+#include <vector>
+#include <functional>
+
+#include <coyote/cDefs.hpp>
+#include <coyote/cOps.hpp>
+
+namespace coyote {
+
+/// @brief Buffer recycling statistics
+struct recycleStats {
+    /// Number of getMem() calls served with a recycled buffer; each one avoided a map and an unmap round-trip to the driver
+    uint64_t n_hits = { 0 };
+
+    /// Number of getMem() calls for which no recycled buffer of matching type and size was available
+    uint64_t n_misses = { 0 };
+
+    /// Number of buffers kept mapped on freeMem(), instead of being unmapped and released
+    uint64_t n_recycled = { 0 };
+
+    /// Number of recycled buffers released to stay within the budget
+    uint64_t n_evictions = { 0 };
+
+    /// Number of recycled buffers released after staying unused for longer than the idle time-out
+    uint64_t n_expired = { 0 };
+
+    /// Number of buffers currently kept for recycling
+    uint64_t n_buffers = { 0 };
+
+    /// Memory currently kept for recycling, in bytes
+    uint64_t cached_bytes = { 0 };
+
+    /// Budget for recycled buffers, in bytes
+    uint64_t budget = { 0 };
+};
+
+/**
+ * @brief Keeps freed buffers mapped, so that later allocations of the same type and size can reuse them
+ *
+ * Freeing a buffer from cThread::getMem() unmaps it from the vFPGA's TLB, which invalidates the TLB entries
+ * and unpins the pages, and releases the memory; allocating it again repeats the whole process.
+ * With recycling, freed buffers are put into buckets, keyed by their type, size, memory block and NUMA placement, 
+ * and handed out again, still mapped, by later allocations with the same properties. The most recently freed 
+ * buffer of a bucket is reused first, since it is the most likely to be cache-warm.
+ *
+ * Buffers are released (in batches) in the order they were freed, once the memory kept exceeds a budget or
+ * once they stay unused for longer than an idle time-out. The time-out is only checked when buffers
+ * are recycled, or when trim() is called explicitly; there is no background thread.
+ */
+class cRecycler {
+
+public:
+    /// Releases a batch of buffers, which are still mapped, e.g., via cThread::unmapHostMemBatch()
+    using releaseFn = std::function<void(const std::vector<std::pair<void*, CoyoteAlloc>>&)>;
+
+private:
+    /// A buffer kept for recycling
+    struct recycledBuff {
+        void *vaddr;
+        CoyoteAlloc alloc;
+
+        /// Time the buffer was freed
+        std::chrono::steady_clock::time_point freed;
+    };
+
+    /// Properties a recycled buffer must match: type, size, memory block, NUMA policy and node
+    using recycleKey = std::tuple<CoyoteAllocType, uint64_t, int32_t, CoyoteNuma, int32_t>;
+
+    /// Buffers, least recently freed first; iterators stay valid, so that buckets can refer to them
+    std::list<recycledBuff> buffs;
+
+    /// Buckets of buffers with the same properties; each bucket is ordered in the same way as buffs
+    std::map<recycleKey, std::deque<std::list<recycledBuff>::iterator>> buckets;
+
+    releaseFn release_fn;
+
+    uint64_t budget;
+    std::chrono::nanoseconds idle_timeout;
+    recycleStats stats;
+
+    static recycleKey makeKey(const CoyoteAlloc &alloc);
+
+    /// Releases the least recently freed buffers while the condition holds for the oldest one
+    void releaseOldest(const std::function<bool(const recycledBuff&)> &cond, uint64_t &counter);
+
+public:
+    /**
+     * @brief Constructs an empty recycler
+     *
+     * @param budget Maximum memory kept for recycling, in bytes
+     * @param idle_timeout Time after which unused buffers are released
+     * @param release_fn Releases a batch of buffers which are no longer recycled
+     */
+    cRecycler(uint64_t budget, std::chrono::nanoseconds idle_timeout, releaseFn release_fn);
+
+    /**
+     * @brief Default destructor; releases all the buffers kept for recycling
+     */
+    ~cRecycler();
+
+    /**
+     * @brief Keeps a freed buffer for recycling
+     *
+     * @param vaddr Virtual address of the buffer, which must still be mapped
+     * @param alloc Allocation parameters, as passed to cThread::getMem()
+     * @return true if the buffer is kept; false if it is larger than the budget, in which case the caller must release it
+     */
+    bool put(void *vaddr, const CoyoteAlloc &alloc);
+
+    /**
+     * @brief Takes a recycled buffer with matching type, size, memory block and NUMA placement
+     *
+     * @param alloc Allocation parameters, as passed to cThread::getMem()
+     * @return Virtual address of the buffer, or nullptr if none is available
+     */
+    void* get(const CoyoteAlloc &alloc);
+
+    /// Releases the buffers which have been unused for longer than the idle time-out
+    void trim();
+
+    /// Returns the recycling statistics
+    recycleStats getStats() const;
+};
+
+}
+
+#endif // _COYOTE_CRECYCLER_HPP_
@@ -0,0 +1,198 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CREGCACHE_HPP_
+#define _COYOTE_CREGCACHE_HPP_
+
+#include <map>
+#include <list>
+#include <vector>
+#include <functional>
+
+#include <coyote/cOps.hpp>
+#include <coyote/cDefs.hpp>
+
+namespace coyote {
+
+/// @brief Registration cache statistics
+struct regCacheStats {
+    /// Number of lookups where the whole buffer was already registered
+    uint64_t n_hits = { 0 };
+
+    /// Number of lookups where (parts of) the buffer had to be registered
+    uint64_t n_misses = { 0 };
+
+    /// Number of cached registrations released to stay within the budget
+    uint64_t n_evictions = { 0 };
+
+    /// Number of registered ranges currently tracked, including explicit mappings
+    uint64_t n_entries = { 0 };
+
+    /// Memory currently pinned by cached (evictable) registrations, in bytes
+    uint64_t cached_bytes = { 0 };
+
+    /// Budget for cached registrations, in bytes
+    uint64_t budget = { 0 };
+};
+
+/**
+ * @brief Registration cache, tracking which virtual address ranges are mapped into the vFPGA's TLB
+ *
+ * Buffers which were never mapped with userMap() are only mapped once the vFPGA accesses them, 
+ * through an expensive page fault round-trip via the driver. The registration cache avoids this,
+ * by registering such buffers when they are passed to invoke() and keeping them registered, 
+ * such that buffers which are used repeatedly are only registered once. Registered ranges are 
+ * kept in an interval map, ordered by their start address; on a miss, only the parts of a buffer 
+ * that are not registered yet are mapped. Cached registrations are released in least-recently-used 
+ * order, once the memory pinned by them exceeds a budget.
+ * 
+ * Explicit mappings (userMap(), getMem()) are tracked as well, but never evicted by the cache.
+ *
+ * Registrations used by an operation are never evicted before the operation completes: ensure() marks 
+ * them as pending, and hold() attaches the completion ticket of the operation once it is issued. If all
+ * cached registrations are in use, the budget is temporarily exceeded, until their operations complete.
+ *
+ * @note The cache is not thread-safe; ensure() and hold() for the same operation must be called without 
+ * any other operation being registered in between (in cThread, under the submission lock).
+ */
+class cRegCache {
+
+private:
+    /// A registered range [start, end), with page-aligned bounds
+    struct regEntry {
+        uint64_t end;
+
+        /// Explicit mappings are never evicted by the cache
+        bool pinned;
+
+        /// Position in the LRU list; only valid for cached (not pinned) entries
+        std::list<uint64_t>::iterator lru;
+
+        /// Registered by ensure() for an operation which was not issued yet, see hold()
+        bool pending;
+
+        /// Completion tickets of outstanding operations using the entry; at most one per counter
+        std::vector<cmdTicket> tickets;
+    };
+
+    /// Registered ranges, keyed by their start address; ranges never overlap
+    std::map<uint64_t, regEntry> entries;
+
+    /// Start addresses of cached entries, most recently used first
+    std::list<uint64_t> lru;
+
+    /// Start addresses of the entries marked as pending since the last call to hold()
+    std::vector<uint64_t> pending;
+
+    /// Functions for registering and releasing a range in the vFPGA's TLB
+    std::function<void(void*, uint64_t)> map_fn;
+    std::function<void(void*)> unmap_fn;
+
+    /// Checks whether the operation corresponding to a completion ticket has completed
+    std::function<bool(const cmdTicket&)> done_fn;
+
+    uint64_t budget;
+    regCacheStats stats;
+
+    /// Releases a cached entry and removes it from the cache
+    std::map<uint64_t, regEntry>::iterator evict(std::map<uint64_t, regEntry>::iterator it);
+
+    /// Checks whether an entry is used by a pending or outstanding operation; drops the tickets of completed ones
+    bool inUse(regEntry &entry);
+
+public:
+    /**
+     * @brief Constructs an empty registration cache
+     *
+     * @param budget Maximum memory pinned by cached registrations, in bytes
+     * @param map_fn Registers a range in the vFPGA's TLB (address, length)
+     * @param unmap_fn Releases a previously registered range, identified by its start address
+     * @param done_fn Checks whether the operation corresponding to a completion ticket has completed
+     */
+    cRegCache(
+        uint64_t budget, std::function<void(void*, uint64_t)> map_fn, std::function<void(void*)> unmap_fn,
+        std::function<bool(const cmdTicket&)> done_fn
+    );
+
+    /**
+     * @brief Default destructor; releases all cached registrations, explicit mappings are left as-is
+     *
+     * Registrations used by outstanding operations are only released once their operations complete.
+     */
+    ~cRegCache();
+
+    /**
+     * @brief Ensures a buffer is registered, registering any part of it that is not
+     *
+     * The registrations covering the buffer are marked as pending and can't be evicted until the
+     * operation using them is issued and completes, see hold().
+     *
+     * @param vaddr Virtual address of the buffer
+     * @param len Length of the buffer, in bytes
+     * @return true if the buffer was already fully registered (hit), false otherwise (miss)
+     */
+    bool ensure(const void *vaddr, uint64_t len);
+
+    /**
+     * @brief Attaches the completion ticket of an issued operation to the registrations marked as pending by ensure()
+     *
+     * @param ticket Completion ticket of the operation; an empty ticket (e.g., if the operation was not issued) releases them right away
+     */
+    void hold(cmdTicket ticket);
+
+    /**
+     * @brief Records an explicit mapping, which is never evicted by the cache
+     * 
+     * @note Cached registrations overlapping the range should be invalidated before mapping it, see invalidate()
+     */
+    void insertPinned(const void *vaddr, uint64_t len);
+
+    /// Removes an explicit mapping, previously recorded with insertPinned(); the caller is responsible for releasing it
+    void removePinned(const void *vaddr);
+
+    /**
+     * @brief Releases all cached registrations overlapping a range; explicit mappings are left as-is
+     *
+     * Must be called before the memory backing cached registrations is released (e.g., with munmap or free), 
+     * since the cache has no way to detect this on its own. Registrations are released even if they are 
+     * still in use; hence, the operations using the memory must be completed beforehand.
+     */
+    void invalidate(const void *vaddr, uint64_t len);
+
+    /**
+     * @brief Drops the completion tickets of all registrations, e.g., once they are invalidated by cThread::clearCompleted()
+     *
+     * Registrations marked as pending by ensure() stay pending until hold() is called.
+     */
+    void releaseAll();
+
+    /// Returns the cache statistics
+    regCacheStats getStats() const;
+};
+
+}
+
+#endif // _COYOTE_CREGCACHE_HPP_
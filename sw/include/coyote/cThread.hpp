@@ -27,6 +27,12 @@
 #ifndef _COYOTE_CTHREAD_HPP_
 #define _COYOTE_CTHREAD_HPP_
 
+#include <map>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <vector>
 #include <thread>
 #include <functional>
 #include <unordered_map>
@@ -53,9 +59,42 @@
 
 #include <coyote/cDefs.hpp>
 #include <coyote/cOps.hpp>
+#include <coyote/cRegCache.hpp>
+#include <coyote/cRecycler.hpp>
+#include <coyote/cCmdTemplate.hpp>
+#include <coyote/cCopyEngine.hpp>
 
 namespace coyote {
 
+/**
+ * @brief An additional queue pair of a cThread, see cThread::createQp()
+ *
+ * The vFPGA identifies QPs (and their completion counters) by the Coyote thread ID in each command; 
+ * therefore, every additional QP is backed by its own ctid, registered under the same host process ID.
+ */
+struct qpEntry {
+    /// Coyote thread ID backing the QP; determines the QPN and the completion counters of the QP
+    int32_t ctid = { -1 };
+
+    /// Local and remote QP
+    ibvQp qpair;
+
+    /// Number of issued RDMA operations with last set, indexed as the writeback counters; used for completion tickets
+    uint32_t cmpl_issued[N_WBACKS] = { 0 };
+
+    /// Completion counters of loopback RDMA operations on this QP, indexed as the writeback counters
+    copyCounter loopback_cmpl[N_WBACKS];
+};
+
+/// @brief A batch of buffers being mapped in the background, see cThread::userMapAsync()
+struct pendingMap {
+    /// Buffers of the batch
+    std::vector<mapRange> ranges;
+
+    /// Return code of the driver for every buffer, once the batch has been mapped
+    std::future<std::vector<int>> codes;
+};
+
 /**
  * @brief The cThread class is the core component of Coyote for interacting with vFPGAs
  *
@@ -81,20 +120,44 @@ protected:
 	/// Shell configuration, as set by the user in CMake config
 	fpgaCnfg fcnfg; 
 
+	/// NUMA node the FPGA is attached to, as reported by the driver; -1 if unknown
+	int32_t numa_node = { -1 };
+
 	/// RDMA queue pair
     std::unique_ptr<ibvQp> qpair; 
 
+	/// Additional RDMA queue pairs, created with createQp(), keyed by their QP id; the default QP (qpair) has id 0
+	std::map<int32_t, std::unique_ptr<qpEntry>> qp_table;
+
+	/// QP id assigned by the next call to createQp()
+	int32_t next_qp_id = { 1 };
+
 	/// Number data transfer commands sent to the vFPGA
 	uint32_t cmd_cnt = { 0 };
 
-	/// User interrupt file descriptor
+	/// If set, multiple software threads may submit operations through this cThread concurrently; see setMultiProducer()
+	bool multi_producer = { false };
+
+	/// Serializes command submission (credits, register writes and completion tickets) in multi-producer mode
+	std::recursive_mutex submit_lock;
+
+	/// Number of issued operations with last set, for each writeback counter (RD_WBACK, WR_WBACK etc.); used for completion tickets
+	uint32_t cmpl_issued[N_WBACKS] = { 0 };
+
+	/// Number of calls to clearCompleted(); read by cPoller from other threads
+	std::atomic<uint32_t> n_clears = { 0 };
+
+	/// User interrupt file descriptor; registered with the process-wide interrupt reactor, see cReactor
 	int32_t efd = { -1 };
 
-	/// Termination event file descriptor for stopping the user interrupt thread
-	int32_t terminate_efd = { -1 };
+	/// Notification ring, shared with the driver, if enabled; see enableNotifyRing()
+	notifyRing *notify_ring = { nullptr };
+
+	/// Event file descriptor, signalled by the driver when a notification is queued while blocked in waitNotification()
+	int32_t notify_efd = { -1 };
 
-	/// Dedicated thread for handling user interrupts
-	std::thread event_thread;
+	/// Completion counters of RDMA operations between this cThread and itself (loopback), executed by the copy engine; indexed as the writeback counters
+	copyCounter loopback_cmpl[N_WBACKS];
 
 	/// vFPGA config registers, if AVX is enabled, as implemented in cnfg_slave_avx.sv; used mainly for starting DMA commands
 	#ifdef EN_AVX
@@ -104,18 +167,41 @@ protected:
 	/// vFPGA config registers, if AVX is disabled, as implemented in cnfg_slave.sv; used mainly for starting DMA commands
 	volatile uint64_t *cnfg_reg = { 0 };
 	
-	/// User-defined control registers, which can be parsed using axi_ctrl in the vFPGA
-	volatile uint64_t *ctrl_reg = { 0 };
+	/// User-defined control registers, which can be parsed using axi_ctrl in the vFPGA; only mapped on first use, see mmapCtrl()
+	mutable volatile uint64_t *ctrl_reg = { 0 };
+	mutable std::once_flag ctrl_reg_once;
 
 	/// Pointer to writeback region, if enabled
 	volatile uint32_t *wback = { 0 };
 
-	/// A map of all the pages that have been allocated and mapped for this thread
-	std::unordered_map<void*, CoyoteAlloc> mapped_pages;
+	/// A map of all the pages that have been allocated and mapped for this thread, ordered by their virtual address
+	std::map<void*, CoyoteAlloc> mapped_pages;
+
+	/// All buffers mapped into the vFPGA's TLB through userMap (including those from getMem), as [start, end), keyed by their start address
+	std::map<uint64_t, uint64_t> mapped_ranges;
+
+	/// Last range that satisfied a lookup in isMapped(); consecutive operations typically target the same buffer
+	mutable uint64_t last_mapped_start = { 0 };
+	mutable uint64_t last_mapped_end = { 0 };
+
+	/// If set, invoke() checks that buffers are mapped before issuing operations; see setValidation()
+	bool validate_sg = { false };
 
 	/// Tracks dmabuf file descriptors for GPU allocations registered via userMap
 	std::unordered_map<void*, int32_t> gpu_dmabuf_fds;
 
+	/// Registration cache for buffers passed to invoke(), if enabled; see enableRegCache()
+	std::unique_ptr<cRegCache> reg_cache;
+
+	/// Asynchronous mappings which haven't been waited for, keyed by their handle; see userMapAsync()
+	std::map<uint64_t, pendingMap> pending_maps;
+
+	/// Handle of the next asynchronous mapping
+	uint64_t next_map_id = { 1 };
+
+	/// Freed host buffers which are kept mapped for later allocations, if enabled; see enableRecycling()
+	std::unique_ptr<cRecycler> recycler;
+
 	/** 
 	 * Out-of-band connection file descriptor to a remote node
 	 * This connection is primarily used for exchanging of QPs and syncing (barriers) between operations
@@ -132,12 +218,19 @@ protected:
 	/// Set to true if there is an active out-of-band connection to a remote node for this cThread
 	bool is_connected;
 
-	/// Inter-process vFPGA lock, see lock() and unlock() functions for more details
-	boost::interprocess::named_mutex vlock;
+	/// Inter-process vFPGA lock, see lock() and unlock() functions for more details; only opened on first use, since it touches the file system
+	std::unique_ptr<boost::interprocess::named_mutex> vlock;
+	std::string vlock_name;
 
 	/// Set to true if the vFPGA lock is acquired by this cThread; used to release the lock in the destructor
 	bool lock_acquired = { false };
+
+	/// Time spent in the steps of the constructor
+	startupStats startup_stats;
 	
+	/// Utility function, memory mapping the user-defined control registers; called on the first getCSR() or setCSR()
+	void mmapCtrl() const;
+
 	/// Utility function, memory mapping all the vFPGA control registers and writeback regions
 	void mmapFpga();
 
@@ -156,6 +249,149 @@ protected:
 	 */
 	void postCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_t offs_0);
 
+	/**
+	 * @brief Blocks until the vFPGA command FIFO can accept at least one more command
+	 *
+	 * The outstanding command count (cmd_cnt) is only re-read from the CTRL_REG when the locally
+	 * tracked count doesn't leave room for all n commands; therefore, reserving credits for a
+	 * whole batch requires a single MMIO read in the common case, instead of one per command.
+	 * @param n Number of commands the caller would like to post
+	 * @return Number of commands (between 1 and n) that can be written to the FIFO without oversaturating it
+	 */
+	uint32_t waitCmdCredits(uint32_t n);
+
+	/**
+	 * @brief Writes a DMA command to the vFPGA config registers, without checking for credits or updating cmd_cnt
+	 * @note Same arguments as postCmd; callers must reserve credits with waitCmdCredits beforehand
+	 */
+	void writeCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_t offs_0);
+
+	/**
+	 * @brief Posts a sequence of pre-encoded DMA commands to the vFPGA, in order
+	 *
+	 * Commands are written back-to-back in bursts, as large as the free space in the command FIFO allows.
+	 * @param cmds Encoded commands; each entry holds the four offsets in the same order as the arguments of postCmd
+	 */
+	void postCmds(const std::vector<std::array<uint64_t, 4>> &cmds);
+
+	/**
+	 * @brief Creates the completion ticket for an invoked operation and updates the issued operation counts
+	 *
+	 * @param oper Invoked operation
+	 * @param last Whether the operation was invoked with last set; if not, the ticket completes with the next operation that has last set
+	 * @return Completion ticket of the operation
+	 */
+	cmdTicket issueTicket(CoyoteOper oper, bool last, int32_t qp_id = 0);
+
+	/**
+	 * @brief Looks up an additional queue pair in the QP table
+	 *
+	 * @param qp_id QP id, as returned by createQp()
+	 * @return The QP table entry; nullptr for the default QP (id 0), which is kept in qpair
+	 * @throws std::runtime_error if there is no QP with the given id
+	 */
+	qpEntry* findQp(int32_t qp_id) const;
+
+	/// Resets the completion counters of a Coyote thread ID, in the writeback region and in the vFPGA
+	void clearCounters(int32_t target_ctid);
+
+	/**
+	 * @brief Maps a host buffer into the vFPGA's TLB via IOCTL_MAP_USER_MEM; same arguments as userMap, but without any book-keeping
+	 */
+	void mapHostMem(void *vaddr, uint64_t len, int32_t mem_block);
+
+	/**
+	 * @brief Unmaps a host buffer from the vFPGA's TLB via IOCTL_UNMAP_USER_MEM, without any book-keeping
+	 */
+	void unmapHostMem(void *vaddr);
+
+	/**
+	 * @brief Maps a batch of host buffers via IOCTL_MAP_USER_MEM_BATCH, without any book-keeping
+	 *
+	 * Falls back to one IOCTL_MAP_USER_MEM per buffer for buffers the driver didn't process (e.g., older drivers without batching).
+	 * Only uses the device file and the ctid, so it can run in a background thread.
+	 *
+	 * @return Return code of the driver for every buffer
+	 */
+	std::vector<int> mapHostMemBatch(const std::vector<mapRange> &ranges) const;
+
+	/// Unmaps a batch of host buffers via IOCTL_UNMAP_USER_MEM_BATCH, without any book-keeping
+	void unmapHostMemBatch(const std::vector<void*> &vaddrs);
+
+	/// Records the buffers of a mapped batch, given the return codes of the driver; throws if any of them failed to map
+	void finishMapBatch(const std::vector<mapRange> &ranges, const std::vector<int> &codes);
+
+	/// Releases the memory of a host allocation from getMem(), once it has been unmapped
+	void releaseHostAlloc(void *vaddr, const CoyoteAlloc &alloc);
+
+	/// Unmaps and releases a batch of recycled buffers; see enableRecycling()
+	void releaseRecycled(const std::vector<std::pair<void*, CoyoteAlloc>> &buffs);
+
+	/// Records a buffer mapped with userMap in mapped_ranges
+	void trackMapping(void *vaddr, uint64_t len);
+
+	/// Removes a buffer from mapped_ranges
+	void untrackMapping(void *vaddr);
+
+	/// Throws an std::runtime_error if the buffer is not fully mapped, see isMapped()
+	void checkMapped(const void *vaddr, uint64_t len) const;
+
+	/**
+	 * @brief Executes an RDMA operation between this cThread and itself (loopback) with the copy engine, see cCopyEngine
+	 *
+	 * The copy may complete asynchronously; it increments the loopback completion counter of the operation, 
+	 * which checkCompleted() adds to the hardware counter, so tickets behave the same as for remote nodes.
+	 */
+	void loopbackCopy(CoyoteOper oper, const rdmaSg &sg, bool last);
+
+	/**
+	 * @brief Scope of a submission, see lockSubmission()
+	 *
+	 * If the submission fails before holdBuffers() is called (e.g., a later buffer can't be registered or an argument
+	 * is invalid), the registrations marked as pending by prepareBuffer() are released when the scope is left.
+	 */
+	struct submissionGuard {
+		std::unique_lock<std::recursive_mutex> lock;
+		cRegCache *reg_cache;
+
+		~submissionGuard() {
+			if (reg_cache) {
+				reg_cache->hold({});
+			}
+		}
+	};
+
+	/// Acquires submit_lock in multi-producer mode; otherwise, the lock is empty, so single-producer submission stays lock-free
+	inline submissionGuard lockSubmission() {
+		return {
+			multi_producer ? std::unique_lock<std::recursive_mutex>(submit_lock) : std::unique_lock<std::recursive_mutex>(),
+			reg_cache.get()
+		};
+	}
+
+	/**
+	 * @brief Registers (if the registration cache is enabled) or validates (if validation is enabled) a buffer used in a local operation
+	 *
+	 * @note Neither the registration cache nor the lookup cache of isMapped() are thread-safe; the caller must hold the
+	 * submission lock (see lockSubmission()) until the operation is issued and holdBuffers() is called, so that other
+	 * producers can't evict the registration in between
+	 */
+	inline void prepareBuffer(const void *vaddr, uint64_t len) {
+		if (reg_cache) {
+			reg_cache->ensure(vaddr, len);
+		} else if (validate_sg) {
+			checkMapped(vaddr, len);
+		}
+	}
+
+	/// Keeps the registrations of the buffers passed to prepareBuffer() from being evicted until the operation completes; returns the ticket
+	inline cmdTicket holdBuffers(cmdTicket ticket) {
+		if (reg_cache) {
+			reg_cache->hold(ticket);
+		}
+		return ticket;
+	}
+
 	/**
 	 * @brief Sends an ack to the connected remote node via the out-of-band channel
 	 *
@@ -173,6 +409,20 @@ protected:
 	 */
     uint32_t readAck();
 
+	/**
+	 * @brief Constructs a cThread which is not backed by a vFPGA, for benchmarking and testing the software paths
+	 *
+	 * The config registers, user CSRs and writeback region are anonymous host memory, and the driver is not involved; 
+	 * operations which need it (e.g., mapping memory or interrupts) fail, with the exception of createQp() and destroyQp().
+	 * Commands are written to memory and nothing completes on its own, so the caller is responsible for emulating the vFPGA: 
+	 * since commands and the outstanding command count share CTRL_REG, the count has to be reset after commands are written, 
+	 * and the completion counters in the writeback region (or STAT_DMA_REG) have to be advanced.
+	 *
+	 * @param cnfg Shell configuration to emulate
+	 * @param ctid Coyote thread ID
+	 */
+	cThread(const fpgaCnfg &cnfg, int32_t ctid = 0);
+
 	public:
 	/**
 	 * @brief Writes an IP address to a config register so it can be used for ARP lookup
@@ -185,6 +435,9 @@ protected:
 	 * @param ip_addr IP address to be looked up
 	 */
 	void writeQpContext(uint32_t port);
+
+	/// Same as above, for the given queue pair
+	void writeQpContext(const ibvQp &qp, uint32_t port);
 	
 
 	/**
@@ -192,7 +445,8 @@ protected:
 	 * @param vfid Virtual FPGA ID
 	 * @param hpid Host process ID
 	 * @param device Device number, for systems with multiple vFPGAs
-	 * @param uisr User interrupt (notifications) service routine, called when an interrupt from the vFPGA is received
+	 * @param uisr User interrupt (notifications) service routine, called when an interrupt from the vFPGA is received;
+	 *		runs on one of the threads of the process-wide interrupt reactor, see cReactor
 	 */
 	cThread(int32_t vfid, pid_t hpid, uint32_t device = 0, std::function<void(int)> uisr = nullptr);
 	
@@ -226,6 +480,55 @@ protected:
 	 */
 	void userUnmap(void *vaddr);
 
+	/**
+	 * @brief Maps a batch of buffers to the vFPGA's TLB
+	 *
+	 * Same as calling userMap() for every buffer, but host buffers are mapped with one ioctl per MAP_BATCH_MAX buffers,
+	 * during which the driver takes its MMU and TLB locks only once. GPU memory is still mapped one buffer at a time.
+	 * Buffers which were mapped stay mapped, even if others in the batch failed.
+	 *
+	 * @param ranges Buffers to be mapped
+	 * @throws std::runtime_error if any of the buffers couldn't be mapped
+	 */
+	void userMapBatch(const std::vector<mapRange> &ranges);
+
+	/**
+	 * @brief Maps a batch of buffers to the vFPGA's TLB in a background thread
+	 *
+	 * The calling thread may carry on (e.g., with operations on other buffers), while the driver pins the pages and 
+	 * writes the TLB entries. The buffers of the batch are only considered mapped (e.g., by isMapped()) once 
+	 * waitMap() has returned true for the handle; before that, they must not be used in any operation.
+	 *
+	 * @param ranges Buffers to be mapped
+	 * @return Handle of the mapping, see waitMap()
+	 * @note Without GPU support, GPU memory is mapped synchronously, as with userMapBatch(), and an already completed handle is returned
+	 */
+	mapHandle userMapAsync(std::vector<mapRange> ranges);
+
+	/**
+	 * @brief Blocks until an asynchronous mapping has completed
+	 *
+	 * @param handle Handle, as returned by userMapAsync()
+	 * @param timeout Maximum time to wait (default: no time-out)
+	 * @return true if the mapping completed (or the handle was already waited for), false if the wait timed out
+	 * @throws std::runtime_error if any of the buffers couldn't be mapped
+	 */
+	bool waitMap(mapHandle handle, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+	/**
+	 * @brief Unmaps a batch of buffers from the vFPGA's TLB
+	 *
+	 * Same as calling userUnmap() for every buffer, but host buffers are unmapped with one ioctl per MAP_BATCH_MAX buffers.
+	 *
+	 * @param vaddrs Virtual addresses of the buffers, as passed when mapping them
+	 *
+	 * @note If the driver was loaded with HMM enabled, host buffers are not pinned when mapped and unmapping them 
+	 * releases nothing in the driver, for userUnmap() and userUnmapBatch() alike; the buffers are only removed 
+	 * from the mapped ranges (see isMapped()). The driver rejects the batched ioctl in that case, and every buffer 
+	 * takes the same path as in userUnmap().
+	 */
+	void userUnmapBatch(const std::vector<void*> &vaddrs);
+
 	/**
 	 * @brief Allocates memory for this cThread and maps it into the vFPGA's TLB
 	 *
@@ -238,9 +541,131 @@ protected:
 	 * @brief Frees and unmaps previously allocated memory
 	 *
 	 * @param vaddr Virtual address of the buffer to be freed
+	 * @note With recycling enabled, host buffers are kept mapped for later calls to getMem(); see enableRecycling()
 	 */
 	void freeMem(void* vaddr);
 
+	/**
+	 * @brief Returns the fraction of a host buffer that is backed by huge pages (hugetlbfs or transparent huge pages)
+	 *
+	 * Obtained from /proc/self/smaps; for transparent huge pages in a memory area that only partially overlaps the buffer,
+	 * the huge pages are assumed to be spread evenly across the area.
+	 *
+	 * @param vaddr Virtual address of the buffer
+	 * @param len Length of the buffer, in bytes
+	 * @return Fraction between 0 and 1; 0 if the memory areas can't be read
+	 */
+	double getHugePageFraction(const void *vaddr, uint64_t len) const;
+
+	/**
+	 * @brief Enables the registration cache for this cThread
+	 *
+	 * With the cache enabled, host buffers passed to invoke() for local operations are registered with the vFPGA's TLB,
+	 * if they aren't already, and stay registered for subsequent operations. This avoids the page fault round-trip
+	 * when the vFPGA accesses buffers which were never mapped with userMap(). Cached registrations are released in 
+	 * least-recently-used order once the memory pinned by them exceeds the budget, but never while an operation
+	 * using them is outstanding. Buffers from getMem() and explicit userMap() calls are tracked by the cache, 
+	 * but never released by it.
+	 *
+	 * @param budget Maximum memory pinned by cached registrations, in bytes
+	 *
+	 * @note Should be enabled before any explicit userMap() calls; buffers mapped before are unknown to the cache, 
+	 * unless they were obtained with getMem()
+	 * @note Before releasing memory with cached registrations (e.g., with free or munmap), invalidateRegCache() must be called
+	 */
+	void enableRegCache(uint64_t budget = REG_CACHE_DEF_BUDGET);
+
+	/**
+	 * @brief Disables the registration cache and releases all cached registrations
+	 *
+	 * @note Blocks until the outstanding operations on buffers registered by the cache complete
+	 */
+	void disableRegCache();
+
+	/**
+	 * @brief Releases cached registrations overlapping a buffer; no-op if the registration cache is disabled
+	 *
+	 * @param vaddr Virtual address of the buffer
+	 * @param len Length of the buffer, in bytes
+	 */
+	void invalidateRegCache(void *vaddr, uint64_t len);
+
+	/**
+	 * @brief Returns the registration cache statistics (hits, misses, evictions etc.); all zero if the cache is disabled
+	 */
+	regCacheStats getRegCacheStats() const;
+
+	/**
+	 * @brief Enables recycling of host buffers released with freeMem()
+	 *
+	 * With recycling enabled, freeMem() keeps host buffers (REG, THP and HPF) mapped, instead of unmapping them from the 
+	 * vFPGA's TLB and releasing them, and getMem() hands them out again to allocations with the same type, size, 
+	 * memory block and NUMA placement, without any ioctl. Recycled buffers are released, least recently freed first, 
+	 * once the memory kept exceeds the budget, or once they stay unused for longer than the idle time-out.
+	 * The time-out is checked whenever a buffer is freed, or when trimRecycled() is called.
+	 *
+	 * @param budget Maximum memory kept for recycling, in bytes
+	 * @param idle_timeout Time after which unused buffers are released
+	 *
+	 * @note Recycled buffers are handed out with their previous contents
+	 */
+	void enableRecycling(uint64_t budget = RECYCLE_DEF_BUDGET, std::chrono::nanoseconds idle_timeout = RECYCLE_DEF_IDLE_TIMEOUT);
+
+	/**
+	 * @brief Disables recycling and releases all the buffers kept for recycling
+	 */
+	void disableRecycling();
+
+	/**
+	 * @brief Releases the recycled buffers which have been unused for longer than the idle time-out; no-op if recycling is disabled
+	 */
+	void trimRecycled();
+
+	/**
+	 * @brief Returns the recycling statistics (hits, misses, memory kept etc.); all zero if recycling is disabled
+	 */
+	recycleStats getRecycleStats() const;
+
+	/**
+	 * @brief Checks whether a buffer is fully mapped into the vFPGA's TLB, through userMap() or getMem()
+	 *
+	 * The buffer may span several adjacent mappings. The lookup takes O(log n) in the number of mappings,
+	 * and the last matching range is cached, so repeated lookups into the same buffer are O(1).
+	 *
+	 * @param vaddr Virtual address of the buffer
+	 * @param len Length of the buffer, in bytes
+	 * @return true, if all the bytes of the buffer are mapped
+	 * @note Registrations made by the registration cache are not considered, see enableRegCache()
+	 */
+	bool isMapped(const void *vaddr, uint64_t len) const;
+
+	/**
+	 * @brief Enables or disables validation of scatter-gather entries in invoke()
+	 *
+	 * With validation enabled, invoke() throws an std::runtime_error if a local buffer (or the local part of an RDMA operation) 
+	 * is not fully mapped, instead of issuing an operation that would fault in hardware. Disabled by default.
+	 * Has no effect on local operations while the registration cache is enabled, since the cache maps any buffer.
+	 *
+	 * @param en Whether to enable validation
+	 */
+	void setValidation(bool en);
+
+	/**
+	 * @brief Enables or disables concurrent submission of operations through this cThread
+	 *
+	 * In multi-producer mode, any number of software threads may call invoke() on this cThread concurrently.
+	 * Each invoke() holds a short critical section, covering the credit check, the register writes and the 
+	 * completion ticket, so commands are never torn and tickets are issued in the order commands reach the vFPGA.
+	 * Ordering guarantees: the operations of one producer are posted in program order, and therefore complete in order 
+	 * for a given dest stream; a batch (or a transfer split into chunks) is posted contiguously; there is no ordering 
+	 * between different producers, other than the order in which they enter invoke().
+	 * Disabled by default, in which case the submission path takes no locks.
+	 *
+	 * @param en Whether to enable multi-producer mode
+	 * @note Should be set before producers start; memory management (getMem, userMap etc.) must still be called from one thread at a time
+	 */
+	void setMultiProducer(bool en);
+
 	/**
 	 * @brief Sets a control register in the vFPGA at the specified offset
 	 *
@@ -276,11 +701,31 @@ protected:
 	 * @param oper Operation be invoked, in this case must be either CoyoteOper::LOCAL_READ or CoyoteOper::LOCAL_WRITE
 	 * @param sg Scatter-gather entry, specifying the memory address, length and stream for the operation
 	 * @param last Indicates whether this is the last operation in a sequence (default: true)
+	 * @return Completion ticket of the operation, see isDone() and wait()
 	 *
  	 * @note Local operations are non-blocking (asynchronous) by design, so users should poll for completion using checkCompleted()
+	 * @note Transfers longer than MAX_TRANSFER_SIZE are split into pipelined chunks; only the final chunk carries last, 
+	 *		 so the transfer still counts as a single completion
 	 * @note Whenever last is passed as true, the completion counter for the operation is incremented by 1 and an acknowledgement is sent on the hardware-side cq_* interface of the vFPGA with ack_t.host = 1; otherwise it is not
 	 */
-	void invoke(CoyoteOper oper, localSg sg, bool last = true);
+	cmdTicket invoke(CoyoteOper oper, localSg sg, bool last = true);
+
+	/**
+	 * @brief Invokes a batch of one-sided local Coyote operations, one for each scatter-gather entry
+	 *
+	 * All the control words are encoded up-front, and FIFO credits are reserved for as many commands as
+	 * the command FIFO can hold at once, so the commands are written back-to-back. This is considerably 
+	 * cheaper than calling invoke() for every entry when issuing many small transfers.
+	 *
+	 * @param oper Operation be invoked, in this case must be either CoyoteOper::LOCAL_READ or CoyoteOper::LOCAL_WRITE
+	 * @param sgs Scatter-gather entries, each specifying the memory address, length and stream for one operation
+	 * @param last Indicates whether the final entry in the batch is the last operation in a sequence (default: true); 
+	 *			   all other entries are posted with last = false
+	 * @return Completion ticket of the final entry in the batch, see isDone() and wait()
+	 *
+	 * @note Since only the final entry can carry last, the completion counter is incremented at most once per batch
+	 */
+	cmdTicket invoke(CoyoteOper oper, const std::vector<localSg> &sgs, bool last = true);
 
 	/**
 	 * @brief Invokes a two-sided local Coyote operation with the specified scatter-gather list (sg)
@@ -289,11 +734,13 @@ protected:
 	 * @param src_sg Source scatter-gather entry, specifying the memory address, length and stream
 	 * @param dst_sg Destination scatter-gather entry, specifying the memory address, length and stream
 	 * @param last Indicates whether this is the last operation in a sequence (default: true)
+	 * @return Completion ticket of the operation, see isDone() and wait()
 	 *
  	 * @note Local operations are non-blocking (asynchronous) by design, so users should poll for completion using checkCompleted()
+	 * @note Transfers longer than MAX_TRANSFER_SIZE are split into pipelined chunks, which requires equal source and destination lengths
 	 * @note Whenever last is passed as true, the completion counter for the operation is incremented by 1 and an acknowledgement is sent on the hardware-side cq_* interface of the vFPGA with ack_t.host = 1; otherwise it is not
 	 */
-	void invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last = true);
+	cmdTicket invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last = true);
 
 	/**
 	 * @brief Invokes an RDMA operation with the specified scatter-gather list (sg)
@@ -301,11 +748,27 @@ protected:
 	 * @param oper Operation be invoked, in this case must be CoyoteOper::RDMA_WRITE or CoyoteOper::RDMA_READ
 	 * @param sg Scatter-gather entry, specifying the RDMA operation parameters 
 	 * @param last Indicates whether this is the last operation in a sequence (default: true)
+	 * @return Completion ticket of the operation, see isDone() and wait()
 	 *
  	 * @note Remote oeprations are non-blocking (asynchronous) by design, so users should poll for completion using checkCompleted()
+	 * @note Transfers longer than MAX_TRANSFER_SIZE are split into pipelined chunks; only the final chunk carries last
 	 * @note Whenever last is passed as true, the completion counter for the operation is incremented by 1 and an acknowledgement is sent on the hardware-side cq_* interface of the vFPGA with ack_t.host = 1; otherwise it is not
 	 */
-	void invoke(CoyoteOper oper, rdmaSg sg, bool last = true);
+	cmdTicket invoke(CoyoteOper oper, rdmaSg sg, bool last = true);
+
+	/**
+	 * @brief Invokes a batch of RDMA operations, one for each scatter-gather entry
+	 *
+	 * @param oper Operation be invoked, in this case must be CoyoteOper::RDMA_WRITE or CoyoteOper::RDMA_READ
+	 * @param sgs Scatter-gather entries, each specifying the RDMA operation parameters 
+	 * @param last Indicates whether the final entry in the batch is the last operation in a sequence (default: true);
+	 *			   all other entries are posted with last = false
+	 * @return Completion ticket of the final entry in the batch, see isDone() and wait()
+	 *
+	 * @note Same encoding and credit reservation as the batched local invoke()
+	 * @note All entries must target the same queue pair (rdmaSg::qp_id), since completions are counted per QP
+	 */
+	cmdTicket invoke(CoyoteOper oper, const std::vector<rdmaSg> &sgs, bool last = true);
 
 	/**
 	 * @brief Invokes a TCP operation with the specified scatter-gather list (sg)
@@ -318,6 +781,36 @@ protected:
 	 */
 	void invoke(CoyoteOper oper, tcpSg sg, bool last = true);
 
+	/**
+	 * @brief Prepares a one-sided local operation (LOCAL_READ or LOCAL_WRITE) for repeated posting, see cCmdTemplate
+	 *
+	 * Performs the same checks as invoke() and encodes the command once; the buffer is registered (or validated) 
+	 * again on every post(), if the registration cache (or validation) is enabled.
+	 *
+	 * @param oper Operation to be prepared
+	 * @param sg Scatter-gather entry; the length must not exceed MAX_TRANSFER_SIZE
+	 * @param last Whether the command is posted with last set (default: true)
+	 * @return Command template, which can be posted with post()
+	 */
+	cCmdTemplate prepareCmd(CoyoteOper oper, localSg sg, bool last = true);
+
+	/// Same as above, for a two-sided local operation (LOCAL_TRANSFER)
+	cCmdTemplate prepareCmd(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last = true);
+
+	/**
+	 * @brief Prepares an RDMA operation (REMOTE_RDMA_READ, REMOTE_RDMA_WRITE or REMOTE_RDMA_SEND) for repeated posting, see cCmdTemplate
+	 * @note The addresses are resolved from the current queue pair; templates must be prepared again after re-connecting
+	 */
+	cCmdTemplate prepareCmd(CoyoteOper oper, rdmaSg sg, bool last = true);
+
+	/**
+	 * @brief Posts a command prepared with prepareCmd() to the vFPGA
+	 *
+	 * @param tmpl Command template, as prepared (and possibly patched)
+	 * @return Completion ticket of the operation, see isDone() and wait()
+	 */
+	cmdTicket post(const cCmdTemplate &tmpl);
+
 	/**
 	 * @brief Returns the number of completed operations for a given Coyote operation type
 	 *
@@ -326,11 +819,107 @@ protected:
 	 */
 	uint32_t checkCompleted(CoyoteOper oper) const;
 
+	/**
+	 * @brief Returns the number of completed RDMA operations of a given type on a queue pair
+	 *
+	 * @param oper Operation to be queried 
+	 * @param qp_id QP id, as returned by createQp(); 0 for the default QP
+	 * @return Cumulative number of completed operations; for local operations, the QP is ignored
+	 */
+	uint32_t checkCompleted(CoyoteOper oper, int32_t qp_id) const;
+
+	/**
+	 * @brief Blocks until the number of completed operations for a given Coyote operation type reaches a target
+	 *
+	 * Unlike a tight loop around checkCompleted(), the wait policy allows the calling thread to back off
+	 * and free up the CPU core, which matters when many cThreads are waiting on the same host.
+	 *
+	 * @param oper Operation to be queried
+	 * @param target Number of completed operations (as returned by checkCompleted()) to wait for
+	 * @param timeout Maximum time to wait; checked periodically, so the actual wait may slightly exceed it (default: no time-out)
+	 * @param policy Wait strategy, i.e., how to back off between polls, see CoyoteWait (default: spin, then pause)
+	 * @param stats Optional pointer, to which the number of polls and time spent waiting are written
+	 * @param qp_id Queue pair, for RDMA operations, see createQp() (default: the default QP)
+	 * @return true if the target was reached, false if the wait timed out
+	 */
+	bool waitCompleted(
+		CoyoteOper oper, uint32_t target, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max(),
+		waitPolicy policy = {}, waitStats *stats = nullptr, int32_t qp_id = 0
+	) const;
+
+	/**
+	 * @brief Checks whether the operation corresponding to a completion ticket has completed
+	 *
+	 * @param ticket Completion ticket, as returned by invoke()
+	 * @return true if the operation has completed
+	 *
+	 * @note Operations of the same type complete in order; therefore, a ticket is considered done once the
+	 * completion counter of its type reaches the ticket, regardless of which consumer invoked the operation
+	 */
+	bool isDone(cmdTicket ticket) const;
+
+	/**
+	 * @brief Blocks until the operation corresponding to a completion ticket has completed
+	 *
+	 * @param ticket Completion ticket, as returned by invoke()
+	 * @param timeout Maximum time to wait (default: no time-out)
+	 * @param policy Wait strategy, see waitCompleted()
+	 * @param stats Optional pointer, to which the number of polls and time spent waiting are written
+	 * @return true if the operation completed, false if the wait timed out
+	 */
+	bool wait(
+		cmdTicket ticket, std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max(), 
+		waitPolicy policy = {}, waitStats *stats = nullptr
+	) const;
+
 	/**
 	 * @brief Clears all the completion counters (for all operations)
+	 *
+	 * Outstanding completion tickets are invalidated: the registration cache releases the ones it holds
+	 * and operations registered with a cPoller complete on its next poll(), see getClearCount().
 	 */
 	void clearCompleted();
 
+	/// Returns the number of calls to clearCompleted(); tickets issued before the last call are no longer valid
+	uint32_t getClearCount() const;
+
+	/**
+	 * @brief Enables polling-mode user interrupts (notifications)
+	 *
+	 * Notifications for this cThread are queued by the driver in a ring mapped into this process and consumed 
+	 * with pollNotification() (no syscalls) or waitNotification() (blocks on an eventfd). Unlike the user interrupt 
+	 * service routine, bursts of notifications are queued, rather than being processed one at a time.
+	 * Cannot be combined with a user interrupt service routine passed to the constructor.
+	 *
+	 * @note If the consumer falls NOTIFY_RING_SIZE notifications behind, further notifications are dropped; see getDroppedNotifications()
+	 */
+	void enableNotifyRing();
+
+	/// Disables polling-mode user interrupts; any notifications still in the ring are discarded
+	void disableNotifyRing();
+
+	/**
+	 * @brief Retrieves the next notification from the ring, if any, without blocking or issuing any syscalls
+	 *
+	 * @param value Set to the notification value, if one was available
+	 * @return true, if a notification was retrieved
+	 * @note Notifications should be consumed by one thread at a time; requires enableNotifyRing()
+	 */
+	bool pollNotification(int32_t &value);
+
+	/**
+	 * @brief Retrieves the next notification from the ring, blocking until one arrives
+	 *
+	 * @param value Set to the notification value, if one was available
+	 * @param timeout_ms Maximum time to block, in milliseconds; negative values block indefinitely
+	 * @return true, if a notification was retrieved; false, if timed out
+	 * @note Notifications should be consumed by one thread at a time; requires enableNotifyRing()
+	 */
+	bool waitNotification(int32_t &value, int timeout_ms = -1);
+
+	/// Getter: number of notifications dropped by the driver because the ring was full
+	uint32_t getDroppedNotifications() const;
+
 	/** 
 	 * @brief Synchronizes the connection between the client and server
 	 * @param client If true, this cThread acts as a client; otherwise, it acts as a server
@@ -358,6 +947,39 @@ protected:
 	 */
 	void closeConn();
 
+	/**
+	 * @brief Creates an additional RDMA queue pair (QP) on this cThread
+	 *
+	 * Allows one cThread to issue RDMA operations to many remote nodes, by setting rdmaSg::qp_id; each QP counts
+	 * its completions separately, and the tickets returned by invoke() refer to the QP of the operation.
+	 * Every QP is backed by an additional Coyote thread ID (ctid), registered under the same host process ID, 
+	 * so the QPs share all the buffers mapped for this cThread, but not the host thread or the memory mappings 
+	 * of a cThread. The local side of the QP is ready after this call and should be sent to the remote node (see getQpair()),
+	 * after which the QP is connected with connectQp().
+	 *
+	 * @param mem Local buffer of the QP; if nullptr, the buffer of the default QP (from initRDMA() or a remote getMem()) is shared
+	 * @param size Size of the local buffer, in bytes; ignored if the buffer of the default QP is shared
+	 * @return QP id, to be used in rdmaSg::qp_id
+	 * @throws std::runtime_error if no Coyote thread IDs are left in the vFPGA
+	 * @note Like memory management, QPs must not be created or destroyed while other threads invoke operations on them
+	 */
+	int32_t createQp(void *mem = nullptr, uint64_t size = 0);
+
+	/**
+	 * @brief Connects a queue pair to a remote QP, exchanged out-of-band, and writes the QP context to the vFPGA
+	 *
+	 * @param qp_id QP id, as returned by createQp(); 0 connects the default QP
+	 * @param remote Remote side of the QP, i.e., the local side of the QP on the remote node
+	 * @param port Port of the connection, as in initRDMA()
+	 */
+	void connectQp(int32_t qp_id, const ibvQ &remote, uint16_t port);
+
+	/**
+	 * @brief Destroys a queue pair created with createQp(), waiting for any loopback copies on it and releasing its ctid
+	 * @param qp_id QP id, as returned by createQp()
+	 */
+	void destroyQp(int32_t qp_id);
+
 	/**
 	 * @brief Locks the vFPGA for exclusive access by this cThread
 	 *
@@ -382,8 +1004,51 @@ protected:
 	/// Getter: Host process ID (hpid)
 	pid_t getHpid() const;
 
-	/// Getter: queue pair (QP)
-	ibvQp* getQpair() const;
+	/// Getter: queue pair (QP) with the given id, see createQp(); by default, the QP set up by initRDMA()
+	ibvQp* getQpair(int32_t qp_id = 0) const;
+
+	/// Getter: NUMA node the FPGA is attached to; -1 if unknown
+	int32_t getNumaNode() const;
+
+	/// Getter: time spent in the steps of constructing this cThread
+	startupStats getStartupStats() const;
+
+	/**
+	 * @brief Drops the cached shell configuration of all devices
+	 *
+	 * The shell configuration (and the IP address and NUMA node) of a device is read once, by the first cThread 
+	 * on the device, and reused by later cThreads. Must be called after reconfiguring the shell, 
+	 * which cRcnfg::reconfigureShell() does automatically.
+	 */
+	static void invalidateShellCnfg();
+
+	/**
+	 * @brief Releases the state of the current user, so that the cThread can be handed to another one; see cThreadPool
+	 *
+	 * Waits for loopback copies and asynchronous mappings, destroys the QPs from createQp(), disables the notification ring,
+	 * releases the recycled buffers and the registration cache, restores the default settings (no multi-producer mode,
+	 * no validation), frees all the memory from getMem(), unmaps all the buffers from userMap(), clears the completion
+	 * counters and releases the vFPGA lock. The default QP and connections are kept.
+	 */
+	void reset();
+
+	/// Getter: page size of the vFPGA's small TLB, as configured in the shell
+	uint64_t getPageSize() const;
+
+	/// Getter: page size of the vFPGA's large TLB, as configured in the shell; used for HPF allocations
+	uint64_t getHugePageSize() const;
+
+	/**
+	 * @brief Reports on which NUMA nodes the pages of a buffer reside
+	 *
+	 * Useful for verifying the placement requested with CoyoteAlloc::numa; pages that haven't been 
+	 * touched yet (and therefore have no physical backing) are reported under node -1.
+	 *
+	 * @param vaddr Virtual address of the buffer
+	 * @param len Length of the buffer, in bytes
+	 * @return Map from NUMA node to the number of bytes of the buffer residing on it, at page granularity
+	 */
+	std::map<int32_t, uint64_t> getMemNodes(const void *vaddr, uint64_t len) const;
 	
 	/// Utility function, prints stats about this cThread including the number of commands invalidations etc.
 	void printDebug() const;
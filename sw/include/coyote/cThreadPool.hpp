@@ -0,0 +1,144 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CTHREADPOOL_HPP_
+#define _COYOTE_CTHREADPOOL_HPP_
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <functional>
+
+#include <unistd.h>
+
+#include <coyote/cDefs.hpp>
+#include <coyote/cThread.hpp>
+
+namespace coyote {
+
+/// @brief cThread pool statistics
+struct threadPoolStats {
+    /// Number of cThreads handed out by acquire()
+    uint64_t n_acquired = { 0 };
+
+    /// Number of acquire() calls served with an idle cThread
+    uint64_t n_reused = { 0 };
+
+    /// Number of cThreads constructed by the pool
+    uint64_t n_created = { 0 };
+
+    /// Number of returned cThreads which were destroyed, since the pool was full or they couldn't be reset
+    uint64_t n_destroyed = { 0 };
+
+    /// Number of cThreads currently idle in the pool
+    uint64_t n_idle = { 0 };
+
+    /// Number of cThreads currently handed out
+    uint64_t n_in_use = { 0 };
+};
+
+/**
+ * @brief Pool of registered cThreads on one vFPGA, for short-lived users (e.g., request handlers)
+ *
+ * Constructing a cThread opens the char device, registers a Coyote thread ID with the driver, reads the
+ * shell configuration and maps the vFPGA regions, which is a large fixed cost compared to a short request.
+ * The pool constructs cThreads up-front and hands them out with acquire(); once the returned handle is
+ * destroyed, the cThread is reset (see cThread::reset()) and kept for the next user, up to the pool's capacity.
+ *
+ * @note Handles may outlive the pool; the cThreads returned afterwards are destroyed instead of kept
+ * @note The default queue pair and connections (RDMA, TCP) of a cThread are not reset, so pooled cThreads are best used for local operations
+ */
+class cThreadPool {
+
+public:
+    /// A cThread from the pool; returned to the pool when destroyed
+    using threadHandle = std::unique_ptr<cThread, std::function<void(cThread*)>>;
+
+private:
+    /// State of the pool; shared with the deleters of the handed out cThreads, so that they can be returned after the pool is destroyed
+    struct poolCore {
+        /// Arguments for constructing the cThreads, see cThread::cThread()
+        int32_t vfid;
+        pid_t hpid;
+        uint32_t device;
+        std::function<void(int)> uisr;
+
+        /// Maximum number of idle cThreads kept
+        uint32_t capacity;
+
+        /// Set once the pool is destroyed; returned cThreads are no longer kept
+        bool closed = { false };
+
+        /// Idle cThreads, most recently returned last
+        std::vector<std::unique_ptr<cThread>> idle;
+
+        std::mutex pool_lock;
+        threadPoolStats stats;
+
+        /// Resets a returned cThread and keeps it, if there is space; otherwise, destroys it
+        void release(cThread *thread);
+    };
+
+    std::shared_ptr<poolCore> core;
+
+public:
+    /**
+     * @brief Constructs a pool and the cThreads in it
+     *
+     * @param vfid Virtual FPGA ID
+     * @param n_threads Number of cThreads constructed up-front, which is also the maximum number of idle cThreads kept
+     * @param hpid Host process ID
+     * @param device Device number, for systems with multiple vFPGAs
+     * @param uisr User interrupt (notifications) service routine, shared by all the cThreads of the pool
+     */
+    cThreadPool(
+        int32_t vfid, uint32_t n_threads = THREAD_POOL_DEF_SIZE, pid_t hpid = getpid(), 
+        uint32_t device = 0, std::function<void(int)> uisr = nullptr
+    );
+
+    /**
+     * @brief Default destructor; destroys the idle cThreads
+     */
+    ~cThreadPool();
+
+    cThreadPool(const cThreadPool&) = delete;
+    cThreadPool& operator=(const cThreadPool&) = delete;
+
+    /**
+     * @brief Hands out an idle cThread, or constructs a new one if there is none
+     *
+     * @return Handle to the cThread; the cThread is returned to the pool once the handle is destroyed
+     * @throws std::runtime_error if a new cThread couldn't be constructed
+     */
+    threadHandle acquire();
+
+    /// Returns the pool statistics
+    threadPoolStats getStats() const;
+};
+
+}
+
+#endif // _COYOTE_CTHREADPOOL_HPP_
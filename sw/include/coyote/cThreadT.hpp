@@ -0,0 +1,316 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef _COYOTE_CTHREADT_HPP_
+#define _COYOTE_CTHREADT_HPP_
+
+#include <string>
+#include <functional>
+
+#include <coyote/cOps.hpp>
+#include <coyote/cThread.hpp>
+#include <coyote/cCmdTemplate.hpp>
+
+namespace coyote {
+
+/**
+ * @brief Compile-time description of a shell configuration, to be used with cThreadT
+ *
+ * Each flag corresponds to the field of the same name in fpgaCnfg, i.e., the configuration the shell was synthesized with.
+ * Any type with the same static constexpr members can be used as well.
+ */
+template <bool EN_AVX_, bool EN_WB_, bool EN_STRM_, bool EN_MEM_, bool EN_RDMA_ = false, bool EN_TCP_ = false>
+struct shellTraits {
+    static constexpr bool en_avx = EN_AVX_;
+    static constexpr bool en_wb = EN_WB_;
+    static constexpr bool en_strm = EN_STRM_;
+    static constexpr bool en_mem = EN_MEM_;
+    static constexpr bool en_rdma = EN_RDMA_;
+    static constexpr bool en_tcp = EN_TCP_;
+};
+
+/**
+ * @brief A cThread specialized for a shell configuration that is known at compile-time
+ *
+ * The generic cThread checks the shell configuration (AVX, writeback etc.) at run-time, on every command and completion check.
+ * When the shell configuration is fixed, cThreadT resolves these checks at compile-time: the control words are encoded inline
+ * and posting a command reduces to a few stores to the config registers (or a single one, with AVX). The configuration
+ * is validated against the one read from the driver during construction, throwing an std::runtime_error on a mismatch.
+ *
+ * The hot-path functions (invoke for single local and RDMA operations, post, checkCompleted, isDone and clearCompleted) hide 
+ * the ones from cThread; all the other functions, as well as the uncommon cases (e.g., transfers over MAX_TRANSFER_SIZE, 
+ * RDMA operations on additional queue pairs, or invalid arguments), fall back to the generic implementation. Note, the functions are not virtual, so calls through 
+ * a reference or pointer to the base cThread use the generic implementation, which is functionally equivalent.
+ *
+ * Example: using myThread = cThreadT<shellTraits<true, true, true, false>>;
+ *
+ * @tparam ShellTraits Shell configuration, see shellTraits
+ * @note Targets hardware; the simulation target does not report a shell configuration
+ */
+template <typename ShellTraits>
+class cThreadT : public cThread {
+
+#ifndef EN_AVX
+    static_assert(!ShellTraits::en_avx, "cThreadT: shells with AVX enabled require compiling with EN_AVX");
+#endif
+
+private:
+    /// Same bound on outstanding commands as in cThread::waitCmdCredits()
+    static constexpr uint32_t MAX_CMD_CNT = CMD_FIFO_DEPTH - CMD_FIFO_THR + 1;
+
+    /// Completion counter (RD_WBACK, WR_WBACK etc.) of an operation, with the same precedence as in cThread::checkCompleted(); N_WBACKS if none
+    static constexpr unsigned long wbackIdx(CoyoteOper oper) {
+        return isLocalWrite(oper) ? WR_WBACK : 
+               isLocalRead(oper) ? RD_WBACK : 
+               isRemoteRead(oper) ? RD_RDMA_WBACK : 
+               isRemoteWriteOrSend(oper) ? WR_RDMA_WBACK : N_WBACKS;
+    }
+
+    /// Throws if a flag of the traits doesn't match the configuration of the shell
+    static void checkTrait(const std::string &name, bool traits_val, bool shell_val) {
+        if (traits_val != shell_val) {
+            throw std::runtime_error(
+                "ERROR: cThreadT - ShellTraits::" + name + " is " + std::to_string(traits_val) + 
+                ", but the shell was synthesized with " + name + " = " + std::to_string(shell_val) + ", exiting..."
+            );
+        }
+    }
+
+    /// Validates the shell configuration against ShellTraits
+    void checkTraits() const {
+        checkTrait("en_avx", ShellTraits::en_avx, fcnfg.en_avx);
+        checkTrait("en_wb", ShellTraits::en_wb, fcnfg.en_wb);
+        checkTrait("en_strm", ShellTraits::en_strm, fcnfg.en_strm);
+        checkTrait("en_mem", ShellTraits::en_mem, fcnfg.en_mem);
+        checkTrait("en_rdma", ShellTraits::en_rdma, fcnfg.en_rdma);
+        checkTrait("en_tcp", ShellTraits::en_tcp, fcnfg.en_tcp);
+    }
+
+    /// Same as cThread::writeCmd(), with the register interface chosen at compile-time
+    inline void writeCmdT(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_t offs_0) {
+        if constexpr (ShellTraits::en_avx) {
+            #ifdef EN_AVX
+            cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::CTRL_REG)] = _mm256_set_epi64x(offs_3, offs_2, offs_1, offs_0);
+            #endif
+        } else {
+            cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::VADDR_WR_REG)] = offs_3;
+            cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG_2)] = offs_2;
+            cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::VADDR_RD_REG)] = offs_1;
+            cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG)] = offs_0;
+        }
+    }
+
+    /// Same as cThread::postCmd(); the command FIFO is only polled (out-of-line) when the locally tracked credits run out
+    inline void postCmdT(const std::array<uint64_t, 4> &cmd) {
+        if (cmd_cnt + 1 > MAX_CMD_CNT) {
+            waitCmdCredits(1);
+        }
+        writeCmdT(cmd[0], cmd[1], cmd[2], cmd[3]);
+        cmd_cnt++;
+    }
+
+    /// Same as cThread::issueTicket(), for operations with a completion counter
+    inline cmdTicket issueTicketT(CoyoteOper oper, bool last) {
+        uint32_t &issued = cmpl_issued[wbackIdx(oper)];
+        if (!last) {
+            return {oper, issued + 1};
+        }
+
+        if (oper == CoyoteOper::LOCAL_TRANSFER) {
+            cmpl_issued[RD_WBACK]++;
+        }
+        return {oper, ++issued};
+    }
+
+    /// Reads the hardware completion counter with the given index (RD_WBACK, WR_WBACK etc.)
+    inline uint32_t readCounter(unsigned long idx) const {
+        if constexpr (ShellTraits::en_wb) {
+            return wback[ctid + idx * N_CTID_MAX];
+        } else if constexpr (ShellTraits::en_avx) {
+            #ifdef EN_AVX
+            const __m256i stat = cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::STAT_DMA_REG) + ctid];
+            switch (idx) {
+                case RD_WBACK: return _mm256_extract_epi32(stat, 0);
+                case WR_WBACK: return _mm256_extract_epi32(stat, 1);
+                case RD_RDMA_WBACK: return _mm256_extract_epi32(stat, 2);
+                default: return _mm256_extract_epi32(stat, 3);
+            }
+            #endif
+        } else {
+            if (idx == RD_WBACK || idx == WR_WBACK) {
+                uint64_t stat = cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::STAT_DMA_REG) + ctid];
+                return idx == RD_WBACK ? LOW_32(stat) : HIGH_32(stat);
+            } else {
+                uint64_t stat = cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::STAT_RDMA_REG) + ctid];
+                return idx == RD_RDMA_WBACK ? LOW_32(stat) : HIGH_32(stat);
+            }
+        }
+    }
+
+protected:
+    /**
+     * @brief Constructs a cThreadT which is not backed by a vFPGA and validates the given shell configuration against ShellTraits
+     * @note Same arguments as the corresponding cThread constructor
+     */
+    cThreadT(const fpgaCnfg &cnfg, int32_t ctid = 0): cThread(cnfg, ctid) {
+        checkTraits();
+    }
+
+public:
+    /**
+     * @brief Constructs the cThread and validates the shell configuration against ShellTraits
+     * @note Same arguments as the cThread constructor
+     */
+    cThreadT(int32_t vfid, pid_t hpid, uint32_t device = 0, std::function<void(int)> uisr = nullptr):
+      cThread(vfid, hpid, device, uisr) {
+        checkTraits();
+    }
+
+    using cThread::invoke;
+
+    /// Same as cThread::invoke() for a one-sided local operation (LOCAL_READ, LOCAL_WRITE)
+    cmdTicket invoke(CoyoteOper oper, localSg sg, bool last = true) {
+        static_assert(ShellTraits::en_strm || ShellTraits::en_mem, "cThreadT: local operations require a shell with host or card streams");
+
+        if ((oper != CoyoteOper::LOCAL_READ && oper != CoyoteOper::LOCAL_WRITE) || sg.len > MAX_TRANSFER_SIZE) {
+            return cThread::invoke(oper, sg, last);
+        }
+
+        auto submission = lockSubmission();
+        prepareBuffer(sg.addr, sg.len);
+
+        postCmdT(localCmd(oper, ctid, sg, last));
+        return holdBuffers(issueTicketT(oper, last));
+    }
+
+    /// Same as cThread::invoke() for a two-sided local operation (LOCAL_TRANSFER)
+    cmdTicket invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last = true) {
+        static_assert(ShellTraits::en_strm || ShellTraits::en_mem, "cThreadT: local operations require a shell with host or card streams");
+
+        if (oper != CoyoteOper::LOCAL_TRANSFER || src_sg.len > MAX_TRANSFER_SIZE || dst_sg.len > MAX_TRANSFER_SIZE) {
+            return cThread::invoke(oper, src_sg, dst_sg, last);
+        }
+
+        auto submission = lockSubmission();
+        prepareBuffer(src_sg.addr, src_sg.len);
+        prepareBuffer(dst_sg.addr, dst_sg.len);
+
+        postCmdT({
+            reinterpret_cast<uint64_t>(dst_sg.addr), localCtrlCmd(ctid, dst_sg, last),
+            reinterpret_cast<uint64_t>(src_sg.addr), localCtrlCmd(ctid, src_sg, last)
+        });
+        return holdBuffers(issueTicketT(oper, last));
+    }
+
+    /// Same as cThread::invoke() for an RDMA operation (REMOTE_RDMA_READ, REMOTE_RDMA_WRITE, REMOTE_RDMA_SEND)
+    cmdTicket invoke(CoyoteOper oper, rdmaSg sg, bool last = true) {
+        static_assert(ShellTraits::en_rdma, "cThreadT: RDMA operations require a shell with RDMA enabled");
+
+        // Validation, loopback operations and additional QPs are left to the generic implementation
+        if (!isRemoteRdma(oper) || sg.len > MAX_TRANSFER_SIZE || validate_sg || sg.qp_id != 0 || qpair->local.ip_addr == qpair->remote.ip_addr) {
+            return cThread::invoke(oper, sg, last);
+        }
+
+        auto submission = lockSubmission();
+        postCmdT(rdmaCmd(oper, ctid, *qpair, sg, last));
+        return issueTicketT(oper, last);
+    }
+
+    /// Same as cThread::post(); buffer registration and validation are left to the generic implementation
+    cmdTicket post(const cCmdTemplate &tmpl) {
+        if (reg_cache || validate_sg || tmpl.getCtid() != ctid) {
+            return cThread::post(tmpl);
+        }
+
+        auto submission = lockSubmission();
+        postCmdT(tmpl.getCmd());
+        return issueTicketT(tmpl.getOper(), tmpl.isLast());
+    }
+
+    /// Same as cThread::checkCompleted(), reading the completion counter from the writeback region or the config registers
+    uint32_t checkCompleted(CoyoteOper oper) const {
+        const unsigned long idx = wbackIdx(oper);
+        if (idx == N_WBACKS) {
+            return 0;
+        }
+
+        // Loopback RDMA operations are completed by the copy engine, see cThread::loopbackCopy()
+        if constexpr (ShellTraits::en_rdma) {
+            if (idx == RD_RDMA_WBACK || idx == WR_RDMA_WBACK) {
+                return readCounter(idx) + loopback_cmpl[idx].completed();
+            }
+        }
+        return readCounter(idx);
+    }
+
+    /// Same as cThread::checkCompleted() for a queue pair; additional QPs are left to the generic implementation
+    uint32_t checkCompleted(CoyoteOper oper, int32_t qp_id) const {
+        return qp_id == 0 ? checkCompleted(oper) : cThread::checkCompleted(oper, qp_id);
+    }
+
+    /// Same as cThread::isDone()
+    bool isDone(cmdTicket ticket) const {
+        return static_cast<int32_t>(checkCompleted(ticket.oper, ticket.qp_id) - ticket.seq) >= 0;
+    }
+
+    /// Same as cThread::clearCompleted(); with additional queue pairs, the generic implementation clears them all
+    void clearCompleted() {
+        if (!qp_table.empty()) {
+            cThread::clearCompleted();
+            return;
+        }
+
+        if constexpr (ShellTraits::en_rdma) {
+            loopback_cmpl[RD_RDMA_WBACK].clear();
+            loopback_cmpl[WR_RDMA_WBACK].clear();
+        }
+
+        for (unsigned long i = 0; i < N_WBACKS; i++) {
+            cmpl_issued[i] = 0;
+        }
+
+        if constexpr (ShellTraits::en_wb) {
+            for (unsigned long i = 0; i < N_WBACKS; i++) {
+                wback[ctid + i * N_CTID_MAX] = 0;
+            }
+        }
+
+        const uint64_t clr = CTRL_CLR_STAT | ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS);
+        if constexpr (ShellTraits::en_avx) {
+            #ifdef EN_AVX
+            cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::CTRL_REG)] = _mm256_set_epi64x(0, clr, 0, clr);
+            #endif
+        } else {
+            cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG_2)] = clr;
+            cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG)] = clr;
+        }
+    }
+
+};
+
+}
+
+#endif // _COYOTE_CTHREADT_HPP_
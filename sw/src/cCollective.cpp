@@ -0,0 +1,592 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+#include <coyote/cCollective.hpp>
+
+namespace coyote {
+
+/// Stride of the control words in the work area, so that words written by different peers don't share a cache line
+static constexpr uint64_t const CTRL_STRIDE = 64;
+
+/// Number of polls between time-out checks (and yields) while waiting
+static constexpr uint32_t const POLLS_PER_CHECK = 16;
+
+/// Utility function, size of an element in bytes
+static uint64_t dtypeSize(collDtype dtype) {
+    switch (dtype) {
+        case collDtype::INT32: return sizeof(int32_t);
+        case collDtype::INT64: return sizeof(int64_t);
+        case collDtype::FLOAT: return sizeof(float);
+        case collDtype::DOUBLE: return sizeof(double);
+        default: throw std::runtime_error("ERROR: cCollective - unknown data type");
+    }
+}
+
+/// Utility function, number of chunks of chunk_elems elements needed for count elements
+static uint64_t numChunks(uint64_t count, uint64_t chunk_elems) {
+    return (count + chunk_elems - 1) / chunk_elems;
+}
+
+/// Utility function, element-wise reduction of src into dst, on 32-byte vectors; inlined into each of the targets below
+template<typename T, collReduceOp OP>
+__attribute__((always_inline)) static inline void reduceLoop(T *dst, const T *src, uint64_t count) {
+    typedef T vec __attribute__((vector_size(32)));
+    constexpr uint64_t lanes = 32 / sizeof(T);
+
+    uint64_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        vec a, b;
+        memcpy(&a, dst + i, sizeof(vec));
+        memcpy(&b, src + i, sizeof(vec));
+        if constexpr (OP == collReduceOp::SUM) {
+            a = a + b;
+        } else if constexpr (OP == collReduceOp::MIN) {
+            a = b < a ? b : a;
+        } else {
+            a = b > a ? b : a;
+        }
+        memcpy(dst + i, &a, sizeof(vec));
+    }
+
+    for (; i < count; i++) {
+        if constexpr (OP == collReduceOp::SUM) {
+            dst[i] = dst[i] + src[i];
+        } else if constexpr (OP == collReduceOp::MIN) {
+            dst[i] = src[i] < dst[i] ? src[i] : dst[i];
+        } else {
+            dst[i] = src[i] > dst[i] ? src[i] : dst[i];
+        }
+    }
+}
+
+/// Utility function, reduction for any x86-64 CPU
+template<typename T, collReduceOp OP>
+static void reduceGeneric(void *dst, const void *src, uint64_t count) {
+    reduceLoop<T, OP>((T*) dst, (const T*) src, count);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/// Utility function, reduction with AVX2
+template<typename T, collReduceOp OP>
+__attribute__((target("avx2")))
+static void reduceAvx2(void *dst, const void *src, uint64_t count) {
+    reduceLoop<T, OP>((T*) dst, (const T*) src, count);
+}
+#endif
+
+typedef void (*reduceFn)(void*, const void*, uint64_t);
+
+/// Utility function, picks the reduction kernels of one data type for the widest vectors supported by the CPU
+template<typename T>
+static std::array<reduceFn, 3> selectReduce() {
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {reduceAvx2<T, collReduceOp::SUM>, reduceAvx2<T, collReduceOp::MIN>, reduceAvx2<T, collReduceOp::MAX>};
+    }
+    #endif
+    return {reduceGeneric<T, collReduceOp::SUM>, reduceGeneric<T, collReduceOp::MIN>, reduceGeneric<T, collReduceOp::MAX>};
+}
+
+/// Utility function, reduction kernel for a data type and operator
+static reduceFn getReduce(collDtype dtype, collReduceOp op) {
+    static const std::array<std::array<reduceFn, 3>, 4> kernels = {
+        selectReduce<int32_t>(), selectReduce<int64_t>(), selectReduce<float>(), selectReduce<double>()
+    };
+    return kernels.at(static_cast<int>(dtype)).at(static_cast<int>(op));
+}
+
+cCollective::cCollective(cThread *cthread, const cConnManager &conn, cOobGroup &group, collConfig cnfg):
+  cthread(cthread), cnfg(cnfg), rank(group.getRank()), size(group.getSize()) {
+    if (cnfg.chunk_size == 0 || cnfg.chunk_size % 64 != 0) {
+        throw std::runtime_error("ERROR: cCollective - the chunk size must be a non-zero multiple of 64 bytes");
+    }
+
+    if (cnfg.n_slots < 2) {
+        throw std::runtime_error("ERROR: cCollective - at least two receive slots per sender are needed");
+    }
+
+    if (static_cast<int32_t>(conn.getPeers().size()) != size - 1) {
+        throw std::runtime_error("ERROR: cCollective - the connection manager and the group must span the same nodes");
+    }
+
+    // All the QPs must write into the same buffer, so that offsets mean the same on every QP
+    const uint64_t work_size = getWorkSize(size, cnfg);
+    chans.resize(size);
+    for (int32_t r = 0; r < size; r++) {
+        if (r == rank) {
+            continue;
+        }
+
+        peerChan &chan = chans[r];
+        chan.qp_id = conn.getQp(group.getNodeId(r));
+        chan.remote_slots = slotIndex(rank, r);
+        chan.local_slots = slotIndex(r, rank);
+
+        const ibvQp *qp = cthread->getQpair(chan.qp_id);
+        if (base == nullptr) {
+            base = (char*) qp->local.vaddr;
+            base_size = qp->local.size;
+        } else if (base != qp->local.vaddr) {
+            throw std::runtime_error("ERROR: cCollective - all the QPs of the connection manager must share one RDMA buffer");
+        }
+    }
+
+    if (base != nullptr && cnfg.work_offs + work_size > base_size) {
+        throw std::runtime_error(
+            "ERROR: cCollective - the work area of " + std::to_string(work_size) + " bytes doesn't fit into the RDMA buffer"
+        );
+    }
+
+    // Peers may only write into the control words once they are cleared on all the nodes
+    if (base != nullptr) {
+        memset(base + ctrlOffs(CTRL_DELIVERED, 0), 0, slotOffs(0, 0) - cnfg.work_offs);
+    }
+    group.barrier();
+
+    DBG1("cCollective: rank " << rank << " of " << size << ", work area of " << work_size << " bytes at offset " << cnfg.work_offs);
+}
+
+cCollective::~cCollective() {
+    // Completions are counted per QP and in order, so the last ticket of each QP covers all the others
+    for (const auto &chan : chans) {
+        if (!chan.inflight.empty()) {
+            cthread->wait(chan.inflight.back(), cnfg.timeout);
+        }
+        for (const auto &ticket : chan.ctrl_tickets) {
+            cthread->wait(ticket, cnfg.timeout);
+        }
+    }
+}
+
+uint64_t cCollective::getWorkSize(int32_t n_nodes, const collConfig &cnfg) {
+    // Control words, then the staging words; rounded up to a cache line
+    uint64_t ctrl_size = N_CTRL_WORDS * n_nodes * CTRL_STRIDE + n_nodes * N_CTRL_WORDS * sizeof(uint64_t);
+    ctrl_size = (ctrl_size + CTRL_STRIDE - 1) / CTRL_STRIDE * CTRL_STRIDE;
+
+    // One group of receive slots for the left neighbour in the ring, and one per round of recursive doubling
+    uint64_t n_groups = 1;
+    for (int32_t d = 1; d < n_nodes; d <<= 1) {
+        n_groups++;
+    }
+
+    return ctrl_size + n_groups * cnfg.n_slots * cnfg.chunk_size;
+}
+
+uint64_t cCollective::ctrlOffs(ctrlWord word, int32_t src) const {
+    return cnfg.work_offs + (word * size + src) * CTRL_STRIDE;
+}
+
+uint64_t cCollective::stagingOffs(int32_t dst, ctrlWord word) const {
+    return cnfg.work_offs + N_CTRL_WORDS * size * CTRL_STRIDE + (dst * N_CTRL_WORDS + word) * sizeof(uint64_t);
+}
+
+uint64_t cCollective::slotOffs(int32_t slots, uint64_t idx) const {
+    uint64_t ctrl_size = N_CTRL_WORDS * size * CTRL_STRIDE + size * N_CTRL_WORDS * sizeof(uint64_t);
+    ctrl_size = (ctrl_size + CTRL_STRIDE - 1) / CTRL_STRIDE * CTRL_STRIDE;
+    return cnfg.work_offs + ctrl_size + (slots * cnfg.n_slots + idx % cnfg.n_slots) * cnfg.chunk_size;
+}
+
+int32_t cCollective::slotIndex(int32_t src, int32_t dst) const {
+    // A node that is both the left neighbour and a recursive doubling partner uses the same slots for both
+    if (src == (dst + size - 1) % size) {
+        return 0;
+    }
+
+    int32_t idx = 1;
+    for (int32_t d = 1; d < size; d <<= 1, idx++) {
+        if ((src ^ dst) == d) {
+            return idx;
+        }
+    }
+
+    return -1;
+}
+
+uint64_t cCollective::readCtrl(ctrlWord word, int32_t src) const {
+    // Written by the NIC (or the copy engine, for loopback), so it must be re-read from memory on every poll
+    return __atomic_load_n((uint64_t*) (base + ctrlOffs(word, src)), __ATOMIC_ACQUIRE);
+}
+
+void cCollective::setCtrl(int32_t dst, ctrlWord word, uint64_t val) {
+    chans[dst].ctrl_val[word] = val;
+    flushCtrl(dst);
+}
+
+void cCollective::flushCtrl(int32_t dst) {
+    peerChan &chan = chans[dst];
+    for (int w = 0; w < N_CTRL_WORDS; w++) {
+        if (chan.ctrl_val[w] == chan.ctrl_sent[w] || !cthread->isDone(chan.ctrl_tickets[w])) {
+            continue;
+        }
+
+        // The staging word is only re-used once the previous write from it has completed
+        const ctrlWord word = static_cast<ctrlWord>(w);
+        const uint64_t staging_offs = stagingOffs(dst, word);
+        *((uint64_t*) (base + staging_offs)) = chan.ctrl_val[w];
+
+        rdmaSg sg;
+        sg.local_offs = staging_offs;
+        sg.remote_offs = ctrlOffs(word, rank);
+        sg.len = sizeof(uint64_t);
+        sg.qp_id = chan.qp_id;
+        chan.ctrl_tickets[w] = cthread->invoke(CoyoteOper::REMOTE_RDMA_WRITE, sg);
+        chan.ctrl_sent[w] = chan.ctrl_val[w];
+    }
+}
+
+void cCollective::progress() {
+    for (int32_t r = 0; r < size; r++) {
+        peerChan &chan = chans[r];
+        if (chan.inflight.empty() && chan.ctrl_val == chan.ctrl_sent) {
+            continue;
+        }
+
+        // A delivery is only announced once its write completed, so the data is in place before the receiver sees the count
+        uint64_t n_done = chan.n_announced;
+        while (!chan.inflight.empty() && cthread->isDone(chan.inflight.front())) {
+            chan.inflight.pop_front();
+            n_done++;
+        }
+
+        if (n_done != chan.n_announced) {
+            chan.n_announced = n_done;
+            chan.ctrl_val[CTRL_DELIVERED] = n_done;
+        }
+
+        flushCtrl(r);
+    }
+}
+
+template<typename Cond>
+void cCollective::waitFor(Cond cond, const char *what, int32_t peer) {
+    uint32_t n_polls = 0;
+    while (true) {
+        progress();
+        if (cond()) {
+            return;
+        }
+
+        if (++n_polls % POLLS_PER_CHECK == 0) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                throw std::runtime_error(
+                    "ERROR: cCollective - collective " + std::to_string(coll_seq) + " timed out, waiting for " + what + 
+                    (peer >= 0 ? " of rank " + std::to_string(peer) : std::string(""))
+                );
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+cmdTicket cCollective::sendSlot(int32_t dst, uint64_t local_offs, uint64_t len) {
+    peerChan &chan = chans[dst];
+    waitFor([&] { return chan.n_slots_sent - readCtrl(CTRL_CREDITS, dst) < cnfg.n_slots; }, "a free receive slot", dst);
+
+    rdmaSg sg;
+    sg.local_offs = local_offs;
+    sg.remote_offs = slotOffs(chan.remote_slots, chan.n_slots_sent);
+    sg.len = len;
+    sg.qp_id = chan.qp_id;
+    cmdTicket ticket = cthread->invoke(CoyoteOper::REMOTE_RDMA_WRITE, sg);
+
+    chan.inflight.push_back(ticket);
+    chan.n_issued++;
+    chan.n_slots_sent++;
+    return ticket;
+}
+
+cmdTicket cCollective::sendDirect(int32_t dst, uint64_t offs, uint64_t len) {
+    peerChan &chan = chans[dst];
+
+    rdmaSg sg;
+    sg.local_offs = offs;
+    sg.remote_offs = offs;
+    sg.len = len;
+    sg.qp_id = chan.qp_id;
+    cmdTicket ticket = cthread->invoke(CoyoteOper::REMOTE_RDMA_WRITE, sg);
+
+    chan.inflight.push_back(ticket);
+    chan.n_issued++;
+    return ticket;
+}
+
+void cCollective::recvDirect(int32_t src) {
+    peerChan &chan = chans[src];
+    waitFor([&] { return readCtrl(CTRL_DELIVERED, src) > chan.n_recv; }, "a chunk", src);
+    chan.n_recv++;
+}
+
+uint64_t cCollective::recvSlot(int32_t src) {
+    peerChan &chan = chans[src];
+    waitFor([&] { return readCtrl(CTRL_DELIVERED, src) > chan.n_recv; }, "a chunk", src);
+    chan.n_recv++;
+    return slotOffs(chan.local_slots, chan.n_slots_recv++);
+}
+
+void cCollective::release(int32_t src) {
+    peerChan &chan = chans[src];
+    chan.n_slots_released++;
+    setCtrl(src, CTRL_CREDITS, chan.n_slots_released);
+}
+
+void cCollective::signalReady(int32_t dst) {
+    setCtrl(dst, CTRL_READY, coll_seq);
+}
+
+void cCollective::waitReady(int32_t src) {
+    waitFor([&] { return readCtrl(CTRL_READY, src) >= coll_seq; }, "the buffer", src);
+}
+
+void cCollective::reduce(uint64_t dst_offs, uint64_t src_offs, uint64_t count, collDtype dtype, collReduceOp op) {
+    if (!cnfg.fpga_reduce) {
+        getReduce(dtype, op)(base + dst_offs, base + src_offs, count);
+        return;
+    }
+
+    // The received chunk and the local chunk are streamed in side by side; the result replaces the local chunk
+    const uint64_t len = count * dtypeSize(dtype);
+    localSg recv_sg = { .addr = base + src_offs, .len = len, .dest = cnfg.fpga_dest };
+    localSg local_sg = { .addr = base + dst_offs, .len = len, .dest = cnfg.fpga_dest + 1 };
+    localSg result_sg = { .addr = base + dst_offs, .len = len, .dest = cnfg.fpga_dest };
+
+    cthread->invoke(CoyoteOper::LOCAL_READ, recv_sg);
+    cthread->invoke(CoyoteOper::LOCAL_READ, local_sg);
+    cmdTicket ticket = cthread->invoke(CoyoteOper::LOCAL_WRITE, result_sg);
+    waitFor([&] { return cthread->isDone(ticket); }, "a reduction in the vFPGA");
+}
+
+void cCollective::begin(uint64_t offs, uint64_t len) {
+    coll_seq++;
+    deadline = std::chrono::steady_clock::now() + cnfg.timeout;
+
+    if (base == nullptr) {
+        return;
+    }
+
+    if (offs + len > base_size) {
+        throw std::runtime_error("ERROR: cCollective - the buffer exceeds the RDMA buffer");
+    }
+
+    const uint64_t work_end = cnfg.work_offs + getWorkSize(size, cnfg);
+    if (len > 0 && offs < work_end && cnfg.work_offs < offs + len) {
+        throw std::runtime_error("ERROR: cCollective - the buffer overlaps the work area");
+    }
+}
+
+void cCollective::end() {
+    // The buffers may be modified once the collective returns, so all the writes reading from them must have completed
+    waitFor([&] {
+        for (const auto &chan : chans) {
+            if (!chan.inflight.empty() || chan.ctrl_val != chan.ctrl_sent) {
+                return false;
+            }
+        }
+        return true;
+    }, "the outstanding writes");
+}
+
+void cCollective::ringReduceScatter(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op) {
+    const uint64_t dsize = dtypeSize(dtype);
+    const uint64_t chunk_elems = cnfg.chunk_size / dsize;
+    const int32_t left = (rank + size - 1) % size;
+    const int32_t right = (rank + 1) % size;
+
+    // In step s, segment (r - s - 1) is passed on to the right and segment (r - s - 2) reduced with the one from the left
+    for (int32_t s = 0; s < size - 1; s++) {
+        const auto send_seg = getSegment(count, (rank - s - 1 + 2 * size) % size);
+        const auto recv_seg = getSegment(count, (rank - s - 2 + 2 * size) % size);
+        const uint64_t n_send = numChunks(send_seg.second, chunk_elems);
+        const uint64_t n_recv = numChunks(recv_seg.second, chunk_elems);
+
+        for (uint64_t c = 0; c < std::max(n_send, n_recv); c++) {
+            if (c < n_send) {
+                const uint64_t first = send_seg.first + c * chunk_elems;
+                const uint64_t n = std::min(chunk_elems, send_seg.first + send_seg.second - first);
+                sendSlot(right, offs + first * dsize, n * dsize);
+            }
+
+            if (c < n_recv) {
+                const uint64_t first = recv_seg.first + c * chunk_elems;
+                const uint64_t n = std::min(chunk_elems, recv_seg.first + recv_seg.second - first);
+                const uint64_t slot_offs = recvSlot(left);
+                reduce(offs + first * dsize, slot_offs, n, dtype, op);
+                release(left);
+            }
+        }
+    }
+}
+
+void cCollective::ringAllgather(uint64_t offs, uint64_t count, collDtype dtype) {
+    const uint64_t dsize = dtypeSize(dtype);
+    const uint64_t chunk_elems = cnfg.chunk_size / dsize;
+    const int32_t left = (rank + size - 1) % size;
+    const int32_t right = (rank + 1) % size;
+
+    // In step s, segment (r - s) is passed on to the right, straight into its final place, and segment (r - s - 1) arrives from the left
+    for (int32_t s = 0; s < size - 1; s++) {
+        const auto send_seg = getSegment(count, (rank - s + size) % size);
+        const auto recv_seg = getSegment(count, (rank - s - 1 + size) % size);
+        const uint64_t n_send = numChunks(send_seg.second, chunk_elems);
+        const uint64_t n_recv = numChunks(recv_seg.second, chunk_elems);
+
+        for (uint64_t c = 0; c < std::max(n_send, n_recv); c++) {
+            if (c < n_send) {
+                const uint64_t first = send_seg.first + c * chunk_elems;
+                const uint64_t n = std::min(chunk_elems, send_seg.first + send_seg.second - first);
+                sendDirect(right, offs + first * dsize, n * dsize);
+            }
+
+            if (c < n_recv) {
+                recvDirect(left);
+            }
+        }
+    }
+}
+
+void cCollective::rdAllreduce(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op) {
+    const uint64_t dsize = dtypeSize(dtype);
+    const uint64_t chunk_elems = cnfg.chunk_size / dsize;
+    const uint64_t n_chunks = numChunks(count, chunk_elems);
+
+    // A local chunk is only reduced once its own write to the partner has completed, since both use the same memory;
+    // reductions lag behind the writes by fewer chunks than there are receive slots, so the partners can't block each other
+    const uint64_t lag = cnfg.n_slots - 1;
+    std::vector<cmdTicket> sent(n_chunks);
+
+    for (int32_t d = 1; d < size; d <<= 1) {
+        const int32_t partner = rank ^ d;
+
+        auto finish = [&](uint64_t c) {
+            const uint64_t first = c * chunk_elems;
+            const uint64_t n = std::min(chunk_elems, count - first);
+            waitFor([&] { return cthread->isDone(sent[c]); }, "a chunk to be written", partner);
+            const uint64_t slot_offs = recvSlot(partner);
+            reduce(offs + first * dsize, slot_offs, n, dtype, op);
+            release(partner);
+        };
+
+        for (uint64_t c = 0; c < n_chunks; c++) {
+            const uint64_t first = c * chunk_elems;
+            const uint64_t n = std::min(chunk_elems, count - first);
+            sent[c] = sendSlot(partner, offs + first * dsize, n * dsize);
+            if (c >= lag) {
+                finish(c - lag);
+            }
+        }
+
+        for (uint64_t c = n_chunks > lag ? n_chunks - lag : 0; c < n_chunks; c++) {
+            finish(c);
+        }
+    }
+}
+
+void cCollective::allreduce(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op, collAlgo algo) {
+    const uint64_t len = count * dtypeSize(dtype);
+    const bool pow2 = (size & (size - 1)) == 0;
+    if (algo == collAlgo::RECURSIVE_DOUBLING && !pow2) {
+        throw std::runtime_error("ERROR: cCollective - recursive doubling requires a power-of-two number of nodes");
+    }
+
+    begin(offs, len);
+    if (size > 1 && count > 0) {
+        if (algo == collAlgo::RECURSIVE_DOUBLING || (algo == collAlgo::AUTO && pow2 && len <= cnfg.rd_threshold)) {
+            DBG1("cCollective: Recursive doubling all-reduce of " << len << " bytes");
+            rdAllreduce(offs, count, dtype, op);
+        } else {
+            DBG1("cCollective: Ring all-reduce of " << len << " bytes");
+            ringReduceScatter(offs, count, dtype, op);
+            ringAllgather(offs, count, dtype);
+        }
+    }
+    end();
+}
+
+void cCollective::reduceScatter(uint64_t offs, uint64_t count, collDtype dtype, collReduceOp op) {
+    DBG1("cCollective: Reduce-scatter of " << count << " elements");
+    begin(offs, count * dtypeSize(dtype));
+    if (size > 1 && count > 0) {
+        ringReduceScatter(offs, count, dtype, op);
+    }
+    end();
+}
+
+void cCollective::broadcast(uint64_t offs, uint64_t len, int32_t root) {
+    DBG1("cCollective: Broadcast of " << len << " bytes from rank " << root);
+    if (root < 0 || root >= size) {
+        throw std::runtime_error("ERROR: cCollective - invalid root rank " + std::to_string(root));
+    }
+
+    begin(offs, len);
+    if (size > 1 && len > 0) {
+        // Chain from the root through all the ranks; each chunk is forwarded as soon as it arrives
+        const int32_t pos = (rank - root + size) % size;
+        const int32_t prev = (rank + size - 1) % size;
+        const int32_t next = (rank + 1) % size;
+        const bool has_prev = pos > 0;
+        const bool has_next = pos < size - 1;
+
+        // The buffer of this node is written to directly, so the predecessor must wait until this node has entered the broadcast
+        if (has_prev) {
+            signalReady(prev);
+        }
+        if (has_next) {
+            waitReady(next);
+        }
+
+        for (uint64_t c = 0; c < numChunks(len, cnfg.chunk_size); c++) {
+            const uint64_t c_offs = c * cnfg.chunk_size;
+            if (has_prev) {
+                recvDirect(prev);
+            }
+            if (has_next) {
+                sendDirect(next, offs + c_offs, std::min(cnfg.chunk_size, len - c_offs));
+            }
+        }
+    }
+    end();
+}
+
+std::pair<uint64_t, uint64_t> cCollective::getSegment(uint64_t count, int32_t rank) const {
+    const uint64_t first = count * rank / size;
+    const uint64_t last = count * (rank + 1) / size;
+    return {first, last - first};
+}
+
+int32_t cCollective::getRank() const {
+    return rank;
+}
+
+int32_t cCollective::getSize() const {
+    return size;
+}
+
+}
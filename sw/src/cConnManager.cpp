@@ -0,0 +1,457 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <memory>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <coyote/cConnManager.hpp>
+
+namespace coyote {
+
+cConnManager::cConnManager(cThread *cthread, int32_t node_id, uint16_t port, void *mem, uint64_t size):
+  cthread(cthread), node_id(node_id), port(port), mem(mem), size(size) {
+    DBG1("cConnManager: node " << node_id << " listening on port " << port);
+
+    listen_fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd == -1) {
+        throw std::runtime_error("ERROR: cConnManager could not create a socket");
+    }
+
+    // Allow restarting a job right away, while connections of the previous run are still in TIME_WAIT
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in server = {};
+    server.sin_family = AF_INET;
+    server.sin_port = htons(port);
+    server.sin_addr.s_addr = INADDR_ANY;
+
+    if (::bind(listen_fd, (struct sockaddr*) &server, sizeof(server)) < 0) {
+        ::close(listen_fd);
+        throw std::runtime_error("ERROR: cConnManager could not bind to port " + std::to_string(port));
+    }
+
+    if (::listen(listen_fd, CONN_MANAGER_BACKLOG) == -1) {
+        ::close(listen_fd);
+        throw std::runtime_error("ERROR: cConnManager could not listen to port " + std::to_string(port));
+    }
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd == -1) {
+        ::close(listen_fd);
+        throw std::runtime_error("ERROR: cConnManager could not create epoll file");
+    }
+
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listen_fd;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) == -1) {
+        ::close(epoll_fd);
+        ::close(listen_fd);
+        throw std::runtime_error("ERROR: cConnManager could not add the listener to epoll");
+    }
+}
+
+cConnManager::~cConnManager() {
+    DBG1("cConnManager: closing connections to " << peer_fds.size() << " peers");
+
+    for (auto &it : peer_fds) {
+        ::close(it.second);
+    }
+
+    for (auto &it : peer_qps) {
+        cthread->destroyQp(it.second);
+    }
+
+    ::close(epoll_fd);
+    ::close(listen_fd);
+}
+
+int cConnManager::openConn(const cPeer &peer) {
+    struct addrinfo *res;
+    struct addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(peer.address.c_str(), std::to_string(peer.port).c_str(), &hints, &res) != 0) {
+        DBG2("cConnManager: could not resolve " << peer.address);
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo *t = res; t; t = t->ai_next) {
+        fd = ::socket(t->ai_family, t->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, t->ai_protocol);
+        if (fd == -1) {
+            continue;
+        }
+
+        // The connection completes asynchronously, signalled by EPOLLOUT
+        if (::connect(fd, t->ai_addr, t->ai_addrlen) == 0 || errno == EINPROGRESS) {
+            break;
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+
+    return fd;
+}
+
+void cConnManager::sendMsg(int fd, qpExchangeType type, const qpExchangeMsg &msg) {
+    char buf[sizeof(qpExchangeHdr) + sizeof(qpExchangeMsg)];
+
+    qpExchangeHdr hdr;
+    hdr.magic = QP_EXCHANGE_MAGIC;
+    hdr.version = QP_EXCHANGE_VERSION;
+    hdr.type = static_cast<uint16_t>(type);
+    hdr.len = sizeof(qpExchangeMsg);
+    memcpy(buf, &hdr, sizeof(qpExchangeHdr));
+    memcpy(buf + sizeof(qpExchangeHdr), &msg, sizeof(qpExchangeMsg));
+
+    if (::send(fd, buf, sizeof(buf), MSG_NOSIGNAL) != sizeof(buf)) {
+        throw std::runtime_error("ERROR: cConnManager failed to send a QP exchange message");
+    }
+}
+
+int cConnManager::recvMsg(pendingConn &conn) {
+    size_t want = sizeof(qpExchangeHdr);
+    if (conn.rx.size() >= sizeof(qpExchangeHdr)) {
+        want += reinterpret_cast<const qpExchangeHdr*>(conn.rx.data())->len;
+    }
+
+    // Only the bytes of the current message are read, so that any later traffic stays in the socket
+    while (conn.rx.size() < want) {
+        char buf[RECV_BUFF_SIZE];
+        ssize_t n = ::read(conn.fd, buf, want - conn.rx.size());
+        if (n == 0) {
+            return -1;
+        } else if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+        conn.rx.insert(conn.rx.end(), buf, buf + n);
+
+        // Validate the header before trusting its length
+        if (conn.rx.size() == sizeof(qpExchangeHdr)) {
+            qpExchangeHdr hdr;
+            memcpy(&hdr, conn.rx.data(), sizeof(qpExchangeHdr));
+            if (hdr.magic != QP_EXCHANGE_MAGIC) {
+                throw std::runtime_error("ERROR: cConnManager received a message which is not part of the QP exchange");
+            }
+            if (hdr.version != QP_EXCHANGE_VERSION) {
+                throw std::runtime_error(
+                    "ERROR: cConnManager - peer uses QP exchange version " + std::to_string(hdr.version) + 
+                    ", this node uses version " + std::to_string(QP_EXCHANGE_VERSION)
+                );
+            }
+            if (hdr.len > RECV_BUFF_SIZE - sizeof(qpExchangeHdr)) {
+                throw std::runtime_error("ERROR: cConnManager received a QP exchange message with an invalid length");
+            }
+            want += hdr.len;
+        }
+    }
+
+    return 1;
+}
+
+qpExchangeMsg cConnManager::parseMsg(const pendingConn &conn, qpExchangeType type) {
+    qpExchangeHdr hdr;
+    memcpy(&hdr, conn.rx.data(), sizeof(qpExchangeHdr));
+    if (hdr.type != static_cast<uint16_t>(type) || hdr.len != sizeof(qpExchangeMsg)) {
+        throw std::runtime_error("ERROR: cConnManager received an unexpected QP exchange message, type " + std::to_string(hdr.type));
+    }
+
+    qpExchangeMsg msg;
+    memcpy(&msg, conn.rx.data() + sizeof(qpExchangeHdr), sizeof(qpExchangeMsg));
+    return msg;
+}
+
+void cConnManager::connect(const std::vector<cPeer> &peers, std::chrono::milliseconds timeout) {
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + timeout;
+
+    // Peers which are still to be connected, keyed by their node ID
+    std::map<int32_t, cPeer> expected;
+    for (const auto &peer : peers) {
+        if (peer.node_id == node_id || peer_qps.count(peer.node_id)) {
+            continue;
+        }
+        if (!expected.emplace(peer.node_id, peer).second) {
+            throw std::runtime_error("ERROR: cConnManager::connect() - node ID " + std::to_string(peer.node_id) + " is listed twice");
+        }
+    }
+    DBG1("cConnManager: node " << node_id << " connecting to " << expected.size() << " peers");
+
+    // This node connects to the peers with a lower node ID; next attempt for each of them
+    std::map<int32_t, std::chrono::steady_clock::time_point> to_dial;
+    for (const auto &it : expected) {
+        if (it.first < node_id) {
+            to_dial.emplace(it.first, start);
+        }
+    }
+
+    // Exchanges in progress, keyed by socket, and QPs of outgoing exchanges, kept across connection attempts
+    std::map<int, std::unique_ptr<pendingConn>> conns;
+    std::map<int32_t, int32_t> pending_qps;
+
+    auto dropConn = [&](int fd) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        ::close(fd);
+        conns.erase(fd);
+    };
+
+    auto watchConn = [&](int fd, uint32_t events, int op) {
+        struct epoll_event event = {};
+        event.events = events;
+        event.data.fd = fd;
+        if (epoll_ctl(epoll_fd, op, fd, &event) == -1) {
+            throw std::runtime_error("ERROR: cConnManager could not add a connection to epoll");
+        }
+    };
+
+    // Programs the peer's QP and keeps the connection as a blocking socket, for out-of-band synchronization
+    auto finishConn = [&](int fd, const qpExchangeMsg &msg, int32_t qp_id) {
+        cthread->connectQp(qp_id, msg.qp, port);
+
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        peer_qps.emplace(msg.node_id, qp_id);
+        peer_fds.emplace(msg.node_id, fd);
+        expected.erase(msg.node_id);
+        conns.erase(fd);
+        DBG2("cConnManager: node " << node_id << " connected to node " << msg.node_id << " through QP " << qp_id);
+    };
+
+    try {
+        while (!expected.empty()) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= deadline) {
+                break;
+            }
+
+            // Open connections to peers that are due; failed attempts are retried later
+            for (auto it = to_dial.begin(); it != to_dial.end();) {
+                if (it->second > now) {
+                    it++;
+                    continue;
+                }
+
+                int fd = openConn(expected.at(it->first));
+                if (fd == -1) {
+                    it->second = now + std::chrono::milliseconds(CONN_MANAGER_RETRY_INTERVAL);
+                    it++;
+                    continue;
+                }
+
+                auto conn = std::make_unique<pendingConn>();
+                conn->fd = fd;
+                conn->node_id = it->first;
+                conn->outgoing = true;
+                conn->connecting = true;
+                conns.emplace(fd, std::move(conn));
+                watchConn(fd, EPOLLOUT, EPOLL_CTL_ADD);
+
+                it = to_dial.erase(it);
+            }
+
+            // Wait for events, until the next connection attempt or the deadline
+            auto wake = deadline;
+            for (const auto &it : to_dial) {
+                wake = std::min(wake, it.second);
+            }
+            int wait_ms = std::max(0L, static_cast<long>(std::chrono::ceil<std::chrono::milliseconds>(wake - now).count()));
+
+            struct epoll_event events[MAX_EVENTS];
+            int n = epoll_wait(epoll_fd, events, MAX_EVENTS, wait_ms);
+            if (n == -1) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("ERROR: cConnManager - epoll_wait failed");
+            }
+
+            for (int i = 0; i < n; i++) {
+                int fd = events[i].data.fd;
+
+                // New peers; accept all of them at once
+                if (fd == listen_fd) {
+                    int cfd;
+                    while ((cfd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) != -1) {
+                        auto conn = std::make_unique<pendingConn>();
+                        conn->fd = cfd;
+                        conns.emplace(cfd, std::move(conn));
+                        watchConn(cfd, EPOLLIN, EPOLL_CTL_ADD);
+                    }
+                    continue;
+                }
+
+                auto it = conns.find(fd);
+                if (it == conns.end()) {
+                    continue;
+                }
+                pendingConn &conn = *it->second;
+
+                // Outgoing connection established (or refused); send HELLO with the QP dedicated to the peer
+                if (conn.connecting) {
+                    int err = 0;
+                    socklen_t len = sizeof(err);
+                    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == -1 || err != 0) {
+                        // Most likely, the peer isn't listening yet
+                        to_dial[conn.node_id] = now + std::chrono::milliseconds(CONN_MANAGER_RETRY_INTERVAL);
+                        dropConn(fd);
+                        continue;
+                    }
+
+                    if (!pending_qps.count(conn.node_id)) {
+                        pending_qps.emplace(conn.node_id, cthread->createQp(mem, size));
+                    }
+
+                    conn.connecting = false;
+                    watchConn(fd, EPOLLIN, EPOLL_CTL_MOD);
+                    sendMsg(fd, qpExchangeType::HELLO, {node_id, cthread->getQpair(pending_qps.at(conn.node_id))->local});
+                    continue;
+                }
+
+                int ret = recvMsg(conn);
+                if (ret == 0) {
+                    continue;
+                } else if (ret < 0) {
+                    // The peer went away; retry outgoing connections, since the peer might be restarting
+                    if (conn.outgoing) {
+                        to_dial[conn.node_id] = now + std::chrono::milliseconds(CONN_MANAGER_RETRY_INTERVAL);
+                    }
+                    dropConn(fd);
+                    continue;
+                }
+
+                if (conn.outgoing) {
+                    qpExchangeMsg msg = parseMsg(conn, qpExchangeType::REPLY);
+                    if (msg.node_id != conn.node_id) {
+                        throw std::runtime_error(
+                            "ERROR: cConnManager - expected node " + std::to_string(conn.node_id) + 
+                            " at " + expected.at(conn.node_id).address + ", but node " + std::to_string(msg.node_id) + " replied"
+                        );
+                    }
+
+                    int32_t qp_id = pending_qps.at(msg.node_id);
+                    pending_qps.erase(msg.node_id);
+                    finishConn(fd, msg, qp_id);
+
+                } else {
+                    qpExchangeMsg msg = parseMsg(conn, qpExchangeType::HELLO);
+                    if (msg.node_id <= node_id || !expected.count(msg.node_id)) {
+                        throw std::runtime_error("ERROR: cConnManager - unexpected connection from node " + std::to_string(msg.node_id));
+                    }
+
+                    int32_t qp_id = cthread->createQp(mem, size);
+                    try {
+                        sendMsg(fd, qpExchangeType::REPLY, {node_id, cthread->getQpair(qp_id)->local});
+                    } catch (...) {
+                        cthread->destroyQp(qp_id);
+                        throw;
+                    }
+                    finishConn(fd, msg, qp_id);
+                }
+            }
+        }
+    } catch (...) {
+        for (auto &it : conns) {
+            epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it.first, NULL);
+            ::close(it.first);
+        }
+        for (auto &it : pending_qps) {
+            cthread->destroyQp(it.second);
+        }
+        throw;
+    }
+
+    // Time-out; release the exchanges still in progress
+    for (auto &it : conns) {
+        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it.first, NULL);
+        ::close(it.first);
+    }
+    for (auto &it : pending_qps) {
+        cthread->destroyQp(it.second);
+    }
+
+    if (!expected.empty()) {
+        std::ostringstream missing;
+        for (const auto &it : expected) {
+            missing << " " << it.first;
+        }
+        throw std::runtime_error(
+            "ERROR: cConnManager::connect() timed out; " + std::to_string(expected.size()) + " peers not connected:" + missing.str()
+        );
+    }
+
+    DBG1(
+        "cConnManager: node " << node_id << " connected to all " << peer_qps.size() << " peers in " << 
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms"
+    );
+}
+
+int32_t cConnManager::getQp(int32_t peer_id) const {
+    auto it = peer_qps.find(peer_id);
+    if (it == peer_qps.end()) {
+        throw std::runtime_error("ERROR: cConnManager - node " + std::to_string(peer_id) + " is not connected");
+    }
+    return it->second;
+}
+
+int cConnManager::getSocket(int32_t peer_id) const {
+    auto it = peer_fds.find(peer_id);
+    if (it == peer_fds.end()) {
+        throw std::runtime_error("ERROR: cConnManager - node " + std::to_string(peer_id) + " is not connected");
+    }
+    return it->second;
+}
+
+std::vector<int32_t> cConnManager::getPeers() const {
+    std::vector<int32_t> ids;
+    for (const auto &it : peer_qps) {
+        ids.push_back(it.first);
+    }
+    return ids;
+}
+
+int32_t cConnManager::getNodeId() const { return node_id; }
+
+}
@@ -0,0 +1,252 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <coyote/cCopyEngine.hpp>
+
+namespace coyote {
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/// Utility function, copies with 256-bit non-temporal stores; the destination is aligned first, the source can be unaligned
+__attribute__((target("avx2")))
+static void streamCopyAvx2(void *dst, const void *src, size_t len) {
+    char *d = (char*) dst;
+    const char *s = (const char*) src;
+
+    size_t head = std::min(len, (32 - (reinterpret_cast<uintptr_t>(d) & 31)) & 31);
+    memcpy(d, s, head);
+    d += head; s += head; len -= head;
+
+    for (; len >= 128; len -= 128, d += 128, s += 128) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*) s);
+        __m256i v1 = _mm256_loadu_si256((const __m256i*) (s + 32));
+        __m256i v2 = _mm256_loadu_si256((const __m256i*) (s + 64));
+        __m256i v3 = _mm256_loadu_si256((const __m256i*) (s + 96));
+        _mm256_stream_si256((__m256i*) d, v0);
+        _mm256_stream_si256((__m256i*) (d + 32), v1);
+        _mm256_stream_si256((__m256i*) (d + 64), v2);
+        _mm256_stream_si256((__m256i*) (d + 96), v3);
+    }
+
+    for (; len >= 32; len -= 32, d += 32, s += 32) {
+        _mm256_stream_si256((__m256i*) d, _mm256_loadu_si256((const __m256i*) s));
+    }
+
+    memcpy(d, s, len);
+
+    // Non-temporal stores are weakly ordered; make them visible before the copy is reported as completed
+    _mm_sfence();
+}
+
+/// Utility function, same as above, with 512-bit non-temporal stores
+__attribute__((target("avx512f")))
+static void streamCopyAvx512(void *dst, const void *src, size_t len) {
+    char *d = (char*) dst;
+    const char *s = (const char*) src;
+
+    size_t head = std::min(len, (64 - (reinterpret_cast<uintptr_t>(d) & 63)) & 63);
+    memcpy(d, s, head);
+    d += head; s += head; len -= head;
+
+    for (; len >= 256; len -= 256, d += 256, s += 256) {
+        __m512i v0 = _mm512_loadu_si512((const void*) s);
+        __m512i v1 = _mm512_loadu_si512((const void*) (s + 64));
+        __m512i v2 = _mm512_loadu_si512((const void*) (s + 128));
+        __m512i v3 = _mm512_loadu_si512((const void*) (s + 192));
+        _mm512_stream_si512((__m512i*) d, v0);
+        _mm512_stream_si512((__m512i*) (d + 64), v1);
+        _mm512_stream_si512((__m512i*) (d + 128), v2);
+        _mm512_stream_si512((__m512i*) (d + 192), v3);
+    }
+
+    for (; len >= 64; len -= 64, d += 64, s += 64) {
+        _mm512_stream_si512((__m512i*) d, _mm512_loadu_si512((const void*) s));
+    }
+
+    memcpy(d, s, len);
+    _mm_sfence();
+}
+
+#endif
+
+/// Utility function, fallback for CPUs without AVX2
+static void plainCopy(void *dst, const void *src, size_t len) {
+    memcpy(dst, src, len);
+}
+
+/// Utility function, picks the widest streaming copy supported by the CPU
+static void (*selectStreamCopy())(void*, const void*, size_t) {
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return streamCopyAvx512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return streamCopyAvx2;
+    }
+    #endif
+    return plainCopy;
+}
+
+uint64_t copyCounter::reserve() {
+    std::lock_guard<std::mutex> lock(clock);
+    return n_reserved++;
+}
+
+void copyCounter::finish(uint64_t pos, bool last) {
+    std::lock_guard<std::mutex> lock(clock);
+    finished.emplace(pos, last);
+
+    // Advance over the finished prefix; the counter only moves in the order the copies were reserved
+    while (!finished.empty() && finished.begin()->first == n_done) {
+        if (finished.begin()->second) {
+            cmpl.fetch_add(1, std::memory_order_release);
+        }
+        finished.erase(finished.begin());
+        n_done++;
+    }
+
+    if (n_done == n_reserved) {
+        cdone.notify_all();
+    }
+}
+
+void copyCounter::drain() {
+    std::unique_lock<std::mutex> lock(clock);
+    cdone.wait(lock, [this] { return n_done == n_reserved; });
+}
+
+void copyCounter::clear() {
+    std::unique_lock<std::mutex> lock(clock);
+    cdone.wait(lock, [this] { return n_done == n_reserved; });
+    cmpl.store(0, std::memory_order_release);
+}
+
+cCopyEngine& cCopyEngine::getInstance() {
+    static cCopyEngine engine;
+    return engine;
+}
+
+cCopyEngine::~cCopyEngine() {
+    setThreads(0);
+}
+
+void cCopyEngine::setThreads(uint32_t n) {
+    DBG1("cCopyEngine: Setting the number of workers to " << n);
+
+    // Stop the current workers; they exit once the queue is empty, while new copies are executed synchronously
+    std::vector<std::thread> stopped;
+    {
+        std::lock_guard<std::mutex> lock(qlock);
+        terminate = true;
+        stopped.swap(workers);
+    }
+    qcv.notify_all();
+
+    for (auto &worker : stopped) {
+        worker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(qlock);
+    terminate = false;
+    for (uint32_t i = 0; i < n; i++) {
+        workers.emplace_back(&cCopyEngine::run, this);
+    }
+}
+
+uint32_t cCopyEngine::getThreads() {
+    std::lock_guard<std::mutex> lock(qlock);
+    return workers.size();
+}
+
+void cCopyEngine::submit(void *dst, const void *src, size_t len, std::function<void()> done) {
+    std::unique_lock<std::mutex> lock(qlock);
+    if (workers.empty()) {
+        lock.unlock();
+        copy(dst, src, len);
+        done();
+        return;
+    }
+
+    // Split large copies into chunks, so they are spread across the workers
+    uint32_t n_chunks = std::max<size_t>(1, (len + COPY_ENGINE_CHUNK_SIZE - 1) / COPY_ENGINE_CHUNK_SIZE);
+    auto pending = std::make_shared<std::atomic<uint32_t>>(n_chunks);
+    auto callback = std::make_shared<std::function<void()>>(std::move(done));
+
+    for (uint32_t i = 0; i < n_chunks; i++) {
+        size_t offs = i * COPY_ENGINE_CHUNK_SIZE;
+        tasks.push_back({(char*) dst + offs, (const char*) src + offs, std::min<size_t>(len - offs, COPY_ENGINE_CHUNK_SIZE), pending, callback});
+    }
+    lock.unlock();
+
+    if (n_chunks == 1) {
+        qcv.notify_one();
+    } else {
+        qcv.notify_all();
+    }
+}
+
+void cCopyEngine::copy(void *dst, const void *src, size_t len) {
+    // Small copies stay in the caches, which benefits a consumer reading the data right after
+    if (len < COPY_ENGINE_NT_THRESHOLD) {
+        memcpy(dst, src, len);
+        return;
+    }
+
+    static void (* const stream_copy)(void*, const void*, size_t) = selectStreamCopy();
+    stream_copy(dst, src, len);
+}
+
+void cCopyEngine::run() {
+    while (true) {
+        copyTask task;
+        {
+            std::unique_lock<std::mutex> lock(qlock);
+            qcv.wait(lock, [this] { return terminate || !tasks.empty(); });
+            if (tasks.empty()) {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+
+        copy(task.dst, task.src, task.len);
+
+        // The worker finishing the final chunk completes the copy
+        if (task.pending->fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            (*task.done)();
+        }
+    }
+}
+
+}
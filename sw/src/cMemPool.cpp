@@ -0,0 +1,334 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <sys/mman.h>
+
+#include <coyote/cMemPool.hpp>
+
+namespace coyote {
+
+// The free-list heads pack a 48-bit user-space pointer and a 16-bit tag, which is incremented on every update
+constexpr uint64_t const FREE_PTR_MASK = (1ULL << 48) - 1;
+constexpr uint64_t const FREE_TAG_INC = (1ULL << 48);
+
+// Marks slabs which haven't been carved yet
+constexpr uint8_t const SLAB_UNUSED = 0xFF;
+
+/// Slot of the calling thread, shared across all pools; -1 if all slots are taken
+static int32_t threadSlot() {
+    static std::atomic<uint32_t> next_slot = { 0 };
+    thread_local uint32_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot < MEM_POOL_MAX_THREADS ? (int32_t) slot : -1;
+}
+
+/// Increments a statistic counter; counters owned by a single thread avoid the atomic read-modify-write
+template<typename T>
+static inline void addCounter(std::atomic<T> &cnt, T val, bool shared) {
+    if (shared) {
+        cnt.fetch_add(val, std::memory_order_relaxed);
+    } else {
+        cnt.store(cnt.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+    }
+}
+
+/// Size class for a given allocation size; class i holds blocks of MEM_POOL_MIN_BLOCK << i bytes
+static inline uint32_t sizeClass(uint64_t size) {
+    if (size <= MEM_POOL_MIN_BLOCK) {
+        return 0;
+    }
+    return (64 - __builtin_clzll(size - 1)) - PAGE_SHIFT;
+}
+
+cMemPool::cMemPool(cThread &thread, CoyoteAllocType type, uint64_t arena_size) : thread(thread), type(type) {
+    DBG1("cMemPool: Creating memory pool with arena size " << arena_size);
+
+    if (type != CoyoteAllocType::REG && type != CoyoteAllocType::THP && type != CoyoteAllocType::HPF && type != CoyoteAllocType::HPF_1G) {
+        throw std::runtime_error("ERROR: cMemPool only supports REG, THP, HPF and HPF_1G memory");
+    }
+
+    // Arenas of huge pages must be a multiple of the page size, which for HPF depends on the shell's TLB
+    uint64_t align;
+    switch (type) {
+        case CoyoteAllocType::REG: align = MEM_POOL_SLAB_SIZE; break;
+        case CoyoteAllocType::HPF: align = std::max<uint64_t>(thread.getHugePageSize(), HUGE_PAGE_SIZE); break;
+        case CoyoteAllocType::HPF_1G: align = HUGE_PAGE_1G_SIZE; break;
+        default: align = HUGE_PAGE_SIZE; break;
+    }
+    this->arena_size = ((std::max(arena_size, align) + align - 1) / align) * align;
+
+    // Regular memory is only page-aligned; pad it, so that the slabs (and therefore the blocks) are naturally aligned
+    arena_pad = (type == CoyoteAllocType::REG) ? MEM_POOL_SLAB_SIZE - PAGE_SIZE : 0;
+
+    for (uint32_t i = 0; i < MEM_POOL_N_CLASSES; i++) {
+        free_heads[i].store(0, std::memory_order_relaxed);
+    }
+
+    caches = std::make_unique<threadCache[]>(MEM_POOL_MAX_THREADS);
+    counters = std::make_unique<poolCounters[]>(MEM_POOL_MAX_THREADS + 1);
+
+    std::lock_guard<std::mutex> lock(plock);
+    if (!addArena()) {
+        throw std::runtime_error("ERROR: cMemPool failed to map the initial arena");
+    }
+}
+
+cMemPool::~cMemPool() {
+    DBG1("cMemPool: Releasing memory pool");
+
+    for (uint32_t i = 0; i < n_arenas.load(std::memory_order_acquire); i++) {
+        thread.freeMem(arenas[i].mem);
+    }
+
+    for (auto &it : large_allocs) {
+        thread.freeMem(it.first);
+    }
+}
+
+bool cMemPool::addArena() {
+    uint32_t idx = n_arenas.load(std::memory_order_relaxed);
+    if (idx >= MEM_POOL_MAX_ARENAS) {
+        std::cerr << "ERROR: cMemPool::addArena() - Maximum number of arenas reached" << std::endl;
+        return false;
+    }
+
+    void *mem = thread.getMem({type, arena_size + arena_pad});
+    if (mem == nullptr || mem == MAP_FAILED) {
+        std::cerr << "ERROR: cMemPool::addArena() - Failed to obtain memory for a new arena" << std::endl;
+        return false;
+    }
+    DBG1("cMemPool: Mapped arena " << idx << " at " << mem);
+
+    uint64_t n_slabs = arena_size / MEM_POOL_SLAB_SIZE;
+    arenas[idx].mem = mem;
+    arenas[idx].base = reinterpret_cast<char*>((reinterpret_cast<uint64_t>(mem) + MEM_POOL_SLAB_SIZE - 1) & ~(MEM_POOL_SLAB_SIZE - 1));
+    arenas[idx].size = arena_size;
+    arenas[idx].slab_class = std::make_unique<uint8_t[]>(n_slabs);
+    std::fill(arenas[idx].slab_class.get(), arenas[idx].slab_class.get() + n_slabs, SLAB_UNUSED);
+    n_slabs_used = 0;
+
+    // Publish the arena, so that findClass() can look up blocks from it
+    n_arenas.store(idx + 1, std::memory_order_release);
+    return true;
+}
+
+void* cMemPool::refill(uint32_t cls) {
+    std::lock_guard<std::mutex> lock(plock);
+
+    // Another thread may have refilled the free-list while waiting for the lock
+    void *block = popBlock(cls);
+    if (block) {
+        return block;
+    }
+
+    memArena *arena = &arenas[n_arenas.load(std::memory_order_relaxed) - 1];
+    if ((n_slabs_used + 1) * MEM_POOL_SLAB_SIZE > arena->size) {
+        if (!addArena()) {
+            return nullptr;
+        }
+        arena = &arenas[n_arenas.load(std::memory_order_relaxed) - 1];
+    }
+
+    char *slab = arena->base + n_slabs_used * MEM_POOL_SLAB_SIZE;
+    arena->slab_class[n_slabs_used] = cls;
+    n_slabs_used++;
+    n_slab_refills++;
+
+    // Keep the first block for the caller and chain the remaining ones onto the free-list 
+    uint64_t block_size = MEM_POOL_MIN_BLOCK << cls;
+    uint64_t n_blocks = MEM_POOL_SLAB_SIZE / block_size;
+    if (n_blocks > 1) {
+        for (uint64_t i = 1; i < n_blocks - 1; i++) {
+            *reinterpret_cast<void**>(slab + i * block_size) = slab + (i + 1) * block_size;
+        }
+        pushBlocks(cls, slab + block_size, slab + (n_blocks - 1) * block_size);
+    }
+
+    return slab;
+}
+
+void cMemPool::pushBlocks(uint32_t cls, void *first, void *last) {
+    uint64_t head = free_heads[cls].load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do {
+        *reinterpret_cast<void**>(last) = reinterpret_cast<void*>(head & FREE_PTR_MASK);
+        new_head = (reinterpret_cast<uint64_t>(first) & FREE_PTR_MASK) | ((head & ~FREE_PTR_MASK) + FREE_TAG_INC);
+    } while (!free_heads[cls].compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void* cMemPool::popBlock(uint32_t cls) {
+    uint64_t head = free_heads[cls].load(std::memory_order_acquire);
+    while (head & FREE_PTR_MASK) {
+        void *block = reinterpret_cast<void*>(head & FREE_PTR_MASK);
+
+        // The block may be popped by another thread in the meantime; arenas stay mapped, so the read is safe and the tag catches the stale value
+        void *next = *reinterpret_cast<void* volatile*>(block);
+        uint64_t new_head = (reinterpret_cast<uint64_t>(next) & FREE_PTR_MASK) | ((head & ~FREE_PTR_MASK) + FREE_TAG_INC);
+        if (free_heads[cls].compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire)) {
+            return block;
+        }
+    }
+    return nullptr;
+}
+
+int32_t cMemPool::findClass(void *ptr) const {
+    char *addr = static_cast<char*>(ptr);
+    uint32_t n = n_arenas.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < n; i++) {
+        if (addr >= arenas[i].base && addr < arenas[i].base + arenas[i].size) {
+            uint8_t cls = arenas[i].slab_class[(addr - arenas[i].base) / MEM_POOL_SLAB_SIZE];
+            return cls == SLAB_UNUSED ? -1 : cls;
+        }
+    }
+    return -1;
+}
+
+void* cMemPool::alloc(uint64_t size) {
+    if (size == 0) {
+        return nullptr;
+    }
+
+    int32_t slot = threadSlot();
+    bool shared = slot < 0;
+    poolCounters &cnt = counters[shared ? MEM_POOL_MAX_THREADS : slot];
+    addCounter<uint64_t>(cnt.n_allocs, 1, shared);
+
+    // Large buffers bypass the pool
+    if (size > MEM_POOL_SLAB_SIZE) {
+        DBG1("cMemPool: Forwarding allocation of " << size << " bytes to getMem");
+        std::lock_guard<std::mutex> lock(plock);
+        void *mem = thread.getMem({type, size});
+        if (mem == nullptr || mem == MAP_FAILED) {
+            return nullptr;
+        }
+        large_allocs[mem] = size;
+        large_bytes += size;
+        addCounter<int64_t>(cnt.used_bytes, size, shared);
+        return mem;
+    }
+
+    uint32_t cls = sizeClass(size);
+    void *block = nullptr;
+
+    if (!shared) {
+        threadCache &cache = caches[slot];
+        if (cache.n_blocks[cls] > 0) {
+            block = cache.blocks[cls][--cache.n_blocks[cls]];
+            addCounter<uint64_t>(cnt.n_cache_hits, 1, false);
+        } else {
+            // Take half a cache worth of blocks from the free-list, to amortize the atomic operations over several allocations
+            block = popBlock(cls);
+            while (block && cache.n_blocks[cls] < MEM_POOL_CACHE_SIZE / 2) {
+                void *next = popBlock(cls);
+                if (!next) {
+                    break;
+                }
+                cache.blocks[cls][cache.n_blocks[cls]++] = next;
+            }
+        }
+    } else {
+        block = popBlock(cls);
+    }
+
+    if (!block) {
+        block = refill(cls);
+        if (!block) {
+            return nullptr;
+        }
+    }
+
+    addCounter<int64_t>(cnt.used_bytes, MEM_POOL_MIN_BLOCK << cls, shared);
+    return block;
+}
+
+void cMemPool::free(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    int32_t slot = threadSlot();
+    bool shared = slot < 0;
+    poolCounters &cnt = counters[shared ? MEM_POOL_MAX_THREADS : slot];
+
+    int32_t cls = findClass(ptr);
+    if (cls < 0) {
+        std::lock_guard<std::mutex> lock(plock);
+        auto it = large_allocs.find(ptr);
+        if (it == large_allocs.end()) {
+            std::cerr << "ERROR: cMemPool::free() - Buffer at " << ptr << " was not allocated from this pool" << std::endl;
+            return;
+        }
+
+        addCounter<uint64_t>(cnt.n_frees, 1, shared);
+        addCounter<int64_t>(cnt.used_bytes, -static_cast<int64_t>(it->second), shared);
+        large_bytes -= it->second;
+        large_allocs.erase(it);
+        thread.freeMem(ptr);
+        return;
+    }
+
+    addCounter<uint64_t>(cnt.n_frees, 1, shared);
+    addCounter<int64_t>(cnt.used_bytes, -static_cast<int64_t>(MEM_POOL_MIN_BLOCK << cls), shared);
+
+    if (!shared) {
+        threadCache &cache = caches[slot];
+
+        // If the cache is full, return half of it to the free-list as one chain
+        if (cache.n_blocks[cls] == MEM_POOL_CACHE_SIZE) {
+            uint32_t first = MEM_POOL_CACHE_SIZE / 2;
+            for (uint32_t i = first; i < MEM_POOL_CACHE_SIZE - 1; i++) {
+                *reinterpret_cast<void**>(cache.blocks[cls][i]) = cache.blocks[cls][i + 1];
+            }
+            pushBlocks(cls, cache.blocks[cls][first], cache.blocks[cls][MEM_POOL_CACHE_SIZE - 1]);
+            cache.n_blocks[cls] = first;
+        }
+        cache.blocks[cls][cache.n_blocks[cls]++] = ptr;
+    } else {
+        pushBlocks(cls, ptr, ptr);
+    }
+}
+
+memPoolStats cMemPool::getStats() const {
+    memPoolStats stats;
+
+    int64_t used_bytes = 0;
+    for (uint32_t i = 0; i <= MEM_POOL_MAX_THREADS; i++) {
+        stats.n_allocs += counters[i].n_allocs.load(std::memory_order_relaxed);
+        stats.n_frees += counters[i].n_frees.load(std::memory_order_relaxed);
+        stats.n_cache_hits += counters[i].n_cache_hits.load(std::memory_order_relaxed);
+        used_bytes += counters[i].used_bytes.load(std::memory_order_relaxed);
+    }
+    stats.used_bytes = used_bytes > 0 ? used_bytes : 0;
+
+    std::lock_guard<std::mutex> lock(plock);
+    stats.n_slab_refills = n_slab_refills;
+    stats.n_large_allocs = large_allocs.size();
+    stats.n_arenas = n_arenas.load(std::memory_order_relaxed);
+    stats.mapped_bytes = stats.n_arenas * (arena_size + arena_pad) + large_bytes;
+
+    return stats;
+}
+
+}
@@ -0,0 +1,257 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <algorithm>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <coyote/cOobGroup.hpp>
+
+namespace coyote {
+
+/// Utility function, collects the out-of-band sockets of all the peers of a connection manager
+static std::map<int32_t, int> connSockets(const cConnManager &conn) {
+    std::map<int32_t, int> peer_fds;
+    for (int32_t peer : conn.getPeers()) {
+        peer_fds.emplace(peer, conn.getSocket(peer));
+    }
+    return peer_fds;
+}
+
+cOobGroup::cOobGroup(const cConnManager &conn, std::chrono::milliseconds timeout):
+  cOobGroup(conn.getNodeId(), connSockets(conn), timeout) {}
+
+cOobGroup::cOobGroup(int32_t node_id, const std::map<int32_t, int> &peer_fds, std::chrono::milliseconds timeout):
+  timeout(timeout) {
+    // Ranks follow the order of the node IDs, so all nodes agree on them without any communication
+    for (const auto &it : peer_fds) {
+        if (it.first == node_id) {
+            throw std::runtime_error("ERROR: cOobGroup - the peers must not include this node");
+        }
+        nodes.push_back(it.first);
+    }
+    nodes.push_back(node_id);
+    std::sort(nodes.begin(), nodes.end());
+
+    for (size_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i] == node_id) {
+            rank = i;
+            fds.push_back(-1);
+        } else {
+            fds.push_back(peer_fds.at(nodes[i]));
+        }
+    }
+
+    DBG1("cOobGroup: node " << node_id << " has rank " << rank << " in a group of " << nodes.size());
+}
+
+void cOobGroup::exchange(
+    int32_t send_rank, const void *sbuf, uint64_t slen, int32_t recv_rank, void *rbuf, uint64_t rlen, 
+    oobCollOp op, uint16_t round, std::chrono::steady_clock::time_point deadline
+) {
+    const uint64_t hdr_len = sizeof(oobMsgHdr);
+    oobMsgHdr shdr = {seq, static_cast<uint16_t>(op), round, slen};
+    oobMsgHdr rhdr;
+
+    const int sfd = send_rank < 0 ? -1 : fds[send_rank];
+    const int rfd = recv_rank < 0 ? -1 : fds[recv_rank];
+    const uint64_t s_total = send_rank < 0 ? 0 : hdr_len + slen;
+    const uint64_t r_total = recv_rank < 0 ? 0 : hdr_len + rlen;
+    uint64_t s_done = 0, r_done = 0;
+
+    while (s_done < s_total || r_done < r_total) {
+        // Wait until either direction can progress; if both go to the same peer, a single entry covers both
+        struct pollfd pfds[2];
+        int n_pfds = 0, s_idx = -1, r_idx = -1;
+        if (s_done < s_total) {
+            pfds[n_pfds] = {sfd, POLLOUT, 0};
+            s_idx = n_pfds++;
+        }
+        if (r_done < r_total) {
+            if (s_idx >= 0 && sfd == rfd) {
+                pfds[s_idx].events |= POLLIN;
+                r_idx = s_idx;
+            } else {
+                pfds[n_pfds] = {rfd, POLLIN, 0};
+                r_idx = n_pfds++;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline) {
+            throw std::runtime_error(
+                "ERROR: cOobGroup - collective " + std::to_string(seq) + " timed out in round " + std::to_string(round) + 
+                (r_done < r_total ? ", waiting for node " + std::to_string(nodes[recv_rank]) : std::string(""))
+            );
+        }
+
+        int ret = poll(pfds, n_pfds, static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count()));
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("ERROR: cOobGroup - poll failed");
+        }
+
+        // Send the header, then the payload
+        if (s_idx >= 0 && (pfds[s_idx].revents & (POLLOUT | POLLERR | POLLHUP))) {
+            const char *ptr = s_done < hdr_len ? reinterpret_cast<const char*>(&shdr) + s_done : static_cast<const char*>(sbuf) + (s_done - hdr_len);
+            uint64_t rem = s_done < hdr_len ? hdr_len - s_done : s_total - s_done;
+
+            ssize_t k = ::send(sfd, ptr, rem, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if (k < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                throw std::runtime_error("ERROR: cOobGroup - failed to send to node " + std::to_string(nodes[send_rank]));
+            }
+            s_done += std::max(k, static_cast<ssize_t>(0));
+        }
+
+        // Receive the header, then the payload; reading exactly one message leaves later ones in the socket
+        if (r_idx >= 0 && (pfds[r_idx].revents & (POLLIN | POLLERR | POLLHUP))) {
+            char *ptr = r_done < hdr_len ? reinterpret_cast<char*>(&rhdr) + r_done : static_cast<char*>(rbuf) + (r_done - hdr_len);
+            uint64_t rem = r_done < hdr_len ? hdr_len - r_done : r_total - r_done;
+
+            ssize_t k = ::recv(rfd, ptr, rem, MSG_DONTWAIT);
+            if (k == 0) {
+                throw std::runtime_error("ERROR: cOobGroup - node " + std::to_string(nodes[recv_rank]) + " closed the connection");
+            } else if (k < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                throw std::runtime_error("ERROR: cOobGroup - failed to receive from node " + std::to_string(nodes[recv_rank]));
+            }
+            r_done += std::max(k, static_cast<ssize_t>(0));
+
+            if (k > 0 && r_done == hdr_len) {
+                if (rhdr.seq != seq || rhdr.op != static_cast<uint16_t>(op) || rhdr.round != round || rhdr.len != rlen) {
+                    throw std::runtime_error(
+                        "ERROR: cOobGroup - node " + std::to_string(nodes[recv_rank]) + " is in a different collective; expected " + 
+                        "collective " + std::to_string(seq) + " (op " + std::to_string(static_cast<uint16_t>(op)) + ", round " + std::to_string(round) + 
+                        ", " + std::to_string(rlen) + " bytes), received collective " + std::to_string(rhdr.seq) + " (op " + std::to_string(rhdr.op) + 
+                        ", round " + std::to_string(rhdr.round) + ", " + std::to_string(rhdr.len) + " bytes)"
+                    );
+                }
+            }
+        }
+    }
+}
+
+void cOobGroup::record(oobCollOp op, std::chrono::steady_clock::time_point start) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    oobCollStats &s = stats[static_cast<uint16_t>(op)];
+    s.n_calls++;
+    s.total += elapsed;
+    s.min = std::min(s.min, elapsed);
+    s.max = std::max(s.max, elapsed);
+    seq++;
+}
+
+void cOobGroup::barrier() {
+    DBG1("cOobGroup: Called barrier " << seq);
+    auto start = std::chrono::steady_clock::now();
+    const int32_t size = nodes.size();
+
+    // Dissemination: in round k, signal the rank 2^k ahead and wait for the rank 2^k behind
+    uint16_t round = 0;
+    for (int32_t dist = 1; dist < size; dist <<= 1, round++) {
+        exchange((rank + dist) % size, nullptr, 0, (rank - dist + size) % size, nullptr, 0, oobCollOp::BARRIER, round, start + timeout);
+    }
+
+    record(oobCollOp::BARRIER, start);
+}
+
+void cOobGroup::broadcast(void *buf, uint64_t len, int32_t root) {
+    DBG1("cOobGroup: Called broadcast " << seq << " from rank " << root << " with length " << len);
+    auto start = std::chrono::steady_clock::now();
+    const int32_t size = nodes.size();
+
+    if (root < 0 || root >= size) {
+        throw std::runtime_error("ERROR: cOobGroup::broadcast() - invalid root rank " + std::to_string(root));
+    }
+
+    // Binomial tree, over the ranks relative to the root: receive from the parent, then forward to the children
+    const int32_t vrank = (rank - root + size) % size;
+    int32_t mask = 1;
+    uint16_t round = 0;
+    while (mask < size) {
+        if (vrank & mask) {
+            exchange(-1, nullptr, 0, (rank - mask + size) % size, buf, len, oobCollOp::BROADCAST, round, start + timeout);
+            break;
+        }
+        mask <<= 1;
+        round++;
+    }
+
+    mask >>= 1;
+    round--;
+    while (mask > 0) {
+        if (vrank + mask < size) {
+            exchange((rank + mask) % size, buf, len, -1, nullptr, 0, oobCollOp::BROADCAST, round, start + timeout);
+        }
+        mask >>= 1;
+        round--;
+    }
+
+    record(oobCollOp::BROADCAST, start);
+}
+
+void cOobGroup::allgather(const void *sbuf, uint64_t len, void *rbuf) {
+    DBG1("cOobGroup: Called allgather " << seq << " with length " << len);
+    auto start = std::chrono::steady_clock::now();
+    const int32_t size = nodes.size();
+
+    // Bruck: block i of the staging buffer holds the contribution of rank (rank + i); in round k, the first
+    // 2^k blocks are sent to the rank 2^k behind, while the next blocks are received from the rank 2^k ahead
+    std::vector<char> tmp(size * len);
+    memcpy(tmp.data(), sbuf, len);
+
+    uint16_t round = 0;
+    for (int32_t dist = 1; dist < size; dist <<= 1, round++) {
+        uint64_t n_blocks = std::min(dist, size - dist);
+        exchange(
+            (rank - dist + size) % size, tmp.data(), n_blocks * len, 
+            (rank + dist) % size, tmp.data() + dist * len, n_blocks * len, 
+            oobCollOp::ALLGATHER, round, start + timeout
+        );
+    }
+
+    // Rotate the blocks into rank order
+    for (int32_t i = 0; i < size; i++) {
+        memcpy(static_cast<char*>(rbuf) + ((rank + i) % size) * len, tmp.data() + i * len, len);
+    }
+
+    record(oobCollOp::ALLGATHER, start);
+}
+
+int32_t cOobGroup::getRank() const { return rank; }
+
+int32_t cOobGroup::getSize() const { return nodes.size(); }
+
+int32_t cOobGroup::getNodeId(int32_t rank) const { return nodes.at(rank); }
+
+oobCollStats cOobGroup::getStats(oobCollOp op) const { return stats.at(static_cast<uint16_t>(op)); }
+
+void cOobGroup::resetStats() { stats = {}; }
+
+}
@@ -0,0 +1,177 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include <coyote/cPoller.hpp>
+
+namespace coyote {
+
+/// Completion counter of an operation, in the same order as cThread::checkCompleted(); -1 if the operation has none
+static int completionCounter(CoyoteOper oper) {
+    if (isLocalWrite(oper)) {
+        return WR_WBACK;
+    } else if (isLocalRead(oper)) {
+        return RD_WBACK;
+    } else if (isRemoteRead(oper)) {
+        return RD_RDMA_WBACK;
+    } else if (isRemoteWriteOrSend(oper)) {
+        return WR_RDMA_WBACK;
+    } else {
+        return -1;
+    }
+}
+
+void cPoller::flush(pendingQueues &queues, std::vector<pendingOp> &completed) {
+    for (auto &queue : queues.queues) {
+        while (!queue.empty()) {
+            completed.push_back(queue.top());
+            queue.pop();
+        }
+    }
+}
+
+void cPoller::enqueue(cThread &thread, cmdTicket ticket, void (*callback)(void*), void *ctx) {
+    int counter = completionCounter(ticket.oper);
+    uint32_t n_clears = thread.getClearCount();
+
+    std::lock_guard<std::mutex> lock(plock);
+    if (counter < 0) {
+        ready.push_back({ticket, callback, ctx});
+    } else {
+        int32_t qp_id = isRemoteRdma(ticket.oper) ? ticket.qp_id : 0;
+        auto inserted = pending.try_emplace({&thread, qp_id});
+        pendingQueues &queues = inserted.first->second;
+
+        // Operations registered before the counters were cleared can't be ordered against the new ones; they complete on the next poll()
+        if (inserted.second) {
+            queues.n_clears = n_clears;
+        } else if (queues.n_clears != n_clears) {
+            flush(queues, ready);
+            queues.n_clears = n_clears;
+        }
+        queues.queues[counter].push({ticket, callback, ctx});
+    }
+    n_pending++;
+}
+
+size_t cPoller::poll() {
+    std::vector<pendingOp> completed;
+
+    {
+        std::lock_guard<std::mutex> lock(plock);
+        completed.swap(ready);
+
+        for (auto it = pending.begin(); it != pending.end();) {
+            // The counters were cleared, so the tickets will never be reached in order; complete them right away
+            if (it->second.n_clears != it->first.thread->getClearCount()) {
+                flush(it->second, completed);
+                it = pending.erase(it);
+                continue;
+            }
+
+            bool empty = true;
+            for (auto &queue : it->second.queues) {
+                if (queue.empty()) {
+                    continue;
+                }
+
+                // Tickets of the same type complete in order, so one read of the counter is enough for the whole queue
+                uint32_t cnt = it->first.thread->checkCompleted(queue.top().ticket.oper, it->first.qp_id);
+                while (!queue.empty() && static_cast<int32_t>(cnt - queue.top().ticket.seq) >= 0) {
+                    completed.push_back(queue.top());
+                    queue.pop();
+                }
+                empty = empty && queue.empty();
+            }
+
+            if (empty) {
+                it = pending.erase(it);
+            } else {
+                it++;
+            }
+        }
+
+        n_pending -= completed.size();
+    }
+
+    // Callbacks may enqueue new operations, so they are invoked without holding the lock
+    for (auto &op : completed) {
+        op.callback(op.ctx);
+    }
+
+    return completed.size();
+}
+
+void cPoller::drain(waitPolicy policy) {
+    auto sleep_time = policy.min_sleep;
+    uint64_t n_idle = 0;
+
+    while (getPending() > 0) {
+        if (poll() > 0) {
+            n_idle = 0;
+            sleep_time = policy.min_sleep;
+            continue;
+        }
+
+        // Back-off, as in cThread::waitCompleted()
+        n_idle++;
+        if (policy.wait == CoyoteWait::SPIN || n_idle <= policy.n_spins) {
+            continue;
+        }
+
+        switch (policy.wait) {
+            case CoyoteWait::PAUSE:
+                #if defined(__x86_64__) || defined(__i386__)
+                _mm_pause();
+                #else
+                std::this_thread::yield();
+                #endif
+                break;
+            case CoyoteWait::YIELD:
+                std::this_thread::yield();
+                break;
+            case CoyoteWait::SLEEP:
+                std::this_thread::sleep_for(sleep_time);
+                sleep_time = std::min(sleep_time * 2, policy.max_sleep);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+size_t cPoller::getPending() {
+    std::lock_guard<std::mutex> lock(plock);
+    return n_pending;
+}
+
+}
@@ -25,6 +25,7 @@
  */
 
 #include <coyote/cRcnfg.hpp>
+#include <coyote/cThread.hpp>
 
 namespace coyote {
 std::atomic<uint32_t> cRcnfg::crid_gen; 
@@ -73,15 +74,15 @@ void* cRcnfg::getMem(CoyoteAlloc&& alloc) {
 			if (ioctl(reconfig_dev_fd, IOCTL_ALLOC_HOST_RECONFIG_MEM, &tmp)) {
 				throw std::runtime_error("ERROR: IOCTL_ALLOC_HOST_RECONFIG_MEM failed");
 			}
-			mem_non_aligned = mmap(NULL, (alloc.size + 1) * HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, reconfig_dev_fd, MMAP_RECONFIG);
+			mem_non_aligned = mmap(NULL, (alloc.size + 1) * RECONFIG_BUFF_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, reconfig_dev_fd, MMAP_RECONFIG);
 			if (mem_non_aligned == MAP_FAILED) {
 				throw std::runtime_error("ERROR: reconfig_dev mmap() failed");
 			}
 
 			mlock.unlock();
 
-			// Align memory to hugepage and and store to the memory map (to keep information for future de-allocation)
-			mem = (void *)((((reinterpret_cast<uint64_t>(mem_non_aligned) + HUGE_PAGE_SIZE - 1) >> HUGE_PAGE_SHIFT)) << HUGE_PAGE_SHIFT);
+			// Align memory to the driver's buffer pages and store to the memory map (to keep information for future de-allocation)
+			mem = (void *)((((reinterpret_cast<uint64_t>(mem_non_aligned) + RECONFIG_BUFF_PAGE_SIZE - 1) >> RECONFIG_BUFF_PAGE_SHIFT)) << RECONFIG_BUFF_PAGE_SHIFT);
 			alloc.mem = mem_non_aligned;
 			mapped_pages.emplace(mem, alloc);
 			DBG2("cRcnfg: Allocated memory mapped at 0x" << std::hex << reinterpret_cast<uint64_t>(mem) << std::dec);
@@ -108,7 +109,7 @@ void cRcnfg::freeMem(void* virtual_address) {
 				tmp[1] = static_cast<uint64_t>(this->pid);
 				tmp[2] = static_cast<uint64_t>(this->crid);
 
-				if (munmap(mapped.mem, (mapped.size + 1) * HUGE_PAGE_SIZE) != 0) {
+				if (munmap(mapped.mem, (mapped.size + 1) * RECONFIG_BUFF_PAGE_SIZE) != 0) {
 					throw std::runtime_error("ERROR munmap() failed");
 				} 
 				
@@ -135,7 +136,7 @@ bitstream_t cRcnfg::readBitstream(std::ifstream& fb) {
 	// Allocate host-side, kernel memory to hold the bitsream 
 	uint64_t len = fb.tellg();
 	fb.seekg(0);
-	uint64_t n_pages = (len + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE;
+	uint64_t n_pages = (len + RECONFIG_BUFF_PAGE_SIZE - 1) / RECONFIG_BUFF_PAGE_SIZE;
 	void *vaddr = getMem({CoyoteAllocType::PRM, n_pages}); 
 
 	// Read the input-stream bytewise
@@ -189,6 +190,9 @@ void cRcnfg::reconfigureShell(std::string bitstream_path) {
 	bitstream_t bitstream = readBitstream(bitstream_file);
 	bitstream_file.close();
 	reconfigureBase(bitstream);
+
+	// The new shell may have a different configuration (e.g., services, TLB page sizes)
+	cThread::invalidateShellCnfg();
 }
 
 void cRcnfg::reconfigureApp(std::string bitstream_path, int vfid) {
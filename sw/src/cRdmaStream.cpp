@@ -0,0 +1,382 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <thread>
+#include <cstring>
+#include <algorithm>
+
+#include <sys/socket.h>
+
+#include <coyote/cRdmaStream.hpp>
+
+namespace coyote {
+
+/// Number of polls between time-out checks (and yields) while waiting
+static constexpr uint32_t const POLLS_PER_CHECK = 16;
+
+/// Utility function, space taken in the ring by a message with a header of hdr_len and a payload of len bytes
+static uint64_t msgSpace(uint64_t hdr_len, uint64_t len) {
+    return (hdr_len + len + STREAM_MSG_ALIGN - 1) / STREAM_MSG_ALIGN * STREAM_MSG_ALIGN;
+}
+
+cRdmaStream::cRdmaStream(cThread *cthread, streamRole role, streamConfig cnfg, int32_t qp_id):
+  cthread(cthread), role(role), cnfg(cnfg), qp_id(qp_id) {
+    if (cnfg.ring_size == 0 || cnfg.ring_size % STREAM_MSG_ALIGN != 0 || cnfg.ring_offs % STREAM_MSG_ALIGN != 0) {
+        throw std::runtime_error("ERROR: cRdmaStream - the ring offset and size must be multiples of " + std::to_string(STREAM_MSG_ALIGN) + " bytes");
+    }
+
+    if (cnfg.ctrl_offs < cnfg.ring_offs + cnfg.ring_size && cnfg.ring_offs < cnfg.ctrl_offs + STREAM_CTRL_SIZE) {
+        throw std::runtime_error("ERROR: cRdmaStream - the control words overlap the ring");
+    }
+
+    if (cnfg.window == 0) {
+        throw std::runtime_error("ERROR: cRdmaStream - the window must allow at least one write in flight");
+    }
+
+    if (cnfg.credits == streamCredits::OOB && cnfg.oob_fd < 0) {
+        throw std::runtime_error("ERROR: cRdmaStream - out-of-band credits require a connected socket");
+    }
+
+    const ibvQp *qp = cthread->getQpair(qp_id);
+    if (qp == nullptr) {
+        throw std::runtime_error("ERROR: cRdmaStream - the queue pair has not been set up");
+    }
+
+    if (std::max<uint64_t>(cnfg.ring_offs + cnfg.ring_size, cnfg.ctrl_offs + STREAM_CTRL_SIZE) > qp->local.size) {
+        throw std::runtime_error("ERROR: cRdmaStream - the ring and the control words must fit into the RDMA buffer");
+    }
+
+    if (this->cnfg.credit_batch == 0) {
+        this->cnfg.credit_batch = cnfg.ring_size / 4;
+    }
+
+    base = (char*) qp->local.vaddr;
+    memset(base + cnfg.ctrl_offs, 0, STREAM_CTRL_SIZE);
+
+    DBG1("cRdmaStream: Created " << (role == streamRole::SENDER ? "sender" : "receiver") << " with a ring of " << cnfg.ring_size << " bytes");
+}
+
+cRdmaStream::~cRdmaStream() {
+    // Completions are counted per QP and in order, so the last write covers all the others
+    if (!inflight.empty()) {
+        cthread->wait(inflight.back().ticket);
+    }
+    cthread->wait(ctrl_ticket);
+}
+
+void cRdmaStream::checkRole(streamRole expected, const char *func) const {
+    if (role != expected) {
+        throw std::runtime_error(
+            std::string("ERROR: cRdmaStream::") + func + "() can only be called on the " + (expected == streamRole::SENDER ? "sender" : "receiver")
+        );
+    }
+}
+
+uint64_t cRdmaStream::readCtrl(uint64_t word) const {
+    // Written by the NIC (or the copy engine, for loopback), so it must be re-read from memory on every poll
+    return __atomic_load_n((uint64_t*) (base + cnfg.ctrl_offs + word), __ATOMIC_ACQUIRE);
+}
+
+bool cRdmaStream::writeCtrl(uint64_t word, uint64_t val) {
+    // A stale value must never overwrite a newer one, so only one control write is in flight at a time
+    if (!cthread->isDone(ctrl_ticket)) {
+        return false;
+    }
+
+    *((uint64_t*) (base + cnfg.ctrl_offs + CTRL_STAGING)) = val;
+
+    rdmaSg sg;
+    sg.local_offs = cnfg.ctrl_offs + CTRL_STAGING;
+    sg.remote_offs = cnfg.ctrl_offs + word;
+    sg.len = sizeof(uint64_t);
+    sg.qp_id = qp_id;
+    ctrl_ticket = cthread->invoke(CoyoteOper::REMOTE_RDMA_WRITE, sg);
+    return true;
+}
+
+void cRdmaStream::readCredits() {
+    if (cnfg.credits == streamCredits::RDMA) {
+        credited = readCtrl(CTRL_TAIL);
+        return;
+    }
+
+    // Credits are cumulative, so only the latest one counts
+    while (true) {
+        ssize_t ret = ::recv(cnfg.oob_fd, (char*) &oob_credit + oob_credit_len, sizeof(uint64_t) - oob_credit_len, MSG_DONTWAIT);
+        if (ret > 0) {
+            oob_credit_len += ret;
+            if (oob_credit_len == sizeof(uint64_t)) {
+                credited = oob_credit;
+                oob_credit_len = 0;
+            }
+        } else if (ret == 0) {
+            throw std::runtime_error("ERROR: cRdmaStream - the out-of-band connection was closed by the receiver");
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        } else if (errno != EINTR) {
+            throw std::runtime_error("ERROR: cRdmaStream - failed to receive credits");
+        }
+    }
+}
+
+void cRdmaStream::returnCredits(bool force) {
+    if (tail == credited) {
+        return;
+    }
+
+    if (cnfg.credits == streamCredits::RDMA) {
+        if (writeCtrl(CTRL_TAIL, tail)) {
+            credited = tail;
+        }
+        return;
+    }
+
+    // Out-of-band credits cost a syscall each, so they are batched, unless the receiver is about to wait for the sender
+    if (!force && tail - credited < cnfg.credit_batch) {
+        return;
+    }
+
+    uint64_t sent = 0;
+    while (sent < sizeof(uint64_t)) {
+        ssize_t ret = ::send(cnfg.oob_fd, (const char*) &tail + sent, sizeof(uint64_t) - sent, MSG_NOSIGNAL);
+        if (ret < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("ERROR: cRdmaStream - failed to return credits");
+        }
+        sent += ret;
+    }
+    credited = tail;
+}
+
+bool cRdmaStream::tryAdvance(uint64_t len) {
+    // Messages never wrap, so a message that doesn't fit before the end of the ring is preceded by padding
+    const uint64_t offs = reserved % cnfg.ring_size;
+    const uint64_t pad = offs + len > cnfg.ring_size ? cnfg.ring_size - offs : 0;
+    if (reserved + pad + len - credited > cnfg.ring_size) {
+        return false;
+    }
+
+    if (pad > 0) {
+        streamMsgHdr *hdr = (streamMsgHdr*) (base + cnfg.ring_offs + offs);
+        hdr->len = pad;
+        hdr->flags = MSG_PAD;
+        reserved += pad;
+        committed = reserved;
+    }
+
+    reserved += len;
+    return true;
+}
+
+template<typename Cond>
+bool cRdmaStream::waitFor(Cond cond, std::chrono::nanoseconds timeout) {
+    auto start = std::chrono::steady_clock::now();
+    uint32_t n_polls = 0;
+    while (true) {
+        progress();
+        if (cond()) {
+            return true;
+        }
+
+        if (++n_polls % POLLS_PER_CHECK == 0) {
+            if (std::chrono::steady_clock::now() - start >= timeout) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+}
+
+void* cRdmaStream::tryReserve(uint64_t len) {
+    checkRole(streamRole::SENDER, "tryReserve");
+
+    if (reserved != committed) {
+        throw std::runtime_error("ERROR: cRdmaStream::tryReserve() - the previous message has not been committed");
+    }
+
+    const uint64_t space = msgSpace(sizeof(streamMsgHdr), len);
+    if (space > cnfg.ring_size) {
+        throw std::runtime_error("ERROR: cRdmaStream::tryReserve() - a message of " + std::to_string(len) + " bytes doesn't fit into the ring");
+    }
+
+    if (!tryAdvance(space)) {
+        progress();
+        if (!tryAdvance(space)) {
+            return nullptr;
+        }
+    }
+
+    streamMsgHdr *hdr = (streamMsgHdr*) (base + cnfg.ring_offs + (reserved - space) % cnfg.ring_size);
+    hdr->len = len;
+    hdr->flags = 0;
+    return hdr + 1;
+}
+
+void* cRdmaStream::reserve(uint64_t len, std::chrono::nanoseconds timeout) {
+    void *payload = tryReserve(len);
+    if (payload != nullptr) {
+        return payload;
+    }
+
+    // Back-pressure: the ring is full until the receiver returns credits
+    auto start = std::chrono::steady_clock::now();
+    waitFor([&] { return (payload = tryReserve(len)) != nullptr; }, timeout);
+    stats.n_stalls++;
+    stats.stalled += std::chrono::steady_clock::now() - start;
+    return payload;
+}
+
+void cRdmaStream::commit() {
+    checkRole(streamRole::SENDER, "commit");
+
+    if (reserved == committed) {
+        throw std::runtime_error("ERROR: cRdmaStream::commit() - no message has been reserved");
+    }
+
+    const uint64_t offs = committed % cnfg.ring_size;
+    stats.n_msgs++;
+    stats.n_bytes += ((streamMsgHdr*) (base + cnfg.ring_offs + offs))->len;
+
+    committed = reserved;
+    progress();
+}
+
+bool cRdmaStream::send(const void *data, uint64_t len, std::chrono::nanoseconds timeout) {
+    void *payload = reserve(len, timeout);
+    if (payload == nullptr) {
+        return false;
+    }
+
+    memcpy(payload, data, len);
+    commit();
+    return true;
+}
+
+bool cRdmaStream::flush(std::chrono::nanoseconds timeout) {
+    checkRole(streamRole::SENDER, "flush");
+    return waitFor([&] { return announced == committed; }, timeout);
+}
+
+bool cRdmaStream::poll(const void *&data, uint64_t &len) {
+    checkRole(streamRole::RECEIVER, "poll");
+    progress();
+
+    const uint64_t head = readCtrl(CTRL_HEAD);
+    while (next != head) {
+        const streamMsgHdr *hdr = (const streamMsgHdr*) (base + cnfg.ring_offs + next % cnfg.ring_size);
+
+        // Padding is released together with the message before it, or right away if there is none
+        if (hdr->flags & MSG_PAD) {
+            next += hdr->len;
+            if (unreleased.empty()) {
+                tail = next;
+            } else {
+                unreleased.back() = next;
+            }
+            continue;
+        }
+
+        data = hdr + 1;
+        len = hdr->len;
+        next += msgSpace(sizeof(streamMsgHdr), hdr->len);
+        unreleased.push_back(next);
+
+        stats.n_msgs++;
+        stats.n_bytes += len;
+        return true;
+    }
+
+    // Nothing to read, so the sender may be waiting for credits
+    returnCredits(true);
+    return false;
+}
+
+bool cRdmaStream::recv(const void *&data, uint64_t &len, std::chrono::nanoseconds timeout) {
+    if (poll(data, len)) {
+        return true;
+    }
+    return waitFor([&] { return poll(data, len); }, timeout);
+}
+
+void cRdmaStream::release() {
+    checkRole(streamRole::RECEIVER, "release");
+
+    if (unreleased.empty()) {
+        throw std::runtime_error("ERROR: cRdmaStream::release() - no message to release");
+    }
+
+    tail = unreleased.front();
+    unreleased.pop_front();
+    returnCredits(false);
+}
+
+void cRdmaStream::progress() {
+    if (role == streamRole::RECEIVER) {
+        returnCredits(false);
+        return;
+    }
+
+    // Retire the completed writes, in order, and publish the new end of the stream
+    while (!inflight.empty() && cthread->isDone(inflight.front().ticket)) {
+        completed = inflight.front().end;
+        inflight.pop_front();
+    }
+
+    if (completed != announced && writeCtrl(CTRL_HEAD, completed)) {
+        announced = completed;
+    }
+
+    // Everything committed while the window was full goes out in as few writes as possible
+    while (issued != committed && inflight.size() < cnfg.window) {
+        const uint64_t offs = issued % cnfg.ring_size;
+        const uint64_t len = std::min(committed - issued, cnfg.ring_size - offs);
+
+        rdmaSg sg;
+        sg.local_offs = cnfg.ring_offs + offs;
+        sg.remote_offs = cnfg.ring_offs + offs;
+        sg.len = len;
+        sg.qp_id = qp_id;
+        inflight.push_back({cthread->invoke(CoyoteOper::REMOTE_RDMA_WRITE, sg), issued + len});
+
+        issued += len;
+        stats.n_writes++;
+    }
+
+    readCredits();
+}
+
+streamStats cRdmaStream::getStats() const {
+    return stats;
+}
+
+void cRdmaStream::resetStats() {
+    stats = streamStats();
+}
+
+}
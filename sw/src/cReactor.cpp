@@ -0,0 +1,237 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include <coyote/cReactor.hpp>
+
+namespace coyote {
+
+cReactor& cReactor::getInstance() {
+    static cReactor reactor;
+    return reactor;
+}
+
+cReactor::~cReactor() {
+    DBG1("cReactor: Stopping " << workers.size() << " reactor threads");
+
+    for (auto &worker : workers) {
+        eventfd_write(worker->terminate_efd, 1);
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        close(worker->epoll_fd);
+        close(worker->terminate_efd);
+    }
+}
+
+void cReactor::setThreads(uint32_t n) {
+    std::lock_guard<std::mutex> lock(rlock);
+    if (!workers.empty()) {
+        std::cerr << "WARNING: cReactor::setThreads() called after the reactor was started; ignoring" << std::endl;
+        return;
+    }
+    n_threads = std::max(n, 1u);
+}
+
+void cReactor::start() {
+    DBG1("cReactor: Starting " << n_threads << " reactor threads");
+
+    for (uint32_t i = 0; i < n_threads; i++) {
+        auto worker = std::make_unique<reactorWorker>();
+
+        worker->epoll_fd = epoll_create1(0);
+        if (worker->epoll_fd == -1) {
+            throw std::runtime_error("ERROR: Failed to create epoll file\n");
+        }
+
+        worker->terminate_efd = eventfd(0, 0);
+        if (worker->terminate_efd == -1) {
+            throw std::runtime_error("ERROR: cReactor could not create eventfd");
+        }
+
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = worker->terminate_efd;
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->terminate_efd, &event)) {
+            throw std::runtime_error("ERROR: Failed to add terminate_efd event to epoll");
+        }
+
+        worker->thread = std::thread(&cReactor::run, this, worker.get());
+        workers.emplace_back(std::move(worker));
+    }
+}
+
+void cReactor::registerEvents(int fd, int efd, int32_t ctid, std::function<void(int)> uisr) {
+    DBG1("cReactor: Registering efd " << efd << " for ctid " << ctid);
+
+    std::lock_guard<std::mutex> lock(rlock);
+    if (workers.empty()) {
+        start();
+    }
+
+    // Assign the eventfd to the least loaded thread
+    uint32_t idx = 0;
+    for (uint32_t i = 1; i < workers.size(); i++) {
+        if (workers[i]->n_regs < workers[idx]->n_regs) {
+            idx = i;
+        }
+    }
+
+    regs[efd] = std::unique_ptr<eventReg>(new eventReg{fd, efd, ctid, uisr, idx});
+    workers[idx]->n_regs++;
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = efd;
+    if (epoll_ctl(workers[idx]->epoll_fd, EPOLL_CTL_ADD, efd, &event)) {
+        workers[idx]->n_regs--;
+        regs.erase(efd);
+        throw std::runtime_error("ERROR: Failed to add efd event to epoll");
+    }
+}
+
+void cReactor::unregisterEvents(int efd) {
+    DBG1("cReactor: Unregistering efd " << efd);
+
+    std::unique_ptr<eventReg> reg;
+    reactorWorker *worker;
+    {
+        std::unique_lock<std::mutex> lock(rlock);
+        auto it = regs.find(efd);
+        if (it == regs.end()) {
+            return;
+        }
+        reg = std::move(it->second);
+        regs.erase(it);
+
+        reg->removed = true;
+
+        worker = workers[reg->worker].get();
+        worker->n_regs--;
+
+        // No new notifications are dispatched for efd past this point; only an in-flight dispatch of it can remain
+        epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, efd, NULL);
+
+        if (reg->in_flight && reg->dispatcher == std::this_thread::get_id()) {
+            // Called from within the callback; the registration is still in use by the dispatch loop, which releases it
+            reg->orphaned = true;
+            reg.release();
+        } else {
+            rcond.wait(lock, [&reg]() { return reg->in_flight == 0; });
+        }
+    }
+}
+
+void cReactor::run(reactorWorker *worker) {
+    DBG1("cReactor: Reactor thread started");
+
+    struct epoll_event events[MAX_EVENTS];
+    bool running = true;
+    
+    while (running) {
+        int event_count = epoll_wait(worker->epoll_fd, events, MAX_EVENTS, -1);
+        if (event_count < 0) {
+            if (errno != EINTR) {
+                std::cerr << "ERROR: cReactor - epoll_wait failed" << std::endl;
+            }
+            continue;
+        }
+
+        for (int i = 0; i < event_count; i++) {
+            // Termination event, stop the thread after this batch
+            if (events[i].data.fd == worker->terminate_efd) {
+                DBG1("cReactor: Caught a termination event"); 
+                running = false;
+                continue;
+            }
+
+            // The eventfd may have been unregistered after epoll_wait returned; otherwise, mark it in flight, so that it isn't released
+            eventReg *reg;
+            {
+                std::lock_guard<std::mutex> lock(rlock);
+                auto it = regs.find(events[i].data.fd);
+                if (it == regs.end()) {
+                    continue;
+                }
+                reg = it->second.get();
+                reg->in_flight++;
+                reg->dispatcher = std::this_thread::get_id();
+            }
+
+            // No locks are held from here on, so the callback may register and unregister eventfds, including its own
+            dispatch(reg);
+
+            std::unique_ptr<eventReg> orphan;
+            {
+                std::lock_guard<std::mutex> lock(rlock);
+                reg->in_flight--;
+                if (reg->orphaned) {
+                    orphan.reset(reg);
+                }
+            }
+            rcond.notify_all();
+        }
+    }
+}
+
+void cReactor::dispatch(eventReg *reg) {
+    // Read the event; the eventfd is non-blocking, so stale events (e.g., a reused fd) are skipped
+    eventfd_t val;
+    if (eventfd_read(reg->efd, &val) != 0) {
+        return;
+    }
+
+    // Get the interrupt value via IOCTL; see the comments in driver/fpga_isr.c, function 'vfpga_notify_handler'
+    uint64_t tmp[MAX_USER_ARGS];
+    tmp[0] = reg->ctid;
+    if (ioctl(reg->fd, IOCTL_GET_NOTIFICATION_VALUE, &tmp)) {
+        std::cerr << "ERROR: IOCTL_GET_NOTIFICATION_VALUE failed" << std::endl;
+        return;
+    }
+    uint32_t isr_val = tmp[0];
+    DBG1("cReactor: Caught an event for ctid " << reg->ctid << " which is " << isr_val);
+
+    // The callback may unregister itself (e.g., by destroying its cThread), in which case reg stays valid until the dispatch completes
+    reg->uisr(isr_val);
+
+    // If the registration was removed in the meantime, its cThread acknowledges the notification itself
+    {
+        std::lock_guard<std::mutex> lock(rlock);
+        if (reg->removed) {
+            return;
+        }
+    }
+
+    tmp[0] = reg->ctid;
+    if (ioctl(reg->fd, IOCTL_SET_NOTIFICATION_PROCESSED, &tmp)) {
+        std::cerr << "ERROR: IOCTL_SET_NOTIFICATION_PROCESSED failed" << std::endl;
+    }
+}
+
+}
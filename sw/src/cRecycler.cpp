@@ -0,0 +1,129 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iterator>
+
+#include <coyote/cRecycler.hpp>
+
+namespace coyote {
+
+cRecycler::cRecycler(uint64_t budget, std::chrono::nanoseconds idle_timeout, releaseFn release_fn) :
+    release_fn(release_fn), budget(budget), idle_timeout(idle_timeout) {
+    DBG1("cRecycler: Creating buffer recycler with budget " << budget);
+    stats.budget = budget;
+}
+
+cRecycler::~cRecycler() {
+    DBG1("cRecycler: Releasing " << buffs.size() << " recycled buffers");
+
+    uint64_t n_released = 0;
+    releaseOldest([](const recycledBuff&) { return true; }, n_released);
+}
+
+cRecycler::recycleKey cRecycler::makeKey(const CoyoteAlloc &alloc) {
+    return std::make_tuple(alloc.alloc, alloc.size, alloc.mem_block, alloc.numa, alloc.numa_node);
+}
+
+void cRecycler::releaseOldest(const std::function<bool(const recycledBuff&)> &cond, uint64_t &counter) {
+    std::vector<std::pair<void*, CoyoteAlloc>> released;
+
+    while (!buffs.empty() && cond(buffs.front())) {
+        recycledBuff &buff = buffs.front();
+
+        // The least recently freed buffer overall is also the least recently freed one in its bucket
+        auto bucket = buckets.find(makeKey(buff.alloc));
+        bucket->second.pop_front();
+        if (bucket->second.empty()) {
+            buckets.erase(bucket);
+        }
+
+        stats.cached_bytes -= buff.alloc.size;
+        stats.n_buffers--;
+        counter++;
+
+        released.emplace_back(buff.vaddr, buff.alloc);
+        buffs.pop_front();
+    }
+
+    if (!released.empty()) {
+        DBG1("cRecycler: Releasing " << released.size() << " recycled buffers");
+        release_fn(released);
+    }
+}
+
+bool cRecycler::put(void *vaddr, const CoyoteAlloc &alloc) {
+    if (alloc.size > budget) {
+        return false;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    buffs.push_back({ vaddr, alloc, now });
+    buckets[makeKey(alloc)].push_back(std::prev(buffs.end()));
+
+    stats.n_recycled++;
+    stats.n_buffers++;
+    stats.cached_bytes += alloc.size;
+
+    // Expired buffers first, then as many of the oldest ones as needed to stay within the budget
+    releaseOldest([&](const recycledBuff &buff) { return now - buff.freed > idle_timeout; }, stats.n_expired);
+    releaseOldest([&](const recycledBuff&) { return stats.cached_bytes > budget; }, stats.n_evictions);
+
+    return true;
+}
+
+void* cRecycler::get(const CoyoteAlloc &alloc) {
+    auto bucket = buckets.find(makeKey(alloc));
+    if (bucket == buckets.end()) {
+        stats.n_misses++;
+        return nullptr;
+    }
+
+    auto it = bucket->second.back();
+    void *vaddr = it->vaddr;
+
+    bucket->second.pop_back();
+    if (bucket->second.empty()) {
+        buckets.erase(bucket);
+    }
+
+    stats.cached_bytes -= it->alloc.size;
+    stats.n_buffers--;
+    stats.n_hits++;
+    buffs.erase(it);
+
+    return vaddr;
+}
+
+void cRecycler::trim() {
+    auto now = std::chrono::steady_clock::now();
+    releaseOldest([&](const recycledBuff &buff) { return now - buff.freed > idle_timeout; }, stats.n_expired);
+}
+
+recycleStats cRecycler::getStats() const {
+    return stats;
+}
+
+}
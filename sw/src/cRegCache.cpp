@@ -0,0 +1,220 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <coyote/cRegCache.hpp>
+
+namespace coyote {
+
+cRegCache::cRegCache(
+    uint64_t budget, std::function<void(void*, uint64_t)> map_fn, std::function<void(void*)> unmap_fn,
+    std::function<bool(const cmdTicket&)> done_fn
+) : map_fn(map_fn), unmap_fn(unmap_fn), done_fn(done_fn), budget(budget) {
+    DBG1("cRegCache: Creating registration cache with budget " << budget);
+    stats.budget = budget;
+}
+
+cRegCache::~cRegCache() {
+    DBG1("cRegCache: Releasing registration cache");
+
+    // Operations still in flight may access the buffers, so wait for them before releasing the registrations
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.pinned) {
+            it++;
+            continue;
+        }
+
+        it->second.pending = false;
+        while (inUse(it->second)) {
+            std::this_thread::yield();
+        }
+        it = evict(it);
+    }
+}
+
+std::map<uint64_t, cRegCache::regEntry>::iterator cRegCache::evict(std::map<uint64_t, regEntry>::iterator it) {
+    DBG1("cRegCache: Releasing cached registration at " << std::hex << it->first << std::dec);
+
+    unmap_fn(reinterpret_cast<void*>(it->first));
+    stats.cached_bytes -= it->second.end - it->first;
+    lru.erase(it->second.lru);
+    return entries.erase(it);
+}
+
+bool cRegCache::inUse(regEntry &entry) {
+    entry.tickets.erase(
+        std::remove_if(entry.tickets.begin(), entry.tickets.end(), [this](const cmdTicket &ticket) { return done_fn(ticket); }),
+        entry.tickets.end()
+    );
+    return entry.pending || !entry.tickets.empty();
+}
+
+bool cRegCache::ensure(const void *vaddr, uint64_t len) {
+    if (len == 0) {
+        return true;
+    }
+
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr) & ~(PAGE_SIZE - 1);
+    uint64_t end = (reinterpret_cast<uint64_t>(vaddr) + len + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+
+    // Walk over the registered ranges covering the buffer, recording any gaps in between
+    std::vector<std::pair<uint64_t, uint64_t>> gaps;
+    uint64_t pos = start;
+
+    auto it = entries.upper_bound(pos);
+    if (it != entries.begin() && std::prev(it)->second.end > pos) {
+        it--;
+    }
+
+    while (pos < end) {
+        if (it != entries.end() && it->first <= pos) {
+            if (!it->second.pinned) {
+                lru.splice(lru.begin(), lru, it->second.lru);
+                if (!it->second.pending) {
+                    it->second.pending = true;
+                    pending.push_back(it->first);
+                }
+            }
+            pos = it->second.end;
+            it++;
+        } else {
+            uint64_t gap_end = (it != entries.end()) ? std::min(end, it->first) : end;
+            gaps.emplace_back(pos, gap_end);
+            pos = gap_end;
+        }
+    }
+
+    if (gaps.empty()) {
+        stats.n_hits++;
+        return true;
+    }
+
+    stats.n_misses++;
+    for (auto &gap : gaps) {
+        DBG1("cRegCache: Registering range " << std::hex << gap.first << " - " << gap.second << std::dec);
+        map_fn(reinterpret_cast<void*>(gap.first), gap.second - gap.first);
+
+        lru.push_front(gap.first);
+        entries[gap.first] = {gap.second, false, lru.begin(), true, {}};
+        pending.push_back(gap.first);
+        stats.cached_bytes += gap.second - gap.first;
+    }
+
+    // Evict least-recently-used entries, skipping the ones used by pending or outstanding operations
+    auto next = lru.end();
+    while (stats.cached_bytes > budget && next != lru.begin()) {
+        auto it = entries.find(*std::prev(next));
+        if (inUse(it->second)) {
+            next--;
+        } else {
+            evict(it);
+            stats.n_evictions++;
+        }
+    }
+
+    return false;
+}
+
+void cRegCache::hold(cmdTicket ticket) {
+    for (uint64_t start : pending) {
+        // Entries may have been invalidated in the meantime
+        auto it = entries.find(start);
+        if (it == entries.end() || it->second.pinned || !it->second.pending) {
+            continue;
+        }
+        it->second.pending = false;
+
+        // Operations on the same counter complete in order, so the new ticket supersedes an older one
+        if (ticket.oper != CoyoteOper::NOOP && !done_fn(ticket)) {
+            auto &tickets = it->second.tickets;
+            auto same = std::find_if(tickets.begin(), tickets.end(), [&ticket](const cmdTicket &other) {
+                return other.oper == ticket.oper && other.qp_id == ticket.qp_id;
+            });
+            if (same != tickets.end()) {
+                *same = ticket;
+            } else {
+                tickets.push_back(ticket);
+            }
+        }
+    }
+    pending.clear();
+}
+
+void cRegCache::insertPinned(const void *vaddr, uint64_t len) {
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr) & ~(PAGE_SIZE - 1);
+    uint64_t end = (reinterpret_cast<uint64_t>(vaddr) + len + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+
+    // Drop any records overlapping the new mapping; overlapping cached registrations are released
+    auto it = entries.upper_bound(start);
+    if (it != entries.begin() && std::prev(it)->second.end > start) {
+        it--;
+    }
+    while (it != entries.end() && it->first < end) {
+        it = it->second.pinned ? entries.erase(it) : evict(it);
+    }
+
+    entries[start] = {end, true, lru.end(), false, {}};
+}
+
+void cRegCache::removePinned(const void *vaddr) {
+    auto it = entries.find(reinterpret_cast<uint64_t>(vaddr) & ~(PAGE_SIZE - 1));
+    if (it != entries.end() && it->second.pinned) {
+        entries.erase(it);
+    }
+}
+
+void cRegCache::invalidate(const void *vaddr, uint64_t len) {
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr) & ~(PAGE_SIZE - 1);
+    uint64_t end = (reinterpret_cast<uint64_t>(vaddr) + len + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+
+    auto it = entries.upper_bound(start);
+    if (it != entries.begin() && std::prev(it)->second.end > start) {
+        it--;
+    }
+    while (it != entries.end() && it->first < end) {
+        it = it->second.pinned ? std::next(it) : evict(it);
+    }
+}
+
+void cRegCache::releaseAll() {
+    DBG1("cRegCache: Releasing all completion tickets");
+
+    for (auto &it : entries) {
+        it.second.tickets.clear();
+    }
+}
+
+regCacheStats cRegCache::getStats() const {
+    regCacheStats ret = stats;
+    ret.n_entries = entries.size();
+    return ret;
+}
+
+}
@@ -25,13 +25,16 @@
  */
 
 #include <coyote/cThread.hpp>
+#include <coyote/cReactor.hpp>
 
 #include <chrono>
 #include <string>
+#include <algorithm>
 #include <random>
 #include <fstream>
 #include <iostream>
 
+#include <poll.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <syslog.h>
@@ -41,96 +44,51 @@
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <linux/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
 
-namespace coyote {
-
-/// Event handler function which processes user interrupts in a dedicated thread
-int eventHandler(int fd, int efd, int terminate_efd, std::function<void(int)> uisr, int32_t ctid) {
-    DBG1("cThread: Called eventHandler"); 
-
-    // Create events to listen on
-	struct epoll_event event, events[MAX_EVENTS]; 
-	int epoll_fd = epoll_create1(0); 
-	if (epoll_fd == -1) {
-		throw std::runtime_error("ERROR: Failed to create epoll file\n");
-	}
-
-    // Configure the event for user interrupts
-	event.events = EPOLLIN; 
-	event.data.fd = efd;
-	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, efd, &event)) {
-		throw std::runtime_error("ERROR: Failed to add efd event to epoll");
-	}
-
-    // Configure the event for termination
-	event.events = EPOLLIN;
-	event.data.fd = terminate_efd;
-	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, terminate_efd, &event)) {
-		throw std::runtime_error("ERROR: Failed to add terminate_efd event to epoll");
-	}
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
-    bool running = true;
-	while (running) {
-		int event_count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
-
-		for (int i = 0; i < event_count; i++) {
-			// User interrupt, read the eventfd value and call the uisr function
-            if (events[i].data.fd == efd) {
-                // Read the event, which should return 0 on success
-                eventfd_t val;
-				if (eventfd_read(efd, &val) != 0) {
-                    throw std::runtime_error("ERROR: Failed to read interrupt");
-                }
-
-                /* 
-                 * Get the interrupt value via IOCTL.
-                 * NOTE: Older versions of Coyote used to get the interrupt value directly from
-                 * the eventfd. However, recent changes in the API of the kernel made this
-                 * implementation infeasible from the coyote driver perspective.
-                 * Read the comments in driver/fpga_isr.c, function 'vfpga_notify_handler' for further details.
-                 */
-                uint64_t tmp[MAX_USER_ARGS];
-                tmp[0] = ctid;
-                if (ioctl(fd, IOCTL_GET_NOTIFICATION_VALUE, &tmp)) {
-                    throw std::runtime_error("ERROR: IOCTL_GET_NOTIFICATION_VALUE failed");
-                }
-                uint32_t isr_val = tmp[0];
-                DBG1("cThread: Caught an event which is " << isr_val);
-
-				uisr(isr_val);
-
-                tmp[0] = ctid;
-                if (ioctl(fd, IOCTL_SET_NOTIFICATION_PROCESSED, &tmp)) {
-                    throw std::runtime_error("ERROR: IOCTL_SET_NOTIFICATION_PROCESSED failed");
-                }
-			}
+namespace coyote {
 
-            // If event is a terminate_efd, terminate the event thread 
-			else if (events[i].data.fd == terminate_efd) {
-                DBG1("cThread: eventHandler caught a termination event"); 
-				running = false;
-			}
-		}
-	}
+static unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
 
-	close(epoll_fd);
-	return 0;
-}
+/// Shell configuration of a device, as read by the first cThread on it
+struct shellCnfgEntry {
+    uint64_t cnfg;
+    uint64_t ctrl;
+    int32_t numa_node;
+    uint32_t ip_addr;
+};
 
-static unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
+/// Shell configurations, keyed by the device number; see cThread::invalidateShellCnfg()
+static std::mutex shell_cnfg_lock;
+static std::unordered_map<uint32_t, shellCnfgEntry> shell_cnfg_cache;
 
 cThread::cThread(int32_t vfid, pid_t hpid, uint32_t device, std::function<void(int)> uisr):
   hpid(hpid), vfid(vfid),
-  vlock(boost::interprocess::open_or_create, ("mutex_dev_" + std::to_string(device) + "_vfpa_" + std::to_string(vfid)).c_str()),
+  vlock_name("mutex_dev_" + std::to_string(device) + "_vfpa_" + std::to_string(vfid)),
   additional_state(nullptr) {
 	DBG1("cThread: opening vFPGA " << vfid << ", hpid " << hpid);
 
+    // Records the time spent in each step of the constructor
+    auto t_start = std::chrono::steady_clock::now();
+    auto t_step = t_start;
+    auto lap = [&t_step](std::chrono::nanoseconds &step) {
+        auto now = std::chrono::steady_clock::now();
+        step = now - t_step;
+        t_step = now;
+    };
+
 	// Open char device with the name specified in the driver
 	std::string region = "/dev/coyote_fpga_" + std::to_string(device) + "_v" + std::to_string(vfid);
     this->fd = open(region.c_str(), O_RDWR | O_SYNC); 
 	if (fd == -1) { 
         throw std::runtime_error("ERROR: cThread instance could not be obtained, vfid: " + std::to_string(vfid)); 
     }
+    lap(startup_stats.open);
 
     // Obtain new Coyote thread ID (ctid) and register it with the driver
 	uint64_t tmp[MAX_USER_ARGS];
@@ -140,38 +98,71 @@ cThread::cThread(int32_t vfid, pid_t hpid, uint32_t device, std::function<void(i
     }
     this->ctid = tmp[1];  
 	DBG1("cThread: registered ctid " << ctid);
+    lap(startup_stats.register_ctid);
 	
-    // Read shell configuration from the driver
-	if (ioctl(fd, IOCTL_READ_SHELL_CONFIG, &tmp)) { 
-        throw std::runtime_error("ERROR: IOCTL_READ_SHELL_CONFIG failed"); 
+    // Read shell configuration from the driver, unless another cThread on the same device already did
+    shellCnfgEntry shell_cnfg;
+    {
+        std::lock_guard<std::mutex> guard(shell_cnfg_lock);
+        auto it = shell_cnfg_cache.find(device);
+        if (it != shell_cnfg_cache.end()) {
+            shell_cnfg = it->second;
+            startup_stats.cnfg_cached = true;
+        } else {
+            if (ioctl(fd, IOCTL_READ_SHELL_CONFIG, &tmp)) { 
+                throw std::runtime_error("ERROR: IOCTL_READ_SHELL_CONFIG failed"); 
+            }
+            shell_cnfg.cnfg = tmp[0];
+            shell_cnfg.ctrl = tmp[1];
+
+            // Read the NUMA node of the FPGA, as exposed by the driver; older drivers don't expose it, leaving it unknown
+            std::ifstream numa_file("/sys/kernel/coyote_sysfs_" + std::to_string(device) + "/cyt_attr_numa");
+            if (!(numa_file >> shell_cnfg.numa_node)) {
+                shell_cnfg.numa_node = -1;
+            }
+
+            // The IP address is only needed with RDMA
+            fcnfg.parseCnfg(shell_cnfg.cnfg);
+            shell_cnfg.ip_addr = 0;
+            if (fcnfg.en_rdma) {
+                if (ioctl(fd, IOCTL_GET_IP_ADDRESS, &tmp)) {
+                    throw std::runtime_error("ERROR: IOCTL_GET_IP_ADDRESS failed");
+                }
+                shell_cnfg.ip_addr = (uint32_t) tmp[0];
+            }
+
+            shell_cnfg_cache[device] = shell_cnfg;
+        }
     }
-    fcnfg.parseCnfg(tmp[0]);
-    fcnfg.parseCtrlReg(tmp[1]);
+    fcnfg.parseCnfg(shell_cnfg.cnfg);
+    fcnfg.parseCtrlReg(shell_cnfg.ctrl);
+    numa_node = shell_cnfg.numa_node;
+    DBG1("cThread: FPGA is attached to NUMA node " << numa_node);
+    lap(startup_stats.shell_cnfg);
 
-    // Register user interrupt service routine (uisr) and start the interrupt processing thread
+    // Register user interrupt service routine (uisr) with the process-wide interrupt reactor
     if (uisr) {
-        DBG1("cThread: user interrupt service routine provided, trying to create efd and terminate_efd"); 
+        DBG1("cThread: user interrupt service routine provided, trying to create efd"); 
         
-		efd = eventfd(0, 0);
+		efd = eventfd(0, EFD_NONBLOCK);
 		if (efd == -1) { 
             throw std::runtime_error("ERROR: cThread could not create eventfd"); 
         }
 
-		terminate_efd = eventfd(0, 0);
-		if (terminate_efd == -1) { 
-            throw std::runtime_error("ERROR: cThread could not create eventfd"); 
-        }
-
-        event_thread = std::thread(eventHandler, fd, efd, terminate_efd, uisr, ctid);
-
         tmp[0] = ctid; 
 		tmp[1] = efd;
 		if (ioctl(fd, IOCTL_REGISTER_EVENTFD, &tmp)) {
+            close(efd);
+            efd = -1;
 			throw std::runtime_error("ERROR: IOCTL_REGISTER_EVENTFD failed");
         }
 
-        DBG1("cThread: user interrupt service routine registered, thread running..."); 
+        // Only registered with the reactor once the driver accepted the eventfd, so a failure leaves no dangling registration
+        cReactor::getInstance().registerEvents(fd, efd, ctid, uisr);
+
+        DBG1("cThread: user interrupt service routine registered with the interrupt reactor"); 
     }
+    lap(startup_stats.interrupts);
 
     // Set the local QP, if RDMA is enabled
     qpair = std::make_unique<ibvQp>();
@@ -179,11 +170,7 @@ cThread::cThread(int32_t vfid, pid_t hpid, uint32_t device, std::function<void(i
         std::default_random_engine rand_gen(seed);
         std::uniform_int_distribution<int> distr(0, std::numeric_limits<std::uint32_t>::max());
 
-        if (ioctl(fd, IOCTL_GET_IP_ADDRESS, &tmp)) {
-			throw std::runtime_error("ERROR: IOCTL_GET_IP_ADDRESS failed");
-        }
-
-        uint32_t ibv_ip_addr = (uint32_t) tmp[0];
+        uint32_t ibv_ip_addr = shell_cnfg.ip_addr;
         qpair->local.ip_addr = ibv_ip_addr;
         qpair->local.uintToGid(0, ibv_ip_addr);
         qpair->local.uintToGid(8, ibv_ip_addr);
@@ -204,16 +191,39 @@ cThread::cThread(int32_t vfid, pid_t hpid, uint32_t device, std::function<void(i
 	mmapFpga();
 
 	clearCompleted();
+    lap(startup_stats.mmap);
+    startup_stats.total = std::chrono::steady_clock::now() - t_start;
 
     DBG1("cThread: constructor finished");
 }
 
+cThread::cThread(const fpgaCnfg &cnfg, int32_t ctid):
+  fd(-1), ctid(ctid), hpid(getpid()), fcnfg(cnfg), is_connected(false),
+  vlock_name("mutex_cthread_" + std::to_string(getpid()) + "_" + std::to_string(ctid)),
+  additional_state(nullptr) {
+    DBG1("cThread: creating a cThread without a vFPGA, ctid " << ctid);
+
+    if (ctid < 0 || ctid >= N_CTID_MAX) {
+        throw std::runtime_error("ERROR: cThread - invalid ctid " + std::to_string(ctid));
+    }
+
+    // All cThreads without a vFPGA are on the same (loopback) node, so RDMA operations between them go through the copy engine
+    qpair = std::make_unique<ibvQp>();
+    if (fcnfg.en_rdma) {
+        qpair->local.ip_addr = INADDR_LOOPBACK;
+        qpair->local.qpn = ctid & PID_MASK;
+    }
+
+    mmapFpga();
+    clearCompleted();
+}
+
 cThread::~cThread() {
 	DBG1("cThread: destructor, ctid: " << ctid << ", vfid: " << vfid << ", hpid: " << hpid);
 
     // Release the lock, if acquired
     if (lock_acquired) {
-        vlock.unlock();
+        vlock->unlock();
         lock_acquired = false;
     }
 
@@ -221,25 +231,62 @@ cThread::~cThread() {
 	uint64_t tmp[MAX_USER_ARGS];
     tmp[0] = ctid;
 
+    // Release the additional QPs, waiting for any loopback copies on them
+    while (!qp_table.empty()) {
+        destroyQp(qp_table.begin()->first);
+    }
+
+    // Wait for loopback copies, which may still access the buffers
+    for (uint32_t i = 0; i < N_WBACKS; i++) {
+        loopback_cmpl[i].drain();
+    }
+
+    // Complete any asynchronous mapping, so that no ioctl is in-flight and its buffers are released below
+    for (auto &pending : pending_maps) {
+        pending.second.codes.wait();
+    }
+    pending_maps.clear();
+
+    // Release recycled buffers and cached registrations before the explicitly mapped buffers
+    recycler.reset();
+    reg_cache.reset();
+
+    // Host allocations are unmapped in batches; the remaining (GPU) ones one by one
+    std::vector<void*> host_vaddrs;
+    for (auto &mapped : mapped_pages) {
+        if (mapped.second.alloc != CoyoteAllocType::GPU && !mapped.second.remote) {
+            host_vaddrs.push_back(mapped.first);
+        }
+    }
+    try {
+        userUnmapBatch(host_vaddrs);
+    } catch (const std::exception &e) {
+        std::cerr << "ERROR: cThread::~cThread() - " << e.what() << std::endl;
+    }
+    for (void *vaddr : host_vaddrs) {
+        releaseHostAlloc(vaddr, mapped_pages[vaddr]);
+        mapped_pages.erase(vaddr);
+    }
+
 	while (!mapped_pages.empty()) {
 		freeMem(mapped_pages.begin()->first);
 	}
 	munmapFpga();
 
-    // Unregister Coyote thread ID
-	ioctl(fd, IOCTL_UNREGISTER_CTID, &tmp);
+    disableNotifyRing();
+
+    // Unregister Coyote thread ID; cThreads without a vFPGA (see the protected constructor) have no device to release
+    if (fd != -1) {
+	    ioctl(fd, IOCTL_UNREGISTER_CTID, &tmp);
+    }
 
-    // Terminate user interrupt thread and release the variables
+    // Remove the eventfd from the interrupt reactor, which waits for any in-flight callback, and release the variables
     if (efd != -1) {
 		ioctl(fd, IOCTL_UNREGISTER_EVENTFD, &tmp);
 
-		eventfd_write(terminate_efd, 1);
-        if (event_thread.joinable()) {
-		    event_thread.join();
-        }
+        cReactor::getInstance().unregisterEvents(efd);
 
 		close(efd);
-		close(terminate_efd);
 
         ioctl(fd, IOCTL_SET_NOTIFICATION_PROCESSED, &tmp);
 	}
@@ -249,7 +296,9 @@ cThread::~cThread() {
         closeConn();
     }
 
-	close(fd);
+    if (fd != -1) {
+	    close(fd);
+    }
 }
 
 void cThread::postCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_t offs_0) {
@@ -259,20 +308,55 @@ void cThread::postCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_
     );
 
     // Check outstanding commands; to avoid oversaturating the command FIFO
-    while (cmd_cnt > (CMD_FIFO_DEPTH - CMD_FIFO_THR)) {
+    waitCmdCredits(1);
+
+    // Send the commands
+    writeCmd(offs_3, offs_2, offs_1, offs_0);
+
+    // Increment
+    cmd_cnt++;
+}
+
+void cThread::postCmds(const std::vector<std::array<uint64_t, 4>> &cmds) {
+    DBG1("cThread: Called postCmds with " << cmds.size() << " commands");
+
+    size_t i = 0;
+    while (i < cmds.size()) {
+        // Reserve as many credits as currently available, and write the commands back-to-back
+        uint32_t burst = waitCmdCredits(static_cast<uint32_t>(std::min<size_t>(cmds.size() - i, CMD_FIFO_DEPTH)));
+        for (uint32_t j = 0; j < burst; j++, i++) {
+            writeCmd(cmds[i][0], cmds[i][1], cmds[i][2], cmds[i][3]);
+        }
+        cmd_cnt += burst;
+    }
+}
+
+uint32_t cThread::waitCmdCredits(uint32_t n) {
+    // Commands can be posted as long as there are at most (CMD_FIFO_DEPTH - CMD_FIFO_THR) outstanding ones
+    const uint32_t max_cnt = CMD_FIFO_DEPTH - CMD_FIFO_THR + 1;
+
+    auto readCmdCnt = [&]() {
         #ifdef EN_AVX
         cmd_cnt = fcnfg.en_avx ? LOW_32(_mm256_extract_epi32(cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::CTRL_REG)], 0x0)) :
                                 cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG)];
         #else
         cmd_cnt = cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG)];
         #endif
+    };
 
-        if (cmd_cnt > (CMD_FIFO_DEPTH - CMD_FIFO_THR)) {
+    // Only go to the hardware if the locally tracked count doesn't leave room for all the commands
+    if (cmd_cnt + n > max_cnt) {
+        readCmdCnt();
+        while (cmd_cnt >= max_cnt) {
             std::this_thread::sleep_for(std::chrono::nanoseconds(SLEEP_TIME));
+            readCmdCnt();
         }
     }
 
-    // Send the commands
+    return std::min(n, max_cnt - cmd_cnt);
+}
+
+void cThread::writeCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_t offs_0) {
     #ifdef EN_AVX
     if (fcnfg.en_avx) {
         cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::CTRL_REG)] = _mm256_set_epi64x(offs_3, offs_2, offs_1, offs_0);
@@ -285,9 +369,24 @@ void cThread::postCmd(uint64_t offs_3, uint64_t offs_2, uint64_t offs_1, uint64_
     #ifdef EN_AVX
     }
     #endif
+}
 
-    // Increment
-    cmd_cnt++;
+/// Utility function, maps a region of the vFPGA; without a vFPGA (fd is -1), anonymous memory stands in for the registers
+static void* mmapRegion(int32_t fd, size_t size, off_t offs) {
+    if (fd == -1) {
+        return mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    }
+    return mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offs);
+}
+
+void cThread::mmapCtrl() const {
+	void *mem = mmapRegion(fd, CTRL_REGION_SIZE, MMAP_CTRL);
+	if (mem == MAP_FAILED) {
+		throw std::runtime_error("ERROR: ctrl_reg mmap failed");
+    }
+	ctrl_reg = (uint64_t*) mem;
+	
+	DBG1("cThread: mapped ctrl_reg at: " << std::hex << reinterpret_cast<uint64_t>(ctrl_reg) << std::dec);
 }
 
 void cThread::mmapFpga() {
@@ -296,7 +395,7 @@ void cThread::mmapFpga() {
 	// Config 
     #ifdef EN_AVX
 	if (fcnfg.en_avx) {
-		cnfg_reg_avx = (__m256i*) mmap(NULL, CNFG_AVX_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, MMAP_CNFG_AVX);
+		cnfg_reg_avx = (__m256i*) mmapRegion(fd, CNFG_AVX_REGION_SIZE, MMAP_CNFG_AVX);
 		if (cnfg_reg_avx == MAP_FAILED) {
 		 	throw std::runtime_error("ERROR: cnfg_reg_avx mmap failed");
         }
@@ -304,7 +403,7 @@ void cThread::mmapFpga() {
 		DBG1("cThread: mapped cnfg_reg_avx at: " << std::hex << reinterpret_cast<uint64_t>(cnfg_reg_avx) << std::dec);
 	} else {
     #endif
-		cnfg_reg = (uint64_t*) mmap(NULL, CNFG_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, MMAP_CNFG);
+		cnfg_reg = (uint64_t*) mmapRegion(fd, CNFG_REGION_SIZE, MMAP_CNFG);
 		if (cnfg_reg == MAP_FAILED) {
 			throw std::runtime_error("ERROR: cnfg_reg mmap failed");
         }
@@ -314,17 +413,11 @@ void cThread::mmapFpga() {
 	}
     #endif
 
-	// Control - map the user CSRs into memory 
-	ctrl_reg = (uint64_t*) mmap(NULL, CTRL_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, MMAP_CTRL);
-	if (ctrl_reg == MAP_FAILED) {
-		throw std::runtime_error("ERROR: ctrl_reg mmap failed");
-    }
-	
-	DBG1("cThread: mapped ctrl_reg at: " << std::hex << reinterpret_cast<uint64_t>(ctrl_reg) << std::dec);
+	// Control - the user CSRs are only mapped on first use, see mmapCtrl()
 
 	// Writeback
 	if (fcnfg.en_wb) {
-		wback = (uint32_t*) mmap(NULL, WBACK_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, MMAP_WB);
+		wback = (uint32_t*) mmapRegion(fd, WBACK_REGION_SIZE, MMAP_WB);
 		if (wback == MAP_FAILED) {
 			throw std::runtime_error("ERROR: wback mmap failed");
         }
@@ -351,8 +444,8 @@ void cThread::munmapFpga() {
 	}
     #endif
 
-	// User CSRs
-	if (munmap((void*)ctrl_reg, CTRL_REGION_SIZE) != 0) {
+	// User CSRs, if they were ever used
+	if (ctrl_reg && munmap((void*)ctrl_reg, CTRL_REGION_SIZE) != 0) {
 		throw std::runtime_error("ERROR: ctrl_reg munmap failed");
     }
 
@@ -374,8 +467,6 @@ void cThread::munmapFpga() {
 void cThread::userMap(void *vaddr, uint64_t len, int32_t mem_block) {
     DBG1("cThread: Called userMap to map user buffer, vaddr " << vaddr << ", length " << len << ", memory block " << mem_block << " and ctid " << ctid);
 
-    uint64_t tmp[MAX_USER_ARGS];
-
     #if defined(EN_ROCM)
     {
         // Detect ROCm device memory via HIP pointer attribute query
@@ -389,6 +480,7 @@ void cThread::userMap(void *vaddr, uint64_t len, int32_t mem_block) {
                 throw std::runtime_error("ERROR: userMap - ROCm DMA Buff export failed");
             }
 
+            uint64_t tmp[MAX_USER_ARGS];
             tmp[0] = static_cast<uint64_t>(dmabuf_fd);
             tmp[1] = reinterpret_cast<uint64_t>(vaddr) - offset;
             tmp[2] = static_cast<uint64_t>(ctid);
@@ -399,6 +491,7 @@ void cThread::userMap(void *vaddr, uint64_t len, int32_t mem_block) {
             }
 
             gpu_dmabuf_fds[vaddr] = dmabuf_fd;
+            trackMapping(vaddr, len);
             return;
         }
     }
@@ -422,6 +515,7 @@ void cThread::userMap(void *vaddr, uint64_t len, int32_t mem_block) {
                 throw std::runtime_error("ERROR: userMap - cuMemGetHandleForAddressRange failed");
             }
 
+            uint64_t tmp[MAX_USER_ARGS];
             tmp[0] = static_cast<uint64_t>(dmabuf_fd);
             tmp[1] = reinterpret_cast<uint64_t>(vaddr);
             tmp[2] = static_cast<uint64_t>(ctid);
@@ -432,12 +526,93 @@ void cThread::userMap(void *vaddr, uint64_t len, int32_t mem_block) {
             }
 
             gpu_dmabuf_fds[vaddr] = dmabuf_fd;
+            trackMapping(vaddr, len);
             return;
         }
     }
     #endif
 
-    // Non-GPU path: host memory
+    // Non-GPU path: host memory; cached registrations overlapping the buffer are released first, so that ranges never overlap
+    if (reg_cache) {
+        reg_cache->invalidate(vaddr, len);
+    }
+
+    mapHostMem(vaddr, len, mem_block);
+    trackMapping(vaddr, len);
+
+    if (reg_cache) {
+        reg_cache->insertPinned(vaddr, len);
+    }
+}
+
+void cThread::trackMapping(void *vaddr, uint64_t len) {
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr);
+    auto it = mapped_ranges.find(start);
+    if (it == mapped_ranges.end() || it->second < start + len) {
+        mapped_ranges[start] = start + len;
+    }
+}
+
+void cThread::untrackMapping(void *vaddr) {
+    mapped_ranges.erase(reinterpret_cast<uint64_t>(vaddr));
+    last_mapped_start = last_mapped_end = 0;
+}
+
+bool cThread::isMapped(const void *vaddr, uint64_t len) const {
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr);
+    uint64_t end = start + len;
+
+    // Fast path: consecutive operations typically target the same buffer
+    if (start >= last_mapped_start && end <= last_mapped_end) {
+        return true;
+    }
+
+    // Find the range with the closest start address before the buffer, then follow adjacent or overlapping ranges until the buffer is covered
+    auto it = mapped_ranges.upper_bound(start);
+    if (it == mapped_ranges.begin()) {
+        return false;
+    }
+    it--;
+
+    uint64_t range_start = it->first;
+    uint64_t covered = start;
+    while (it != mapped_ranges.end() && it->first <= covered) {
+        covered = std::max(covered, it->second);
+        if (covered >= end) {
+            last_mapped_start = range_start;
+            last_mapped_end = covered;
+            return true;
+        }
+        it++;
+    }
+    
+    return false;
+}
+
+void cThread::setValidation(bool en) {
+    DBG1("cThread: Setting invoke validation to " << en);
+    validate_sg = en;
+}
+
+void cThread::setMultiProducer(bool en) {
+    DBG1("cThread: Called setMultiProducer, en: " << en);
+
+    // Wait for any in-flight submission, before switching modes
+    std::lock_guard<std::recursive_mutex> guard(submit_lock);
+    multi_producer = en;
+}
+
+void cThread::checkMapped(const void *vaddr, uint64_t len) const {
+    if (!isMapped(vaddr, len)) {
+        throw std::runtime_error(
+            "ERROR: cThread::invoke() - buffer at vaddr " + std::to_string(reinterpret_cast<uint64_t>(vaddr)) + 
+            " with length " + std::to_string(len) + " is not mapped; use userMap() or getMem(), exiting..."
+        );
+    }
+}
+
+void cThread::mapHostMem(void *vaddr, uint64_t len, int32_t mem_block) {
+    uint64_t tmp[MAX_USER_ARGS];
 	tmp[0] = reinterpret_cast<uint64_t>(vaddr);
 	tmp[1] = static_cast<uint64_t>(len);
 	tmp[2] = static_cast<uint64_t>(ctid);
@@ -453,6 +628,16 @@ void cThread::userMap(void *vaddr, uint64_t len, int32_t mem_block) {
     }
 }
 
+void cThread::unmapHostMem(void *vaddr) {
+	uint64_t tmp[MAX_USER_ARGS];
+	tmp[0] = reinterpret_cast<uint64_t>(vaddr);
+	tmp[1] = static_cast<uint64_t>(ctid);
+
+    if (ioctl(fd, IOCTL_UNMAP_USER_MEM, &tmp)) {
+        throw std::runtime_error("ERROR: IOCTL_UNMAP_USER_MEM failed");
+    }
+}
+
 void cThread::userUnmap(void *vaddr) {
     DBG1("cThread: Called userUnmap to unmap user buffers, vaddr " << vaddr);
 
@@ -460,6 +645,8 @@ void cThread::userUnmap(void *vaddr) {
 	tmp[0] = reinterpret_cast<uint64_t>(vaddr);
 	tmp[1] = static_cast<uint64_t>(ctid);
 
+    untrackMapping(vaddr);
+
     auto gpu_it = gpu_dmabuf_fds.find(vaddr);
     if (gpu_it != gpu_dmabuf_fds.end()) {
         if (ioctl(fd, IOCTL_UNMAP_DMABUF, &tmp)) {
@@ -478,8 +665,260 @@ void cThread::userUnmap(void *vaddr) {
         return;
     }
 
-    if (ioctl(fd, IOCTL_UNMAP_USER_MEM, &tmp)) {
-        throw std::runtime_error("ERROR: IOCTL_UNMAP_USER_MEM failed");
+    if (reg_cache) {
+        reg_cache->removePinned(vaddr);
+    }
+
+    unmapHostMem(vaddr);
+}
+
+std::vector<int> cThread::mapHostMemBatch(const std::vector<mapRange> &ranges) const {
+    // Return code for buffers which the driver didn't process (e.g., older drivers, without batching)
+    const uint64_t NOT_PROCESSED = 0x8000000000000000ULL;
+
+    std::vector<int> codes(ranges.size(), 0);
+    std::vector<uint64_t> buffs;
+    
+    for (size_t first = 0; first < ranges.size(); first += MAP_BATCH_MAX) {
+        size_t n = std::min<size_t>(MAP_BATCH_MAX, ranges.size() - first);
+
+        buffs.resize(4 * n);
+        for (size_t i = 0; i < n; i++) {
+            buffs[4 * i] = reinterpret_cast<uint64_t>(ranges[first + i].vaddr);
+            buffs[4 * i + 1] = ranges[first + i].len;
+            buffs[4 * i + 2] = static_cast<uint64_t>(ranges[first + i].mem_block);
+            buffs[4 * i + 3] = NOT_PROCESSED;
+        }
+
+        uint64_t tmp[MAX_USER_ARGS];
+        tmp[0] = reinterpret_cast<uint64_t>(buffs.data());
+        tmp[1] = static_cast<uint64_t>(n);
+        tmp[2] = static_cast<uint64_t>(ctid);
+        ioctl(fd, IOCTL_MAP_USER_MEM_BATCH, &tmp);
+
+        for (size_t i = 0; i < n; i++) {
+            if (buffs[4 * i + 3] != NOT_PROCESSED) {
+                codes[first + i] = static_cast<int>(static_cast<int64_t>(buffs[4 * i + 3]));
+                continue;
+            }
+
+            // Fall back to mapping the buffer on its own
+            uint64_t single[MAX_USER_ARGS];
+            single[0] = buffs[4 * i];
+            single[1] = buffs[4 * i + 1];
+            single[2] = static_cast<uint64_t>(ctid);
+            single[3] = buffs[4 * i + 2];
+            codes[first + i] = ioctl(fd, IOCTL_MAP_USER_MEM, &single);
+        }
+    }
+
+    return codes;
+}
+
+void cThread::unmapHostMemBatch(const std::vector<void*> &vaddrs) {
+    std::vector<uint64_t> buffs;
+
+    for (size_t first = 0; first < vaddrs.size(); first += MAP_BATCH_MAX) {
+        size_t n = std::min<size_t>(MAP_BATCH_MAX, vaddrs.size() - first);
+
+        buffs.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            buffs[i] = reinterpret_cast<uint64_t>(vaddrs[first + i]);
+        }
+
+        uint64_t tmp[MAX_USER_ARGS];
+        tmp[0] = reinterpret_cast<uint64_t>(buffs.data());
+        tmp[1] = static_cast<uint64_t>(n);
+        tmp[2] = static_cast<uint64_t>(ctid);
+
+        // Older drivers, without batching, reject the unknown ioctl, and so do drivers with HMM (EOPNOTSUPP), 
+        // where unmapping releases nothing in the driver; either way, the buffers go through the single-buffer path
+        if (ioctl(fd, IOCTL_UNMAP_USER_MEM_BATCH, &tmp)) {
+            for (size_t i = 0; i < n; i++) {
+                unmapHostMem(vaddrs[first + i]);
+            }
+        }
+    }
+}
+
+void cThread::finishMapBatch(const std::vector<mapRange> &ranges, const std::vector<int> &codes) {
+    uint32_t n_failed = 0, n_sync = 0;
+
+    for (size_t i = 0; i < ranges.size(); i++) {
+        if (codes[i] && codes[i] != BUFF_NEEDS_EXP_SYNC_RET_CODE) {
+            n_failed++;
+            continue;
+        }
+
+        n_sync += (codes[i] == BUFF_NEEDS_EXP_SYNC_RET_CODE);
+        trackMapping(ranges[i].vaddr, ranges[i].len);
+        if (reg_cache) {
+            reg_cache->insertPinned(ranges[i].vaddr, ranges[i].len);
+        }
+    }
+
+    if (n_sync) {
+        std::cerr << "WARNING: userMap detected that " << n_sync << " of the mapped buffers may need explicit synchronization due to caching effects; see dmesg for more details" << std::endl;
+    }
+
+    if (n_failed) {
+        throw std::runtime_error("ERROR: IOCTL_MAP_USER_MEM_BATCH failed for " + std::to_string(n_failed) + " out of " + std::to_string(ranges.size()) + " buffers");
+    }
+}
+
+void cThread::userMapBatch(const std::vector<mapRange> &ranges) {
+    DBG1("cThread: Called userMapBatch to map " << ranges.size() << " user buffers, ctid " << ctid);
+
+    #if defined(EN_ROCM) || defined(EN_CUDA)
+        // GPU memory is detected (and exported) per buffer in userMap
+        for (auto &range : ranges) {
+            userMap(range.vaddr, range.len, range.mem_block);
+        }
+    #else
+        // Cached registrations overlapping the buffers are released first, as in userMap
+        if (reg_cache) {
+            for (auto &range : ranges) {
+                reg_cache->invalidate(range.vaddr, range.len);
+            }
+        }
+
+        finishMapBatch(ranges, mapHostMemBatch(ranges));
+    #endif
+}
+
+mapHandle cThread::userMapAsync(std::vector<mapRange> ranges) {
+    DBG1("cThread: Called userMapAsync to map " << ranges.size() << " user buffers, ctid " << ctid);
+
+    if (ranges.empty()) {
+        return mapHandle{};
+    }
+
+    #if defined(EN_ROCM) || defined(EN_CUDA)
+        userMapBatch(ranges);
+        return mapHandle{};
+    #else
+        if (reg_cache) {
+            for (auto &range : ranges) {
+                reg_cache->invalidate(range.vaddr, range.len);
+            }
+        }
+
+        // Only the ioctls run in the background; all the book-keeping is done in waitMap, by the calling thread
+        mapHandle handle { next_map_id++ };
+        pendingMap &pending = pending_maps[handle.id];
+        pending.ranges = std::move(ranges);
+        pending.codes = std::async(std::launch::async, &cThread::mapHostMemBatch, this, std::cref(pending.ranges));
+
+        return handle;
+    #endif
+}
+
+bool cThread::waitMap(mapHandle handle, std::chrono::nanoseconds timeout) {
+    auto it = pending_maps.find(handle.id);
+    if (it == pending_maps.end()) {
+        return true;
+    }
+
+    if (timeout == std::chrono::nanoseconds::max()) {
+        it->second.codes.wait();
+    } else if (it->second.codes.wait_for(timeout) != std::future_status::ready) {
+        return false;
+    }
+
+    std::vector<mapRange> ranges = std::move(it->second.ranges);
+    std::vector<int> codes = it->second.codes.get();
+    pending_maps.erase(it);
+
+    finishMapBatch(ranges, codes);
+    return true;
+}
+
+void cThread::userUnmapBatch(const std::vector<void*> &vaddrs) {
+    DBG1("cThread: Called userUnmapBatch to unmap " << vaddrs.size() << " user buffers, ctid " << ctid);
+
+    std::vector<void*> host_vaddrs;
+    host_vaddrs.reserve(vaddrs.size());
+
+    for (void *vaddr : vaddrs) {
+        if (gpu_dmabuf_fds.find(vaddr) != gpu_dmabuf_fds.end()) {
+            userUnmap(vaddr);
+            continue;
+        }
+
+        untrackMapping(vaddr);
+        if (reg_cache) {
+            reg_cache->removePinned(vaddr);
+        }
+        host_vaddrs.push_back(vaddr);
+    }
+
+    unmapHostMemBatch(host_vaddrs);
+}
+
+/// Utility function, sets the NUMA policy of freshly allocated host memory, before it is touched (and pinned) by userMap
+static void setNumaPolicy(void *mem, uint64_t size, const CoyoteAlloc &alloc, int32_t dev_node) {
+    unsigned long nodemask[MAX_NUMA_NODES / (8 * sizeof(unsigned long))] = { 0 };
+    int mode;
+
+    switch (alloc.numa) {
+        case CoyoteNuma::NONE: {
+            return;
+        }
+        case CoyoteNuma::DEVICE: case CoyoteNuma::NODE: {
+            int32_t node = (alloc.numa == CoyoteNuma::DEVICE) ? dev_node : alloc.numa_node;
+            if (node < 0 || node >= (int32_t) MAX_NUMA_NODES) {
+                std::cerr << "WARNING: cThread::getMem() - invalid or unknown NUMA node " << node << "; using the default policy" << std::endl;
+                return;
+            }
+
+            // Preferred, rather than bound, so that allocations fall back to other nodes instead of failing (e.g., no free hugepages on the node)
+            mode = MPOL_PREFERRED;
+            nodemask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+            break;
+        }
+        case CoyoteNuma::INTERLEAVE: {
+            mode = MPOL_INTERLEAVE;
+            if (syscall(SYS_get_mempolicy, NULL, nodemask, MAX_NUMA_NODES + 1, NULL, MPOL_F_MEMS_ALLOWED)) {
+                std::cerr << "WARNING: cThread::getMem() - failed to obtain the allowed NUMA nodes; using the default policy" << std::endl;
+                return;
+            }
+            break;
+        }
+        default: {
+            return;
+        }
+    }
+
+    // MPOL_MF_MOVE also migrates pages that were already touched, e.g., memory recycled by posix_memalign
+    if (syscall(SYS_mbind, mem, size, mode, nodemask, MAX_NUMA_NODES + 1, MPOL_MF_MOVE)) {
+        int err = errno;
+        std::cerr << "WARNING: cThread::getMem() - mbind failed: " << strerror(err) << "; using the default policy" << std::endl;
+    }
+}
+
+// Only available in kernel headers from Linux 5.14 onwards
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+/// Utility function, populates (prefaults) host memory for writing; falls back to touching every page on kernels without MADV_POPULATE_WRITE
+static void prefaultPages(void *mem, uint64_t size, uint64_t page_size) {
+    if (madvise(mem, size, MADV_POPULATE_WRITE) == 0) {
+        return;
+    }
+
+    // Read and write back the first byte of every page, to keep the current contents
+    volatile char *pages = reinterpret_cast<volatile char*>(mem);
+    for (uint64_t offs = 0; offs < size; offs += page_size) {
+        pages[offs] = pages[offs];
+    }
+}
+
+/// Utility function, advises the kernel to back host memory with transparent huge pages
+static void adviseHugePages(void *mem, uint64_t size) {
+    if (madvise(mem, size, MADV_HUGEPAGE)) {
+        int err = errno;
+        std::cerr << "WARNING: cThread::getMem() - madvise(MADV_HUGEPAGE) failed: " << strerror(err) << std::endl;
     }
 }
 
@@ -489,11 +928,49 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
 	void *mem = nullptr;
 
 	if (alloc.size > 0) {
+        // Recycled buffers are still mapped; only the book-keeping of userMap is repeated
+        if (recycler && (alloc.alloc == CoyoteAllocType::REG || alloc.alloc == CoyoteAllocType::THP || alloc.alloc == CoyoteAllocType::HPF || alloc.alloc == CoyoteAllocType::HPF_1G)) {
+            mem = recycler->get(alloc);
+            if (mem) {
+                DBG1("cThread: Reusing recycled memory at " << mem);
+                if (reg_cache) {
+                    reg_cache->invalidate(mem, alloc.size);
+                }
+
+                trackMapping(mem, alloc.size);
+                if (reg_cache) {
+                    reg_cache->insertPinned(mem, alloc.size);
+                }
+
+                mapped_pages.emplace(mem, alloc);
+                if (alloc.remote) {
+                    qpair->local.vaddr = mem;
+                    qpair->local.size =  alloc.size;
+                }
+                return mem;
+            }
+        }
+
 		switch (alloc.alloc)  {
             // Regular allocation 
 			case CoyoteAllocType::REG : {
                 DBG1("cThread: Obtain regular memory"); 
-                mem = mmap(NULL, alloc.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                // Pages can only be populated by mmap if they don't have to be placed (or migrated) by setNumaPolicy afterwards
+                int populate_flag = (alloc.populate && alloc.numa == CoyoteNuma::NONE && !alloc.thp_advise) ? MAP_POPULATE : 0;
+                mem = mmap(NULL, alloc.size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | populate_flag, -1, 0);
+                if (mem == MAP_FAILED) {
+                    int err = errno;
+                    throw std::runtime_error("ERROR: cThread::getMem() - Failed to allocate regular memory, errno " + std::to_string(err) + " (" + strerror(err) + ")");
+                }
+
+                if (alloc.thp_advise) {
+                    adviseHugePages(mem, alloc.size);
+                }
+                setNumaPolicy(mem, alloc.size, alloc, numa_node);
+                if (alloc.populate && !populate_flag) {
+                    prefaultPages(mem, alloc.size, PAGE_SIZE);
+                }
 				userMap(mem, alloc.size, alloc.mem_block);
 				break;
             }
@@ -506,22 +983,37 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
                     std::cerr << "ERROR: cThread::getMem() - Failed to allocate transparent hugepages!" << std::endl;
                     return nullptr;
                 }
+                if (alloc.thp_advise) {
+                    adviseHugePages(mem, alloc.size);
+                }
+                setNumaPolicy(mem, alloc.size, alloc, numa_node);
+                if (alloc.populate) {
+                    prefaultPages(mem, alloc.size, PAGE_SIZE);
+                }
                 userMap(mem, alloc.size, alloc.mem_block);
                 break;
             }
 
-            // Allocation of huge pages 
-            case CoyoteAllocType::HPF: {
+            // Allocation of huge pages; the size of the shell's large TLB pages, or 1GB
+            case CoyoteAllocType::HPF: case CoyoteAllocType::HPF_1G: {
                 DBG1("cThread: Obtain huge page memory");
 
+                // The driver maps hugetlb memory in chunks of the large TLB page size, assuming each chunk is physically contiguous;
+                // hence, a 1GB page takes several TLB entries for smaller shell pages, but can't be mapped for larger ones
+                uint32_t page_bits = (alloc.alloc == CoyoteAllocType::HPF_1G) ? HUGE_PAGE_1G_SHIFT : fcnfg.ctrl_reg.pg_l_bits;
+                if (alloc.alloc == CoyoteAllocType::HPF_1G && fcnfg.getHugePageSize() > HUGE_PAGE_1G_SIZE) {
+                    throw std::runtime_error("ERROR: cThread::getMem() - 1GB pages are smaller than the shell's large TLB pages (" + std::to_string(fcnfg.getHugePageSize()) + " B), cannot map them");
+                }
+
                 mem = MAP_FAILED;
-                int  huge_flag = (fcnfg.ctrl_reg.pg_l_bits << MAP_HUGE_SHIFT);
+                int  huge_flag = (page_bits << MAP_HUGE_SHIFT);
+                int populate_flag = (alloc.populate && alloc.numa == CoyoteNuma::NONE) ? MAP_POPULATE : 0;
 
                 mem = mmap(
                     NULL,
                     alloc.size,
                     PROT_READ | PROT_WRITE,
-                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_flag,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | huge_flag | populate_flag,
                     -1,
                     0
                 );
@@ -531,10 +1023,10 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
                 } else {
                     int err = errno;
                     fprintf(stderr,
-                        "cThread: Hugepage allocation failed: Shell pg_l_bits=%u (requested page size = %lu B), "
+                        "cThread: Hugepage allocation failed: page bits=%u (requested page size = %lu B), "
                         "alloc.size=%zu, errno=%d (%s)\n",
-                        fcnfg.ctrl_reg.pg_l_bits,
-                        1UL << fcnfg.ctrl_reg.pg_l_bits,
+                        page_bits,
+                        1UL << page_bits,
                         (size_t) alloc.size,
                         err,
                         strerror(err)
@@ -542,6 +1034,10 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
                     return nullptr;
                 }
 
+                setNumaPolicy(mem, alloc.size, alloc, numa_node);
+                if (alloc.populate && !populate_flag) {
+                    prefaultPages(mem, alloc.size, page_bits ? (1ULL << page_bits) : HUGE_PAGE_SIZE);
+                }
                 userMap(mem, alloc.size, alloc.mem_block);
                 break;
             }
@@ -662,6 +1158,14 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
 			default:
 				break;
 		}
+
+        if (alloc.verify_huge && alloc.alloc != CoyoteAllocType::GPU) {
+            double huge_fraction = getHugePageFraction(mem, alloc.size);
+            DBG1("cThread: Fraction of memory backed by huge pages: " << huge_fraction);
+            if (huge_fraction < 1.0) {
+                std::cerr << "WARNING: cThread::getMem() - only " << 100.0 * huge_fraction << "% of the allocation at " << mem << " is backed by huge pages" << std::endl;
+            }
+        }
         
         mapped_pages.emplace(mem, alloc);
 		DBG1("Mapped mem at: " << std::hex << reinterpret_cast<uint64_t>(mem) << std::dec);
@@ -677,26 +1181,101 @@ void* cThread::getMem(CoyoteAlloc&& alloc) {
 	return mem;
 }
 
-void cThread::freeMem(void* vaddr) {
-    DBG1("cThread: Releasing memory at vaddr " << vaddr);
+double cThread::getHugePageFraction(const void *vaddr, uint64_t len) const {
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr);
+    uint64_t end = start + len;
 
-	if (mapped_pages.find(vaddr) != mapped_pages.end()) {
+    std::ifstream smaps("/proc/self/smaps");
+    if (!smaps.is_open() || len == 0) {
+        return 0.0;
+    }
+
+    // Every memory area starts with a line "start-end perms ...", followed by "Key: value kB" lines
+    uint64_t area_start = 0, area_end = 0, huge_bytes = 0;
+    std::string line;
+    while (std::getline(smaps, line)) {
+        unsigned long long line_start, line_end;
+        if (sscanf(line.c_str(), "%llx-%llx ", &line_start, &line_end) == 2) {
+            area_start = line_start;
+            area_end = line_end;
+            continue;
+        }
+
+        if (area_end <= start || area_start >= end) {
+            continue;
+        }
+        uint64_t overlap = std::min(area_end, end) - std::max(area_start, start);
+
+        unsigned long long kb;
+        if (sscanf(line.c_str(), "KernelPageSize: %llu kB", &kb) == 1 && kb * 1024 > PAGE_SIZE) {
+            // hugetlbfs area, e.g., from HPF allocations
+            huge_bytes += overlap;
+        } else if (sscanf(line.c_str(), "AnonHugePages: %llu kB", &kb) == 1) {
+            huge_bytes += static_cast<uint64_t>(static_cast<double>(kb * 1024) * overlap / (area_end - area_start));
+        }
+    }
+
+    return std::min(1.0, static_cast<double>(huge_bytes) / len);
+}
+
+void cThread::releaseHostAlloc(void *vaddr, const CoyoteAlloc &alloc) {
+    switch (alloc.alloc) {
+        case CoyoteAllocType::THP : {
+            free(vaddr);
+            break;
+        }
+        case CoyoteAllocType::REG : case CoyoteAllocType::HPF : case CoyoteAllocType::HPF_1G : {
+            munmap(vaddr, alloc.size);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void cThread::releaseRecycled(const std::vector<std::pair<void*, CoyoteAlloc>> &buffs) {
+    std::vector<void*> vaddrs;
+    for (auto &buff : buffs) {
+        vaddrs.push_back(buff.first);
+    }
+
+    // Called from the recycler's destructor, so errors are reported rather than thrown; memory which may still be mapped is not released
+    try {
+        unmapHostMemBatch(vaddrs);
+    } catch (const std::exception &e) {
+        std::cerr << "ERROR: cThread::releaseRecycled() - " << e.what() << std::endl;
+        return;
+    }
+
+    for (auto &buff : buffs) {
+        releaseHostAlloc(buff.first, buff.second);
+    }
+}
+
+void cThread::freeMem(void* vaddr) {
+    DBG1("cThread: Releasing memory at vaddr " << vaddr);
+
+	if (mapped_pages.find(vaddr) != mapped_pages.end()) {
 		auto mapped = mapped_pages[vaddr];
 		
 		switch (mapped.alloc) {
-            case CoyoteAllocType::REG : {
-                userUnmap(vaddr);
-                munmap(vaddr, mapped.size);
-                break;
-            }
-            case CoyoteAllocType::THP : { 
-                userUnmap(vaddr);
-                free(vaddr);
-                break;
-            }
-            case CoyoteAllocType::HPF : {
+            case CoyoteAllocType::REG : case CoyoteAllocType::THP : case CoyoteAllocType::HPF : case CoyoteAllocType::HPF_1G : {
+                // With recycling, the buffer stays mapped; only the book-keeping of userUnmap is undone
+                if (recycler) {
+                    untrackMapping(vaddr);
+                    if (reg_cache) {
+                        reg_cache->removePinned(vaddr);
+                    }
+
+                    if (!recycler->put(vaddr, mapped)) {
+                        unmapHostMem(vaddr);
+                        releaseHostAlloc(vaddr, mapped);
+                    }
+                    break;
+                }
+
                 userUnmap(vaddr);
-                munmap(vaddr, mapped.size);
+                releaseHostAlloc(vaddr, mapped);
                 break;
             }
             case CoyoteAllocType::GPU : {
@@ -768,14 +1347,112 @@ void cThread::freeMem(void* vaddr) {
 	}
 }
 
+void cThread::enableRegCache(uint64_t budget) {
+    DBG1("cThread: Enabling registration cache with budget " << budget);
+
+    reg_cache = std::make_unique<cRegCache>(
+        budget,
+        [this](void *vaddr, uint64_t len) { mapHostMem(vaddr, len, -1); },
+        [this](void *vaddr) { unmapHostMem(vaddr); },
+        // Tickets of destroyed QPs can no longer be checked, so they are considered complete
+        [this](const cmdTicket &ticket) { 
+            return (isRemoteRdma(ticket.oper) && ticket.qp_id != 0 && qp_table.find(ticket.qp_id) == qp_table.end()) || isDone(ticket); 
+        }
+    );
+
+    // Buffers obtained from getMem() are already mapped and must never be released by the cache
+    for (auto &mapped : mapped_pages) {
+        if (mapped.second.alloc == CoyoteAllocType::REG || mapped.second.alloc == CoyoteAllocType::THP || mapped.second.alloc == CoyoteAllocType::HPF || mapped.second.alloc == CoyoteAllocType::HPF_1G) {
+            reg_cache->insertPinned(mapped.first, mapped.second.size);
+        }
+    }
+}
+
+void cThread::disableRegCache() {
+    DBG1("cThread: Disabling registration cache");
+    reg_cache.reset();
+}
+
+void cThread::invalidateRegCache(void *vaddr, uint64_t len) {
+    if (reg_cache) {
+        reg_cache->invalidate(vaddr, len);
+    }
+}
+
+regCacheStats cThread::getRegCacheStats() const {
+    return reg_cache ? reg_cache->getStats() : regCacheStats{};
+}
+
+void cThread::enableRecycling(uint64_t budget, std::chrono::nanoseconds idle_timeout) {
+    DBG1("cThread: Enabling buffer recycling with budget " << budget);
+
+    recycler.reset();
+    recycler = std::make_unique<cRecycler>(
+        budget, idle_timeout,
+        [this](const std::vector<std::pair<void*, CoyoteAlloc>> &buffs) { releaseRecycled(buffs); }
+    );
+}
+
+void cThread::disableRecycling() {
+    DBG1("cThread: Disabling buffer recycling");
+    recycler.reset();
+}
+
+void cThread::trimRecycled() {
+    if (recycler) {
+        recycler->trim();
+    }
+}
+
+recycleStats cThread::getRecycleStats() const {
+    return recycler ? recycler->getStats() : recycleStats{};
+}
+
 void cThread::setCSR(uint64_t val, uint32_t offs) {
+    std::call_once(ctrl_reg_once, &cThread::mmapCtrl, this);
     ctrl_reg[offs] = val; 
 }
 
 uint64_t cThread::getCSR(uint32_t offs) const {
+    std::call_once(ctrl_reg_once, &cThread::mmapCtrl, this);
     return ctrl_reg[offs];
 }
 
+/// Utility function, returns the number of commands a transfer is split into by appendLocalCmds() and appendRdmaCmds()
+static inline size_t nTransferCmds(uint64_t len) {
+    return len > MAX_TRANSFER_SIZE ? (len + MAX_TRANSFER_SIZE - 1) / MAX_TRANSFER_SIZE : 1;
+}
+
+/**
+ * Utility function, encodes a one-sided local command and appends it to cmds; transfers longer than 
+ * MAX_TRANSFER_SIZE are split into consecutive chunks, of which only the final one carries last
+ */
+static inline void appendLocalCmds(std::vector<std::array<uint64_t, 4>> &cmds, CoyoteOper oper, int32_t ctid, localSg sg, bool last) {
+    while (sg.len > MAX_TRANSFER_SIZE) {
+        localSg chunk = sg;
+        chunk.len = MAX_TRANSFER_SIZE;
+        cmds.emplace_back(localCmd(oper, ctid, chunk, false));
+
+        sg.addr = (void*) ((uint64_t) sg.addr + MAX_TRANSFER_SIZE);
+        sg.len -= MAX_TRANSFER_SIZE;
+    }
+    cmds.emplace_back(localCmd(oper, ctid, sg, last));
+}
+
+/// Utility function, same as appendLocalCmds, but for RDMA commands; chunks advance both the local and remote offsets
+static inline void appendRdmaCmds(std::vector<std::array<uint64_t, 4>> &cmds, CoyoteOper oper, int32_t ctid, const ibvQp &qpair, rdmaSg sg, bool last) {
+    while (sg.len > MAX_TRANSFER_SIZE) {
+        rdmaSg chunk = sg;
+        chunk.len = MAX_TRANSFER_SIZE;
+        cmds.emplace_back(rdmaCmd(oper, ctid, qpair, chunk, false));
+
+        sg.local_offs += MAX_TRANSFER_SIZE;
+        sg.remote_offs += MAX_TRANSFER_SIZE;
+        sg.len -= MAX_TRANSFER_SIZE;
+    }
+    cmds.emplace_back(rdmaCmd(oper, ctid, qpair, sg, last));
+}
+
 void cThread::invoke(CoyoteOper oper, syncSg sg) {
     DBG1("cThread: Call invoke for a sync/offload operation with address " << sg.addr << ", length " << sg.len);
 
@@ -815,7 +1492,7 @@ void cThread::invoke(CoyoteOper oper, syncSg sg) {
     }
 }
 
-void cThread::invoke(CoyoteOper oper, localSg sg, bool last) {
+cmdTicket cThread::invoke(CoyoteOper oper, localSg sg, bool last) {
     // Argument checks
     DBG1("cThread: Call invoke for a one-side local operation with address " << sg.addr << ", length " << sg.len);
 
@@ -827,46 +1504,64 @@ void cThread::invoke(CoyoteOper oper, localSg sg, bool last) {
         throw std::runtime_error("ERROR: cThread::invoke() called for a local operation, but the shell was not synthesized with streams from host memory, exiting...");
     }
 
-    if (sg.len > MAX_TRANSFER_SIZE) {
-        throw std::runtime_error("ERROR: cThread::invoke() - transfers over 128MB are currently not supported in Coyote, exiting...");
-    }
+    // Register or validate the buffer, if enabled; the lock is held until the registration is tied to the ticket
+    auto submission = lockSubmission();
+    prepareBuffer(sg.addr, sg.len);
 
     // Trigger the operation
-    if (oper == CoyoteOper::LOCAL_READ) {
-        uint64_t ctrl_cmd_src =
-            ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
-            ((sg.dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
-            (last ? CTRL_LAST : 0x0) |
-            ((sg.stream & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
-            (CTRL_START) | 
-            (0x0) | 
-            (static_cast<uint64_t>(sg.len) << CTRL_LEN_OFFS);
-        
-        uint64_t addr_cmd_src = reinterpret_cast<uint64_t>(sg.addr);
+    if (oper == CoyoteOper::LOCAL_READ || oper == CoyoteOper::LOCAL_WRITE) {
+        if (sg.len <= MAX_TRANSFER_SIZE) {
+            auto cmd = localCmd(oper, ctid, sg, last);
+            postCmd(cmd[0], cmd[1], cmd[2], cmd[3]);
+        } else {
+            // Large transfers are split into pipelined chunks, keeping the command FIFO full
+            std::vector<std::array<uint64_t, 4>> cmds;
+            cmds.reserve(nTransferCmds(sg.len));
+            appendLocalCmds(cmds, oper, ctid, sg, last);
+            postCmds(cmds);
+        }
+
+        return holdBuffers(issueTicket(oper, last));
+
+    } else {
+        std::cerr << "ERROR: cThread::invoke() called with an unsupported operation type; returning..." << std::endl;
+        return holdBuffers({});
+    }
+}
 
-        postCmd(0, 0, addr_cmd_src, ctrl_cmd_src);
+cmdTicket cThread::invoke(CoyoteOper oper, const std::vector<localSg> &sgs, bool last) {
+    // Argument checks
+    DBG1("cThread: Call invoke for a batch of " << sgs.size() << " one-sided local operations");
 
-    } else if (oper == CoyoteOper::LOCAL_WRITE) {
-        uint64_t ctrl_cmd_dst =
-            ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
-            ((sg.dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
-            (last ? CTRL_LAST : 0x0) |
-            ((sg.stream & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
-            (CTRL_START) | 
-            (0x0) | 
-            (static_cast<uint64_t>(sg.len) << CTRL_LEN_OFFS);
+    if (oper != CoyoteOper::LOCAL_READ && oper != CoyoteOper::LOCAL_WRITE) {
+        throw std::runtime_error("ERROR: cThread::invoke() called with a batch of localSg flags, but the operation is not a LOCAL_READ or LOCAL_WRITE; exiting...");
+    }
 
-        uint64_t addr_cmd_dst = reinterpret_cast<uint64_t>(sg.addr);
+    if (!fcnfg.en_strm && !fcnfg.en_mem) {
+        throw std::runtime_error("ERROR: cThread::invoke() called for a local operation, but the shell was not synthesized with streams from host memory, exiting...");
+    }
 
-        postCmd(addr_cmd_dst, ctrl_cmd_dst, 0, 0);
+    // Encode all the commands up-front; only the final one carries last
+    std::vector<std::array<uint64_t, 4>> cmds;
+    size_t n_cmds = 0;
+    for (const auto &sg : sgs) {
+        n_cmds += nTransferCmds(sg.len);
+    }
+    cmds.reserve(n_cmds);
 
-    } else {
-        std::cerr << "ERROR: cThread::invoke() called with an unsupported operation type; returning..." << std::endl;
-        return;
+    auto submission = lockSubmission();
+    for (size_t i = 0; i < sgs.size(); i++) {
+        prepareBuffer(sgs[i].addr, sgs[i].len);
+        appendLocalCmds(cmds, oper, ctid, sgs[i], last && (i == sgs.size() - 1));
     }
+
+    // Trigger the operations
+    postCmds(cmds);
+
+    return holdBuffers(sgs.empty() ? cmdTicket{} : issueTicket(oper, last));
 }
 
-void cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last) {
+cmdTicket cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last) {
     // Argument checks
     DBG1(
         "cThread: Call invoke for a two-sided local operation with source address " 
@@ -882,29 +1577,41 @@ void cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last)
         throw std::runtime_error("ERROR: cThread::invoke() called for a local operation but the shell was not synthesized with streams from host memory, exiting...");
     }
 
-    if (src_sg.len > MAX_TRANSFER_SIZE || dst_sg.len > MAX_TRANSFER_SIZE) {
-        throw std::runtime_error("ERROR: cThread::invoke() - transfers over 128MB are currently not supported in Coyote, exiting...");
+    // Large transfers can only be split if both sides move the same amount of data, so the chunks stay paired
+    if ((src_sg.len > MAX_TRANSFER_SIZE || dst_sg.len > MAX_TRANSFER_SIZE) && src_sg.len != dst_sg.len) {
+        throw std::runtime_error("ERROR: cThread::invoke() - transfers over 128MB require equal source and destination lengths, exiting...");
     }
 
+    // Register or validate the buffers, if enabled
+    auto submission = lockSubmission();
+    prepareBuffer(src_sg.addr, src_sg.len);
+    prepareBuffer(dst_sg.addr, dst_sg.len);
+
     // Trigger the operation
-    if (oper == CoyoteOper::LOCAL_TRANSFER) {
-        uint64_t ctrl_cmd_src =
-            ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
-            ((src_sg.dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
-            (last ? CTRL_LAST : 0x0) |
-            ((src_sg.stream & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
-            (CTRL_START) | 
-            (0x0) | 
-            (static_cast<uint64_t>(src_sg.len) << CTRL_LEN_OFFS);
-
-        uint64_t ctrl_cmd_dst =
-            ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
-            ((dst_sg.dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
-            (last ? CTRL_LAST : 0x0) |
-            ((dst_sg.stream & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
-            (CTRL_START) | 
-            (0x0) | 
-            (static_cast<uint64_t>(dst_sg.len) << CTRL_LEN_OFFS);
+    if (oper == CoyoteOper::LOCAL_TRANSFER && src_sg.len > MAX_TRANSFER_SIZE) {
+        std::vector<std::array<uint64_t, 4>> cmds;
+        cmds.reserve(nTransferCmds(src_sg.len));
+        
+        uint64_t offs = 0;
+        while (offs < src_sg.len) {
+            localSg src_chunk = src_sg, dst_chunk = dst_sg;
+            src_chunk.addr = (void*) ((uint64_t) src_sg.addr + offs);
+            dst_chunk.addr = (void*) ((uint64_t) dst_sg.addr + offs);
+            src_chunk.len = dst_chunk.len = std::min<uint64_t>(src_sg.len - offs, MAX_TRANSFER_SIZE);
+            offs += src_chunk.len;
+
+            bool chunk_last = last && (offs == src_sg.len);
+            cmds.push_back({
+                reinterpret_cast<uint64_t>(dst_chunk.addr), localCtrlCmd(ctid, dst_chunk, chunk_last),
+                reinterpret_cast<uint64_t>(src_chunk.addr), localCtrlCmd(ctid, src_chunk, chunk_last)
+            });
+        }
+
+        postCmds(cmds);
+
+    } else if (oper == CoyoteOper::LOCAL_TRANSFER) {
+        uint64_t ctrl_cmd_src = localCtrlCmd(ctid, src_sg, last);
+        uint64_t ctrl_cmd_dst = localCtrlCmd(ctid, dst_sg, last);
 
         uint64_t addr_cmd_src = reinterpret_cast<uint64_t>(src_sg.addr);
         uint64_t addr_cmd_dst = reinterpret_cast<uint64_t>(dst_sg.addr);
@@ -913,11 +1620,13 @@ void cThread::invoke(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last)
 
     } else {
         std::cerr << "ERROR: cThread::invoke() called with an unsupported operation type; returning..." << std::endl;
-        return;
+        return holdBuffers({});
     }
+
+    return holdBuffers(issueTicket(oper, last));
 }
 
-void cThread::invoke(CoyoteOper oper, rdmaSg sg, bool last) {
+cmdTicket cThread::invoke(CoyoteOper oper, rdmaSg sg, bool last) {
     // Argument checks
     DBG1("cThread: Call invoke for a RDMA operation with length " << sg.len);
 
@@ -929,52 +1638,112 @@ void cThread::invoke(CoyoteOper oper, rdmaSg sg, bool last) {
         throw std::runtime_error("ERROR: cThread::invoke() called for an RDMA operation but the shell was not synthesized with RDMA support, exiting...");
     }
 
-    if (sg.len > MAX_TRANSFER_SIZE) {
-        throw std::runtime_error("ERROR: cThread::invoke() - transfers over 128MB are currently not supported in Coyote, exiting...");
+    // Validate the local buffer, if enabled; the lookup cache of isMapped() isn't thread-safe, so this is done under the submission lock
+    auto submission = lockSubmission();
+    qpEntry *qpe = findQp(sg.qp_id);
+    const ibvQp &qp = qpe ? qpe->qpair : *qpair;
+    int32_t qp_ctid = qpe ? qpe->ctid : ctid;
+
+    if (validate_sg) {
+        checkMapped((void*) ((uint64_t) qp.local.vaddr + sg.local_offs), sg.len);
     }
 
     // Trigger the operation
-    if (qpair->local.ip_addr == qpair->remote.ip_addr) {
-        DBG1("cThread: remote and local node for RDMA operation are identical; calling memcpy");
-        
-        void *local_addr = (void*) ((uint64_t) qpair->local.vaddr + sg.local_offs);
-        void *remote_addr = (void*) ((uint64_t) qpair->remote.vaddr + sg.remote_offs);
-        memcpy(remote_addr, local_addr, sg.len);
+    if (qp.local.ip_addr == qp.remote.ip_addr) {
+        DBG1("cThread: remote and local node for RDMA operation are identical; using the copy engine");
+        loopbackCopy(oper, sg, last);
+
+    } else if (sg.len <= MAX_TRANSFER_SIZE) {
+        auto cmd = rdmaCmd(oper, qp_ctid, qp, sg, last);
+        postCmd(cmd[0], cmd[1], cmd[2], cmd[3]);
 
     } else {
-        // Local command and address
-        uint64_t ctrl_cmd_l =
-            (((static_cast<uint64_t>(oper) - REMOTE_OFFS_OPS) & CTRL_OPCODE_MASK) << CTRL_OPCODE_OFFS) |
-            ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
-            ((sg.local_dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
-            (last ? CTRL_LAST : 0x0) |
-            ((sg.local_stream & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
-            (0x0) | 
-            (static_cast<uint64_t>(sg.len) << CTRL_LEN_OFFS);
-        
-        uint64_t addr_cmd_l = static_cast<uint64_t>((uint64_t) qpair->local.vaddr + sg.local_offs);
-
-        // Remote command and address
-        uint64_t ctrl_cmd_r =                    
-            (((static_cast<uint64_t>(oper) - REMOTE_OFFS_OPS) & CTRL_OPCODE_MASK) << CTRL_OPCODE_OFFS) |
-            ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS) |
-            ((sg.remote_dest & CTRL_DEST_MASK) << CTRL_DEST_OFFS) |
-            (last ? CTRL_LAST : 0x0) |
-            ((STRM_RDMA & CTRL_STRM_MASK) << CTRL_STRM_OFFS) | 
-            (CTRL_START) |
-            (0x0) | 
-            (static_cast<uint64_t>(sg.len) << CTRL_LEN_OFFS);
-
-        uint64_t addr_cmd_r = static_cast<uint64_t>((uint64_t) qpair->remote.vaddr + sg.remote_offs); 
-
-        // Order - based on the distinction between Read and Write, determine what is source and what is destination 
-        uint64_t ctrl_cmd_src = isRemoteRead(oper) ? ctrl_cmd_r : ctrl_cmd_l;
-        uint64_t addr_cmd_src = isRemoteRead(oper) ? addr_cmd_r : addr_cmd_l;
-        uint64_t ctrl_cmd_dst = isRemoteRead(oper) ? ctrl_cmd_l : ctrl_cmd_r;
-        uint64_t addr_cmd_dst = isRemoteRead(oper) ? addr_cmd_l : addr_cmd_r;
+        // Large transfers are split into pipelined chunks, keeping the command FIFO full
+        std::vector<std::array<uint64_t, 4>> cmds;
+        cmds.reserve(nTransferCmds(sg.len));
+        appendRdmaCmds(cmds, oper, qp_ctid, qp, sg, last);
+        postCmds(cmds);
+    }
 
-        postCmd(addr_cmd_dst, ctrl_cmd_dst, addr_cmd_src, ctrl_cmd_src);
+    return issueTicket(oper, last, sg.qp_id);
+}
+
+cmdTicket cThread::invoke(CoyoteOper oper, const std::vector<rdmaSg> &sgs, bool last) {
+    // Argument checks
+    DBG1("cThread: Call invoke for a batch of " << sgs.size() << " RDMA operations");
+
+    if (!isRemoteRdma(oper)) {
+        throw std::runtime_error("ERROR: cThread::invoke() called with a batch of rdmaSg flags, but the operation is not a REMOTE_READ or REMOTE_WRITE; exiting...");
+    }
+
+    if (!fcnfg.en_rdma) {
+        throw std::runtime_error("ERROR: cThread::invoke() called for an RDMA operation but the shell was not synthesized with RDMA support, exiting...");
+    }
+
+    if (sgs.empty()) {
+        return {};
+    }
+
+    // Completions are counted per QP, so a batch can't span several QPs
+    int32_t qp_id = sgs.front().qp_id;
+    for (const auto &sg : sgs) {
+        if (sg.qp_id != qp_id) {
+            throw std::runtime_error("ERROR: cThread::invoke() - all the entries of an RDMA batch must target the same queue pair, exiting...");
+        }
+    }
+
+    // Validate the local buffers, if enabled
+    auto submission = lockSubmission();
+    qpEntry *qpe = findQp(qp_id);
+    const ibvQp &qp = qpe ? qpe->qpair : *qpair;
+    int32_t qp_ctid = qpe ? qpe->ctid : ctid;
+
+    if (validate_sg) {
+        for (const auto &sg : sgs) {
+            checkMapped((void*) ((uint64_t) qp.local.vaddr + sg.local_offs), sg.len);
+        }
+    }
+
+    // Trigger the operations
+    if (qp.local.ip_addr == qp.remote.ip_addr) {
+        DBG1("cThread: remote and local node for RDMA operation are identical; using the copy engine");
+
+        for (size_t i = 0; i < sgs.size(); i++) {
+            loopbackCopy(oper, sgs[i], last && (i == sgs.size() - 1));
+        }
+
+    } else {
+        // Encode all the commands up-front; only the final one carries last
+        std::vector<std::array<uint64_t, 4>> cmds;
+        size_t n_cmds = 0;
+        for (const auto &sg : sgs) {
+            n_cmds += nTransferCmds(sg.len);
+        }
+        cmds.reserve(n_cmds);
+        for (size_t i = 0; i < sgs.size(); i++) {
+            appendRdmaCmds(cmds, oper, qp_ctid, qp, sgs[i], last && (i == sgs.size() - 1));
+        }
+
+        postCmds(cmds);
     }
+
+    return issueTicket(oper, last, qp_id);
+}
+
+void cThread::loopbackCopy(CoyoteOper oper, const rdmaSg &sg, bool last) {
+    qpEntry *qpe = findQp(sg.qp_id);
+    const ibvQp &qp = qpe ? qpe->qpair : *qpair;
+
+    void *local_addr = (void*) ((uint64_t) qp.local.vaddr + sg.local_offs);
+    void *remote_addr = (void*) ((uint64_t) qp.remote.vaddr + sg.remote_offs);
+
+    // RDMA reads move data from the remote to the local buffer; writes and sends the other way around
+    void *dst = isRemoteRead(oper) ? local_addr : remote_addr;
+    void *src = isRemoteRead(oper) ? remote_addr : local_addr;
+
+    copyCounter &counter = (qpe ? qpe->loopback_cmpl : loopback_cmpl)[isRemoteRead(oper) ? RD_RDMA_WBACK : WR_RDMA_WBACK];
+    uint64_t pos = counter.reserve();
+    cCopyEngine::getInstance().submit(dst, src, sg.len, [&counter, pos, last] { counter.finish(pos, last); });
 }
 
 void cThread::invoke(CoyoteOper oper, tcpSg sg, bool last) {
@@ -1006,11 +1775,118 @@ void cThread::invoke(CoyoteOper oper, tcpSg sg, bool last) {
     uint64_t addr_cmd_src = 0;
     uint64_t addr_cmd_dst = 0;
 
+    auto submission = lockSubmission();
     postCmd(addr_cmd_dst, ctrl_cmd_dst, addr_cmd_src, ctrl_cmd_src);
 }
 
+cCmdTemplate cThread::prepareCmd(CoyoteOper oper, localSg sg, bool last) {
+    DBG1("cThread: Called prepareCmd for a one-sided local operation with address " << sg.addr << ", length " << sg.len);
+
+    if (oper != CoyoteOper::LOCAL_READ && oper != CoyoteOper::LOCAL_WRITE) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called with localSg flags, but the operation is not a LOCAL_READ or LOCAL_WRITE; exiting...");
+    }
+
+    if (!fcnfg.en_strm && !fcnfg.en_mem) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called for a local operation, but the shell was not synthesized with streams from host memory, exiting...");
+    }
+
+    if (sg.len > MAX_TRANSFER_SIZE) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() - transfers over 128MB can't be posted as a single command, exiting...");
+    }
+
+    return cCmdTemplate(oper, last, ctid, localCmd(oper, ctid, sg, last), oper == CoyoteOper::LOCAL_READ, oper == CoyoteOper::LOCAL_WRITE);
+}
+
+cCmdTemplate cThread::prepareCmd(CoyoteOper oper, localSg src_sg, localSg dst_sg, bool last) {
+    DBG1("cThread: Called prepareCmd for a two-sided local operation with source address " << src_sg.addr << ", destination address " << dst_sg.addr);
+
+    if (oper != CoyoteOper::LOCAL_TRANSFER) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called with two localSg flags, but the operation is not a LOCAL_TRANSFER; exiting...");
+    }
+
+    if (!fcnfg.en_strm && !fcnfg.en_mem) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called for a local operation, but the shell was not synthesized with streams from host memory, exiting...");
+    }
+
+    if (src_sg.len > MAX_TRANSFER_SIZE || dst_sg.len > MAX_TRANSFER_SIZE) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() - transfers over 128MB can't be posted as a single command, exiting...");
+    }
+
+    std::array<uint64_t, 4> cmd = {
+        reinterpret_cast<uint64_t>(dst_sg.addr), localCtrlCmd(ctid, dst_sg, last),
+        reinterpret_cast<uint64_t>(src_sg.addr), localCtrlCmd(ctid, src_sg, last)
+    };
+    return cCmdTemplate(oper, last, ctid, cmd, true, true);
+}
+
+cCmdTemplate cThread::prepareCmd(CoyoteOper oper, rdmaSg sg, bool last) {
+    DBG1("cThread: Called prepareCmd for an RDMA operation with length " << sg.len);
+
+    if (!isRemoteRdma(oper)) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called with rdmaSg flags, but the operation is not a REMOTE_READ or REMOTE_WRITE; exiting...");
+    }
+
+    if (!fcnfg.en_rdma) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() called for an RDMA operation but the shell was not synthesized with RDMA support, exiting...");
+    }
+
+    if (sg.len > MAX_TRANSFER_SIZE) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() - transfers over 128MB can't be posted as a single command, exiting...");
+    }
+
+    qpEntry *qpe = findQp(sg.qp_id);
+    const ibvQp &qp = qpe ? qpe->qpair : *qpair;
+    int32_t qp_ctid = qpe ? qpe->ctid : ctid;
+
+    // Loopback operations are executed by the copy engine in invoke(), so there is no command to prepare
+    if (qp.local.ip_addr == qp.remote.ip_addr) {
+        throw std::runtime_error("ERROR: cThread::prepareCmd() - remote and local node are identical, use invoke() instead, exiting...");
+    }
+
+    return cCmdTemplate(oper, last, qp_ctid, rdmaCmd(oper, qp_ctid, qp, sg, last), true, true, sg.qp_id);
+}
+
+cmdTicket cThread::post(const cCmdTemplate &tmpl) {
+    qpEntry *qpe = findQp(tmpl.qp_id);
+    if (tmpl.ctid != (qpe ? qpe->ctid : ctid)) {
+        throw std::runtime_error("ERROR: cThread::post() - the command was prepared by a different cThread, exiting...");
+    }
+
+    // Register or validate the buffers, if enabled; for RDMA, only the local buffer is validated, as in invoke()
+    auto submission = lockSubmission();
+    if (isRemoteRdma(tmpl.oper)) {
+        if (validate_sg) {
+            if (isRemoteRead(tmpl.oper)) {
+                checkMapped((void*) tmpl.getDstAddr(), tmpl.getDstLen());
+            } else {
+                checkMapped((void*) tmpl.getSrcAddr(), tmpl.getSrcLen());
+            }
+        }
+    } else {
+        if (tmpl.has_src) {
+            prepareBuffer((void*) tmpl.getSrcAddr(), tmpl.getSrcLen());
+        }
+        if (tmpl.has_dst) {
+            prepareBuffer((void*) tmpl.getDstAddr(), tmpl.getDstLen());
+        }
+    }
+
+    postCmd(tmpl.cmd[0], tmpl.cmd[1], tmpl.cmd[2], tmpl.cmd[3]);
+    return holdBuffers(issueTicket(tmpl.oper, tmpl.last, tmpl.qp_id));
+}
+
 uint32_t cThread::checkCompleted(CoyoteOper coper) const {
+    return checkCompleted(coper, 0);
+}
+
+uint32_t cThread::checkCompleted(CoyoteOper coper, int32_t qp_id) const {
     DBG1("cThread: Called checkCompleted");
+
+    // RDMA operations are counted per QP, under the ctid backing the QP
+    const qpEntry *qpe = isRemoteRdma(coper) ? findQp(qp_id) : nullptr;
+    const int32_t qp_ctid = qpe ? qpe->ctid : ctid;
+    const copyCounter *qp_loopback_cmpl = qpe ? qpe->loopback_cmpl : loopback_cmpl;
+
     /*
      * The order of these if-else clauses is very important in this function
      * LOCAL_TRANSFER are two-sided operations, which means isLocalRead and isLocalWrite
@@ -1043,52 +1919,322 @@ uint32_t cThread::checkCompleted(CoyoteOper coper) const {
 		}
 	} else if (isRemoteRead(coper)) {
 		if (fcnfg.en_wb) {
-			return wback[ctid + RD_RDMA_WBACK*N_CTID_MAX];
+			return wback[qp_ctid + RD_RDMA_WBACK*N_CTID_MAX] + qp_loopback_cmpl[RD_RDMA_WBACK].completed();
 		} else {
             #ifdef EN_AVX
 			if (fcnfg.en_avx) 
-				return _mm256_extract_epi32(cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::STAT_DMA_REG) + ctid], 2);
+				return _mm256_extract_epi32(cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::STAT_DMA_REG) + qp_ctid], 2) + qp_loopback_cmpl[RD_RDMA_WBACK].completed();
 			else 
             #endif
-				return (LOW_32(cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::STAT_RDMA_REG) + ctid]));
+				return (LOW_32(cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::STAT_RDMA_REG) + qp_ctid])) + qp_loopback_cmpl[RD_RDMA_WBACK].completed();
 		}
 	} else if (isRemoteWriteOrSend(coper)) {
         if (fcnfg.en_wb) {
-            return wback[ctid + WR_RDMA_WBACK*N_CTID_MAX];
+            return wback[qp_ctid + WR_RDMA_WBACK*N_CTID_MAX] + qp_loopback_cmpl[WR_RDMA_WBACK].completed();
         } else {
             #ifdef EN_AVX
             if (fcnfg.en_avx) 
-                return _mm256_extract_epi32(cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::STAT_DMA_REG) + ctid], 3);
+                return _mm256_extract_epi32(cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::STAT_DMA_REG) + qp_ctid], 3) + qp_loopback_cmpl[WR_RDMA_WBACK].completed();
             else
             #endif
-                return (HIGH_32(cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::STAT_RDMA_REG) + ctid]));  
+                return (HIGH_32(cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::STAT_RDMA_REG) + qp_ctid])) + qp_loopback_cmpl[WR_RDMA_WBACK].completed();  
         }
     } else {
         return 0;
     }
 }
 
+cmdTicket cThread::issueTicket(CoyoteOper oper, bool last, int32_t qp_id) {
+    // RDMA operations are counted per QP
+    if (!isRemoteRdma(oper)) {
+        qp_id = 0;
+    }
+    qpEntry *qpe = findQp(qp_id);
+    uint32_t *qp_cmpl_issued = qpe ? qpe->cmpl_issued : cmpl_issued;
+
+    // Same order as in checkCompleted(); LOCAL_TRANSFER completes on the write side
+    uint32_t *issued;
+    if (isLocalWrite(oper)) {
+        issued = &qp_cmpl_issued[WR_WBACK];
+    } else if (isLocalRead(oper)) {
+        issued = &qp_cmpl_issued[RD_WBACK];
+    } else if (isRemoteRead(oper)) {
+        issued = &qp_cmpl_issued[RD_RDMA_WBACK];
+    } else if (isRemoteWriteOrSend(oper)) {
+        issued = &qp_cmpl_issued[WR_RDMA_WBACK];
+    } else {
+        return {};
+    }
+
+    // Operations without last complete together with the next operation that has last set
+    if (!last) {
+        return {oper, *issued + 1, qp_id};
+    }
+
+    // LOCAL_TRANSFER also increments the read completion counter
+    if (oper == CoyoteOper::LOCAL_TRANSFER) {
+        qp_cmpl_issued[RD_WBACK]++;
+    }
+    return {oper, ++(*issued), qp_id};
+}
+
+bool cThread::isDone(cmdTicket ticket) const {
+    // Wrap-around safe comparison of the completion counter against the ticket
+    return static_cast<int32_t>(checkCompleted(ticket.oper, ticket.qp_id) - ticket.seq) >= 0;
+}
+
+bool cThread::wait(cmdTicket ticket, std::chrono::nanoseconds timeout, waitPolicy policy, waitStats *stats) const {
+    return waitCompleted(ticket.oper, ticket.seq, timeout, policy, stats, ticket.qp_id);
+}
+
+bool cThread::waitCompleted(CoyoteOper oper, uint32_t target, std::chrono::nanoseconds timeout, waitPolicy policy, waitStats *stats, int32_t qp_id) const {
+    DBG1("cThread: Called waitCompleted with target " << target);
+
+    auto start = std::chrono::steady_clock::now();
+    auto sleep_time = policy.min_sleep;
+    uint64_t n_polls = 0;
+    bool done = false;
+
+    while (true) {
+        n_polls++;
+        if (static_cast<int32_t>(checkCompleted(oper, qp_id) - target) >= 0) {
+            done = true;
+            break;
+        }
+
+        // While spinning, only check for time-outs every few polls
+        bool spinning = (policy.wait == CoyoteWait::SPIN) || (n_polls <= policy.n_spins);
+        if (!spinning || (n_polls % WAIT_CLOCK_POLLS == 0)) {
+            if (std::chrono::steady_clock::now() - start >= timeout) {
+                break;
+            }
+        }
+
+        if (spinning) {
+            continue;
+        }
+
+        // Back-off, as specified by the wait policy
+        switch (policy.wait) {
+            case CoyoteWait::PAUSE:
+                #if defined(__x86_64__) || defined(__i386__)
+                _mm_pause();
+                #else
+                std::this_thread::yield();
+                #endif
+                break;
+            case CoyoteWait::YIELD:
+                std::this_thread::yield();
+                break;
+            case CoyoteWait::SLEEP:
+                std::this_thread::sleep_for(sleep_time);
+                sleep_time = std::min(sleep_time * 2, policy.max_sleep);
+                break;
+            default:
+                break;
+        }
+    }
+
+    if (stats) {
+        stats->n_polls = n_polls;
+        stats->elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    return done;
+}
+
 void cThread::clearCompleted() {
     DBG1("cThread: Called clearCompleted"); 
-    
+
+    // Loopback copies in flight would increment the counters after they were cleared, so wait for them first
+    for (uint32_t i = 0; i < N_WBACKS; i++) {
+        loopback_cmpl[i].clear();
+    }
+
+    // Outstanding tickets are invalidated, since the counters they refer to are reset
+    for (uint32_t i = 0; i < N_WBACKS; i++) {
+        cmpl_issued[i] = 0;
+    }
+    clearCounters(ctid);
+
+    // Same for the additional QPs
+    for (auto &it : qp_table) {
+        qpEntry &qpe = *it.second;
+        for (uint32_t i = 0; i < N_WBACKS; i++) {
+            qpe.loopback_cmpl[i].clear();
+            qpe.cmpl_issued[i] = 0;
+        }
+        clearCounters(qpe.ctid);
+    }
+
+    // Registrations held by the invalidated tickets would otherwise stay in use until the reset counters reach them again
+    if (reg_cache) {
+        reg_cache->releaseAll();
+    }
+    n_clears.fetch_add(1, std::memory_order_release);
+}
+
+uint32_t cThread::getClearCount() const {
+    return n_clears.load(std::memory_order_acquire);
+}
+
+void cThread::clearCounters(int32_t target_ctid) {
     if (fcnfg.en_wb) {
         for (int i = 0; i < N_WBACKS; i++) {
-            wback[ctid + i * N_CTID_MAX] = 0;
+            wback[target_ctid + i * N_CTID_MAX] = 0;
         }
     }
 
     #ifdef EN_AVX
 	if (fcnfg.en_avx) {
-		cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::CTRL_REG)] = _mm256_set_epi64x(0, CTRL_CLR_STAT | ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS), 0, CTRL_CLR_STAT | ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS));
+		cnfg_reg_avx[static_cast<uint32_t>(CnfgAvxRegs::CTRL_REG)] = _mm256_set_epi64x(0, CTRL_CLR_STAT | ((target_ctid & CTRL_PID_MASK) << CTRL_PID_OFFS), 0, CTRL_CLR_STAT | ((target_ctid & CTRL_PID_MASK) << CTRL_PID_OFFS));
     } else {
     #endif
-        cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG_2)] = CTRL_CLR_STAT | ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS);
-        cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG)] = CTRL_CLR_STAT | ((ctid & CTRL_PID_MASK) << CTRL_PID_OFFS);
+        cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG_2)] = CTRL_CLR_STAT | ((target_ctid & CTRL_PID_MASK) << CTRL_PID_OFFS);
+        cnfg_reg[static_cast<uint32_t>(CnfgLegRegs::CTRL_REG)] = CTRL_CLR_STAT | ((target_ctid & CTRL_PID_MASK) << CTRL_PID_OFFS);
     #ifdef EN_AVX
     }
     #endif
 }
 
+void cThread::enableNotifyRing() {
+    DBG1("cThread: Called enableNotifyRing");
+    if (notify_ring) {
+        return;
+    }
+
+    if (efd != -1) {
+        throw std::runtime_error("ERROR: cThread::enableNotifyRing() - a user interrupt service routine is already registered, exiting...");
+    }
+
+    // Allocate the ring in the driver and map it; from now on, notifications are queued in the ring instead of going through the eventfd
+	uint64_t tmp[MAX_USER_ARGS];
+    tmp[0] = ctid;
+    if (ioctl(fd, IOCTL_REGISTER_NOTIFY_RING, &tmp)) {
+        throw std::runtime_error("ERROR: IOCTL_REGISTER_NOTIFY_RING failed");
+    }
+
+    void *ring = mmap(NULL, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, MMAP_NOTIFY + ctid * PAGE_SIZE);
+    if (ring == MAP_FAILED) {
+        ioctl(fd, IOCTL_UNREGISTER_NOTIFY_RING, &tmp);
+        throw std::runtime_error("ERROR: cThread::enableNotifyRing() - notification ring mmap failed");
+    }
+    notify_ring = (notifyRing*) ring;
+
+    // On failure below, the ring is released in reverse order, leaving the cThread as if the ring was never enabled
+    auto releaseRing = [&]() {
+        munmap(ring, PAGE_SIZE);
+        tmp[0] = ctid;
+        ioctl(fd, IOCTL_UNREGISTER_NOTIFY_RING, &tmp);
+        notify_ring = nullptr;
+    };
+
+    // The eventfd is only signalled while blocked in waitNotification(); busy-polling doesn't need it
+    notify_efd = eventfd(0, EFD_NONBLOCK);
+    if (notify_efd == -1) {
+        releaseRing();
+        throw std::runtime_error("ERROR: cThread could not create eventfd");
+    }
+
+    tmp[0] = ctid;
+    tmp[1] = notify_efd;
+    if (ioctl(fd, IOCTL_REGISTER_EVENTFD, &tmp)) {
+        close(notify_efd);
+        notify_efd = -1;
+        releaseRing();
+        throw std::runtime_error("ERROR: IOCTL_REGISTER_EVENTFD failed");
+    }
+
+    DBG1("cThread: notification ring mapped at " << ring);
+}
+
+void cThread::disableNotifyRing() {
+    DBG1("cThread: Called disableNotifyRing");
+    if (!notify_ring) {
+        return;
+    }
+
+    // The eventfd is unregistered first; afterwards, the driver no longer signals it and, once the ring is unregistered, drops notifications
+	uint64_t tmp[MAX_USER_ARGS];
+    tmp[0] = ctid;
+    if (notify_efd != -1) {
+        ioctl(fd, IOCTL_UNREGISTER_EVENTFD, &tmp);
+        close(notify_efd);
+        notify_efd = -1;
+    }
+    
+    ioctl(fd, IOCTL_UNREGISTER_NOTIFY_RING, &tmp);
+
+    if (munmap((void*) notify_ring, PAGE_SIZE) != 0) {
+        std::cerr << "WARNING: cThread::disableNotifyRing() - notification ring munmap failed" << std::endl;
+    }
+    notify_ring = nullptr;
+}
+
+bool cThread::pollNotification(int32_t &value) {
+    if (!notify_ring) {
+        throw std::runtime_error("ERROR: cThread::pollNotification() - notification ring not enabled, use enableNotifyRing(), exiting...");
+    }
+
+    // Single consumer: only this side writes the head; the acquire on the tail pairs with the release in the driver
+    uint32_t head = notify_ring->head.load(std::memory_order_relaxed);
+    if (head == notify_ring->tail.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    value = notify_ring->values[head & (NOTIFY_RING_SIZE - 1)];
+    notify_ring->head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+bool cThread::waitNotification(int32_t &value, int timeout_ms) {
+    if (pollNotification(value)) {
+        return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        // Announce the consumer is about to block, then re-check the ring; the fence pairs with the one in the driver, 
+        // so either this check sees the new tail, or the driver sees the flag and signals the eventfd 
+        notify_ring->waiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (pollNotification(value)) {
+            notify_ring->waiting.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        int remaining_ms = -1;
+        if (timeout_ms >= 0) {
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            remaining_ms = remaining > 0 ? (int) remaining : 0;
+        }
+
+        struct pollfd pfd = { notify_efd, POLLIN, 0 };
+        int ret_val = poll(&pfd, 1, remaining_ms);
+        notify_ring->waiting.store(0, std::memory_order_relaxed);
+
+        if (ret_val > 0) {
+            // Reset the eventfd counter; it may hold stale signals, so the ring is always checked again
+            uint64_t cnt;
+            if (read(notify_efd, &cnt, sizeof(cnt)) == -1 && errno != EAGAIN) {
+                throw std::runtime_error("ERROR: cThread::waitNotification() - eventfd read failed");
+            }
+        } else if (ret_val == 0) {
+            return pollNotification(value);
+        } else if (errno != EINTR) {
+            throw std::runtime_error("ERROR: cThread::waitNotification() - eventfd poll failed");
+        }
+
+        if (pollNotification(value)) {
+            return true;
+        }
+    }
+}
+
+uint32_t cThread::getDroppedNotifications() const {
+    return notify_ring ? notify_ring->dropped.load(std::memory_order_relaxed) : 0;
+}
+
 void cThread::doArpLookup(uint32_t ip_addr) {
     DBG3("cThread: Called doArpLookup for IP address " << ip_addr); 
 
@@ -1106,18 +2252,22 @@ void cThread::doArpLookup(uint32_t ip_addr) {
 }
 
 void cThread::writeQpContext(uint32_t port) {
-    DBG3("cThread: Called writeQpContext"); 
+    writeQpContext(*qpair, port);
+}
+
+void cThread::writeQpContext(const ibvQp &qp, uint32_t port) {
+    DBG3("cThread: Called writeQpContext for local QPN " << qp.local.qpn); 
 
     uint64_t offs[3];
     if (fcnfg.en_rdma) {
         // Derive register values from QP number, rkey, PSN and virtual address 
-        offs[0] = ((static_cast<uint64_t>(qpair->local.qpn) & 0xffffff) << QP_CONTEXT_QPN_OFFS) |
-                  ((static_cast<uint64_t>(qpair->remote.rkey) & 0xffffffff) << QP_CONTEXT_RKEY_OFFS);
+        offs[0] = ((static_cast<uint64_t>(qp.local.qpn) & 0xffffff) << QP_CONTEXT_QPN_OFFS) |
+                  ((static_cast<uint64_t>(qp.remote.rkey) & 0xffffffff) << QP_CONTEXT_RKEY_OFFS);
 
-        offs[1] = ((static_cast<uint64_t>(qpair->local.psn) & 0xffffff) << QP_CONTEXT_LPSN_OFFS) | 
-                  ((static_cast<uint64_t>(qpair->remote.psn) & 0xffffff) << QP_CONTEXT_RPSN_OFFS);
+        offs[1] = ((static_cast<uint64_t>(qp.local.psn) & 0xffffff) << QP_CONTEXT_LPSN_OFFS) | 
+                  ((static_cast<uint64_t>(qp.remote.psn) & 0xffffff) << QP_CONTEXT_RPSN_OFFS);
 
-        offs[2] = ((static_cast<uint64_t>((uint64_t) qpair->remote.vaddr) & 0xffffffffffff) << QP_CONTEXT_VADDR_OFFS);
+        offs[2] = ((static_cast<uint64_t>((uint64_t) qp.remote.vaddr) & 0xffffffffffff) << QP_CONTEXT_VADDR_OFFS);
 
     	
         // Write this information to the vFPGA configuration registers
@@ -1135,14 +2285,14 @@ void cThread::writeQpContext(uint32_t port) {
 
         // Write connection context - port (given as function argument), local and remote QPN, GID etc. to the config registers 
         offs[0] = ((static_cast<uint64_t>(port) & 0xffff) << CONN_CONTEXT_PORT_OFFS) | 
-                  ((static_cast<uint64_t>(qpair->remote.qpn) & 0xffffff) << CONN_CONTEXT_RQPN_OFFS) | 
-                  ((static_cast<uint64_t>(qpair->local.qpn) & 0xffff) << CONN_CONTEXT_LQPN_OFFS);
+                  ((static_cast<uint64_t>(qp.remote.qpn) & 0xffffff) << CONN_CONTEXT_RQPN_OFFS) | 
+                  ((static_cast<uint64_t>(qp.local.qpn) & 0xffff) << CONN_CONTEXT_LQPN_OFFS);
 
-        offs[1] = (htols(static_cast<uint64_t>(qpair->remote.gidToUint(8)) & 0xffffffff) << 32) |
-                  (htols(static_cast<uint64_t>(qpair->remote.gidToUint(0)) & 0xffffffff) << 0);
+        offs[1] = (htols(static_cast<uint64_t>(qp.remote.gidToUint(8)) & 0xffffffff) << 32) |
+                  (htols(static_cast<uint64_t>(qp.remote.gidToUint(0)) & 0xffffffff) << 0);
 
-        offs[2] = (htols(static_cast<uint64_t>(qpair->remote.gidToUint(24)) & 0xffffffff) << 32) | 
-                  (htols(static_cast<uint64_t>(qpair->remote.gidToUint(16)) & 0xffffffff) << 0);
+        offs[2] = (htols(static_cast<uint64_t>(qp.remote.gidToUint(24)) & 0xffffffff) << 32) | 
+                  (htols(static_cast<uint64_t>(qp.remote.gidToUint(16)) & 0xffffffff) << 0);
 
         #ifdef EN_AVX
         if (fcnfg.en_avx) {
@@ -1376,10 +2526,117 @@ void cThread::closeConn() {
     }
 }
 
+int32_t cThread::createQp(void *mem, uint64_t size) {
+    DBG1("cThread: Called createQp with buffer " << mem << " and size " << size);
+
+    if (!fcnfg.en_rdma) {
+        throw std::runtime_error("ERROR: cThread::createQp() called, but the shell was not synthesized with RDMA support, exiting...");
+    }
+
+    // By default, the buffer of the default QP is shared
+    if (mem == nullptr) {
+        if (qpair->local.vaddr == nullptr) {
+            throw std::runtime_error("ERROR: cThread::createQp() - no buffer provided and the default QP has none, exiting...");
+        }
+        mem = qpair->local.vaddr;
+        size = qpair->local.size;
+    }
+
+    // Obtain a Coyote thread ID for the QP; it is registered under the same hpid, so it uses the same TLB mappings
+    // Without a vFPGA, the IDs following the cThread's own are used; their counters are never advanced by hardware anyway
+    uint64_t tmp[MAX_USER_ARGS];
+    tmp[0] = hpid;
+    if (fd == -1) {
+        tmp[1] = (ctid + next_qp_id) % N_CTID_MAX;
+    } else if (ioctl(fd, IOCTL_REGISTER_CTID, &tmp)) {
+        throw std::runtime_error("ERROR: cThread::createQp() - IOCTL_REGISTER_CTID failed, no Coyote thread IDs left for the QP");
+    }
+
+    auto qpe = std::make_unique<qpEntry>();
+    qpe->ctid = tmp[1];
+
+    // Same node (IP address, GID) and rkey as the default QP; the QPN is obtained from the vfid and the QP's ctid
+    std::default_random_engine rand_gen(seed + qpe->ctid);
+    std::uniform_int_distribution<int> distr(0, std::numeric_limits<std::uint32_t>::max());
+
+    qpe->qpair.local = qpair->local;
+    qpe->qpair.local.qpn = ((vfid & N_REG_MASK) << PID_BITS) | (qpe->ctid & PID_MASK);
+    qpe->qpair.local.psn = distr(rand_gen) & 0xFFFFFF;
+    qpe->qpair.local.vaddr = mem;
+    qpe->qpair.local.size = size;
+
+    // The counters may still hold the values of a previous user of the ctid
+    clearCounters(qpe->ctid);
+
+    auto submission = lockSubmission();
+    int32_t qp_id = next_qp_id++;
+    DBG2("cThread: created QP " << qp_id << " with ctid " << qpe->ctid << ", QPN " << qpe->qpair.local.qpn << " and local PSN " << qpe->qpair.local.psn);
+    qp_table.emplace(qp_id, std::move(qpe));
+
+    return qp_id;
+}
+
+void cThread::connectQp(int32_t qp_id, const ibvQ &remote, uint16_t port) {
+    DBG1("cThread: Called connectQp for QP " << qp_id);
+
+    if (!fcnfg.en_rdma) {
+        throw std::runtime_error("ERROR: cThread::connectQp() called, but the shell was not synthesized with RDMA support, exiting...");
+    }
+
+    auto submission = lockSubmission();
+    qpEntry *qpe = findQp(qp_id);
+    ibvQp &qp = qpe ? qpe->qpair : *qpair;
+    qp.remote = remote;
+
+    writeQpContext(qp, port);
+    doArpLookup(qp.remote.ip_addr);
+}
+
+void cThread::destroyQp(int32_t qp_id) {
+    DBG1("cThread: Called destroyQp for QP " << qp_id);
+
+    std::unique_ptr<qpEntry> qpe;
+    {
+        auto submission = lockSubmission();
+        auto it = qp_table.find(qp_id);
+        if (it == qp_table.end()) {
+            throw std::runtime_error("ERROR: cThread::destroyQp() - queue pair " + std::to_string(qp_id) + " does not exist or can't be destroyed, exiting...");
+        }
+        qpe = std::move(it->second);
+        qp_table.erase(it);
+    }
+
+    // Wait for loopback copies, which may still access the buffers
+    for (uint32_t i = 0; i < N_WBACKS; i++) {
+        qpe->loopback_cmpl[i].drain();
+    }
+
+    uint64_t tmp[MAX_USER_ARGS];
+    tmp[0] = qpe->ctid;
+    if (fd != -1 && ioctl(fd, IOCTL_UNREGISTER_CTID, &tmp)) {
+        std::cerr << "WARNING: cThread::destroyQp() - IOCTL_UNREGISTER_CTID failed for ctid " << qpe->ctid << std::endl;
+    }
+}
+
+qpEntry* cThread::findQp(int32_t qp_id) const {
+    if (qp_id == 0) {
+        return nullptr;
+    }
+
+    auto it = qp_table.find(qp_id);
+    if (it == qp_table.end()) {
+        throw std::runtime_error("ERROR: cThread - queue pair " + std::to_string(qp_id) + " does not exist, exiting...");
+    }
+    return it->second.get();
+}
+
 void cThread::lock() {
     DBG3("cThread: Called lock");
     if (!lock_acquired) {
-        vlock.lock();
+        if (!vlock) {
+            vlock = std::make_unique<boost::interprocess::named_mutex>(boost::interprocess::open_or_create, vlock_name.c_str());
+        }
+        vlock->lock();
         lock_acquired = true;
     }
 }
@@ -1387,18 +2644,109 @@ void cThread::lock() {
 void cThread::unlock() {
     DBG3("cThread: Called unlock");
     if (lock_acquired) {
-        vlock.unlock();
+        vlock->unlock();
         lock_acquired = false;
     }
 }
 
+void cThread::reset() {
+    DBG1("cThread: Called reset, ctid: " << ctid);
+
+    // Wait for loopback copies, which may still access the buffers; their tickets are invalidated by clearCompleted() below
+    for (uint32_t i = 0; i < N_WBACKS; i++) {
+        loopback_cmpl[i].drain();
+    }
+
+    // Release the additional QPs, waiting for any loopback copies on them
+    while (!qp_table.empty()) {
+        destroyQp(qp_table.begin()->first);
+    }
+    next_qp_id = 1;
+
+    disableNotifyRing();
+
+    // Release recycled buffers and cached registrations before the explicitly mapped buffers, and restore the default settings
+    recycler.reset();
+    reg_cache.reset();
+    setMultiProducer(false);
+    validate_sg = false;
+
+    // Complete asynchronous mappings, so that their buffers are unmapped below; failed mappings are of no interest anymore
+    while (!pending_maps.empty()) {
+        try {
+            waitMap(mapHandle{ pending_maps.begin()->first });
+        } catch (const std::runtime_error&) {}
+    }
+
+    while (!mapped_pages.empty()) {
+        freeMem(mapped_pages.begin()->first);
+    }
+
+    while (!mapped_ranges.empty()) {
+        userUnmap(reinterpret_cast<void*>(mapped_ranges.begin()->first));
+    }
+
+    clearCompleted();
+    unlock();
+}
+
 int32_t cThread::getVfid() const { return vfid;};
 
 int32_t cThread::getCtid() const { return ctid; };
 
 pid_t  cThread::getHpid() const { return hpid; };
 
-ibvQp* cThread::getQpair() const { return qpair.get(); }
+ibvQp* cThread::getQpair(int32_t qp_id) const { 
+    qpEntry *qpe = findQp(qp_id);
+    return qpe ? &qpe->qpair : qpair.get(); 
+}
+
+int32_t cThread::getNumaNode() const { return numa_node; }
+
+startupStats cThread::getStartupStats() const { return startup_stats; }
+
+void cThread::invalidateShellCnfg() {
+    std::lock_guard<std::mutex> guard(shell_cnfg_lock);
+    shell_cnfg_cache.clear();
+}
+
+uint64_t cThread::getPageSize() const { return fcnfg.getPageSize(); }
+
+uint64_t cThread::getHugePageSize() const { return fcnfg.getHugePageSize(); }
+
+std::map<int32_t, uint64_t> cThread::getMemNodes(const void *vaddr, uint64_t len) const {
+    std::map<int32_t, uint64_t> nodes;
+    if (len == 0) {
+        return nodes;
+    }
+
+    uint64_t start = reinterpret_cast<uint64_t>(vaddr) & ~(PAGE_SIZE - 1);
+    uint64_t end = reinterpret_cast<uint64_t>(vaddr) + len;
+    
+    // Query the pages in batches; move_pages without target nodes only reports the current node of each page
+    constexpr uint64_t BATCH = 1024;
+    void *pages[BATCH];
+    int status[BATCH];
+
+    for (uint64_t addr = start; addr < end;) {
+        uint64_t n = 0;
+        for (; n < BATCH && addr + n * PAGE_SIZE < end; n++) {
+            pages[n] = reinterpret_cast<void*>(addr + n * PAGE_SIZE);
+        }
+
+        if (syscall(SYS_move_pages, 0, n, pages, NULL, status, 0)) {
+            int err = errno;
+            throw std::runtime_error("ERROR: cThread::getMemNodes() - move_pages failed: " + std::string(strerror(err)));
+        }
+
+        for (uint64_t i = 0; i < n; i++) {
+            nodes[status[i] >= 0 ? status[i] : -1] += PAGE_SIZE;
+        }
+        addr += n * PAGE_SIZE;
+    }
+
+    return nodes;
+}
 	
 void cThread::printDebug() const {
 	std::cout << "-- STATISTICS - ID: cThread ID" << ctid << ", vFPGA ID" << vfid << std::endl;
@@ -0,0 +1,127 @@
+/*
+ * This file is part of the Coyote <https://github.com/fpgasystems/Coyote>
+ *
+ * MIT Licence
+ * Copyright (c) 2025, Systems Group, ETH Zurich
+ * All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <iostream>
+
+#include <coyote/cThreadPool.hpp>
+
+namespace coyote {
+
+cThreadPool::cThreadPool(int32_t vfid, uint32_t n_threads, pid_t hpid, uint32_t device, std::function<void(int)> uisr) :
+    core(std::make_shared<poolCore>()) {
+    DBG1("cThreadPool: Creating pool of " << n_threads << " cThreads on vFPGA " << vfid);
+
+    core->vfid = vfid;
+    core->hpid = hpid;
+    core->device = device;
+    core->uisr = uisr;
+    core->capacity = n_threads;
+
+    core->idle.reserve(n_threads);
+    for (uint32_t i = 0; i < n_threads; i++) {
+        core->idle.emplace_back(std::make_unique<cThread>(vfid, hpid, device, uisr));
+    }
+
+    core->stats.n_created = n_threads;
+    core->stats.n_idle = n_threads;
+}
+
+cThreadPool::~cThreadPool() {
+    DBG1("cThreadPool: Releasing pool on vFPGA " << core->vfid);
+
+    // The cThreads still in use keep the core alive and are destroyed once returned
+    std::vector<std::unique_ptr<cThread>> idle;
+    {
+        std::lock_guard<std::mutex> guard(core->pool_lock);
+        core->closed = true;
+        idle.swap(core->idle);
+        core->stats.n_destroyed += idle.size();
+        core->stats.n_idle = 0;
+
+        if (core->stats.n_in_use) {
+            std::cerr << "WARNING: cThreadPool destroyed while " << core->stats.n_in_use << " cThreads are still in use" << std::endl;
+        }
+    }
+}
+
+cThreadPool::threadHandle cThreadPool::acquire() {
+    std::unique_ptr<cThread> thread;
+    {
+        std::lock_guard<std::mutex> guard(core->pool_lock);
+        if (!core->idle.empty()) {
+            thread = std::move(core->idle.back());
+            core->idle.pop_back();
+            core->stats.n_reused++;
+            core->stats.n_idle--;
+        }
+    }
+
+    // Constructed outside of the lock, since it's the slow path the pool is avoiding
+    if (!thread) {
+        thread = std::make_unique<cThread>(core->vfid, core->hpid, core->device, core->uisr);
+
+        std::lock_guard<std::mutex> guard(core->pool_lock);
+        core->stats.n_created++;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(core->pool_lock);
+        core->stats.n_acquired++;
+        core->stats.n_in_use++;
+    }
+
+    // The deleter holds a reference to the core, rather than to the pool, which may be destroyed first
+    std::shared_ptr<poolCore> owner = core;
+    return threadHandle(thread.release(), [owner](cThread *thread) { owner->release(thread); });
+}
+
+void cThreadPool::poolCore::release(cThread *thread) {
+    std::unique_ptr<cThread> owned(thread);
+
+    bool keep = true;
+    try {
+        owned->reset();
+    } catch (const std::exception &e) {
+        std::cerr << "WARNING: cThreadPool could not reset cThread " << owned->getCtid() << ": " << e.what() << std::endl;
+        keep = false;
+    }
+
+    std::lock_guard<std::mutex> guard(pool_lock);
+    stats.n_in_use--;
+    if (keep && !closed && idle.size() < capacity) {
+        idle.push_back(std::move(owned));
+        stats.n_idle++;
+    } else {
+        stats.n_destroyed++;
+    }
+}
+
+threadPoolStats cThreadPool::getStats() const {
+    std::lock_guard<std::mutex> guard(core->pool_lock);
+    return core->stats;
+}
+
+}